@@ -0,0 +1,595 @@
+//
+// An append-only sibling of VLVector for collecting values from several threads.
+// push_back reserves an index with a single atomic increment and never moves existing values:
+// the first StaticCapacity values live inline, and every later segment doubles the capacity
+// without reallocating, so references handed to readers stay valid until the vector is destroyed.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLCONCURRENTVECTOR_HPP
+#define CPP_FINAL_PROJECT_VLCONCURRENTVECTOR_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "VLVector.hpp"
+
+#define VLCONCURRENT_MAX_SEGMENTS 64
+
+/**
+ * @brief Represents a Virtual Length Vector that many threads may append to concurrently.
+ * Segment 0 is the inline storage of StaticCapacity values, and segment k >= 1 holds
+ * StaticCapacity * 2^(k-1) values on the heap, allocated by the first thread that needs it.
+ * Values are read through snapshots, which contain a prefix of the appended values that are
+ * fully constructed.
+ * @tparam T the type of the values.
+ * @tparam StaticCapacity the amount of values stored without allocating, must be a power of 2.
+ */
+template<typename T, size_t StaticCapacity = DEF_STATIC_CAPACITY>
+class VLConcurrentVector
+{
+private:
+    static_assert(StaticCapacity > 0 && (StaticCapacity & (StaticCapacity - 1)) == 0,
+                  "VLConcurrentVector static capacity must be a power of 2");
+    static_assert(std::is_nothrow_move_constructible<T>::value,
+                  "VLConcurrentVector values must be nothrow move constructible");
+
+    /**
+     * @brief Storage for a single value, and a flag that is set once the value is constructed.
+     */
+    struct _Slot
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type value;
+        std::atomic<bool> ready;
+    };
+
+#if !__cpp_aligned_new
+    static_assert(alignof(_Slot) <= alignof(std::max_align_t),
+                  "VLConcurrentVector needs aligned new (C++17) for over-aligned values");
+#endif
+
+    /********************************************************************
+    *                             Class members                         *
+    ********************************************************************/
+
+    // The amount of indices handed out, some of which may still be under construction:
+    std::atomic<size_t> _reserved;
+    // A prefix of the indices whose values are known to be constructed:
+    mutable std::atomic<size_t> _published;
+    std::atomic<_Slot *> _segments[VLCONCURRENT_MAX_SEGMENTS];
+    _Slot _inline[StaticCapacity];
+
+    /**
+     * @brief Returns the segment of an index and the offset of the index in the segment.
+     * @param index the index of a value.
+     * @param offset set to the offset of the index in its segment.
+     * @return the segment of the index.
+     */
+    static size_t _locate(size_t index, size_t &offset) noexcept
+    {
+        if (index < StaticCapacity)
+        {
+            offset = index;
+            return 0;
+        }
+        const size_t segment = sizeof(unsigned long long) * CHAR_BIT -
+                               __builtin_clzll(index / StaticCapacity);
+        offset = index - _segmentCapacity(segment);
+        return segment;
+    }
+
+    /**
+     * @brief Returns the capacity of a segment.
+     * @param segment the index of the segment.
+     * @return the amount of values the segment holds.
+     */
+    static size_t _segmentCapacity(size_t segment) noexcept
+    {
+        return segment == 0 ? StaticCapacity : StaticCapacity << (segment - 1);
+    }
+
+    /**
+     * @brief Allocates uninitialised slots, aligned for the values they hold.
+     * @param capacity the amount of slots.
+     * @return the slots.
+     */
+    static _Slot *_allocateSlots(size_t capacity)
+    {
+#if __cpp_aligned_new
+        return static_cast<_Slot *>(::operator new(capacity * sizeof(_Slot), std::align_val_t(alignof(_Slot))));
+#else
+        return static_cast<_Slot *>(::operator new(capacity * sizeof(_Slot)));
+#endif
+    }
+
+    /**
+     * @brief Releases slots that were allocated by _allocateSlots.
+     * @param slots the slots to release.
+     */
+    static void _deallocateSlots(_Slot *slots) noexcept
+    {
+#if __cpp_aligned_new
+        ::operator delete(slots, std::align_val_t(alignof(_Slot)));
+#else
+        ::operator delete(slots);
+#endif
+    }
+
+    /**
+     * @brief Returns a segment, allocating it if no thread did yet.
+     * When threads race to allocate the same segment, one allocation wins and the others are freed.
+     * @param segment the index of the segment.
+     * @return the slots of the segment.
+     */
+    _Slot *_segment(size_t segment)
+    {
+        _Slot *slots = _segments[segment].load(std::memory_order_acquire);
+        if (slots != nullptr)
+        {
+            return slots;
+        }
+        const size_t capacity = _segmentCapacity(segment);
+        _Slot *allocated = _allocateSlots(capacity);
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            ::new(static_cast<void *>(&allocated[i].ready)) std::atomic<bool>(false);
+        }
+        if (_segments[segment].compare_exchange_strong(slots, allocated, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire))
+        {
+            return allocated;
+        }
+        _deallocateSlots(allocated);
+        return slots;
+    }
+
+    /**
+     * @brief Returns the slot of an index, allocating its segment if needed.
+     * @param index the index of a value.
+     * @return the slot of the index.
+     */
+    _Slot &_slot(size_t index)
+    {
+        size_t offset;
+        const size_t segment = _locate(index, offset);
+        return _segment(segment)[offset];
+    }
+
+    /**
+     * @brief Checks whether the value at an index is constructed.
+     * @param index the index of a value.
+     * @return true iff the value at the index may be read.
+     */
+    bool _isReady(size_t index) const noexcept
+    {
+        size_t offset;
+        const size_t segment = _locate(index, offset);
+        const _Slot *slots = _segments[segment].load(std::memory_order_acquire);
+        return slots != nullptr && slots[offset].ready.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the value at an index that is known to be constructed.
+     * @param index the index of a value.
+     * @return a reference to the value.
+     */
+    const T &_value(size_t index) const noexcept
+    {
+        size_t offset;
+        const size_t segment = _locate(index, offset);
+        const _Slot *slots = _segments[segment].load(std::memory_order_acquire);
+        return *reinterpret_cast<const T *>(&slots[offset].value);
+    }
+
+    /**
+     * @brief Reserves the next index, once the segment of that index exists.
+     * The segment is allocated before the index is reserved, so if the allocation throws no
+     * index is left without a value, which would hide every later value from the snapshots.
+     * @return the reserved index.
+     */
+    size_t _reserve()
+    {
+        size_t index = _reserved.load(std::memory_order_relaxed);
+        do
+        {
+            size_t offset;
+            _segment(_locate(index, offset));
+        } while (!_reserved.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+        return index;
+    }
+
+    /**
+     * @brief Reserves an index and constructs a value there directly, since the constructor
+     * cannot throw.
+     */
+    template<typename... Args>
+    T &_append(std::true_type, Args &&... args)
+    {
+        _Slot &slot = _slot(_reserve());
+        T *value = ::new(static_cast<void *>(&slot.value)) T(std::forward<Args>(args)...);
+        slot.ready.store(true, std::memory_order_release);
+        return *value;
+    }
+
+    /**
+     * @brief Constructs a value before reserving an index for it, so a throwing constructor
+     * never leaves a reserved index without a value.
+     */
+    template<typename... Args>
+    T &_append(std::false_type, Args &&... args)
+    {
+        T temp(std::forward<Args>(args)...);
+        return _append(std::true_type(), std::move(temp));
+    }
+
+public:
+    /**
+     * @brief A consistent view of the values that were appended before it was taken.
+     * The view stays valid as long as the vector, even while other threads keep appending.
+     */
+    class Snapshot
+    {
+    private:
+        const VLConcurrentVector *_vec;
+        size_t _size;
+
+    public:
+        /**
+         * @brief A random access iterator over the values of a snapshot.
+         */
+        class ConstIterator
+        {
+        private:
+            const VLConcurrentVector *_vec;
+            size_t _index;
+
+        public:
+            /**
+             * @brief Iterator traits.
+             */
+            typedef T value_type;
+            typedef const T &reference;
+            typedef const T *pointer;
+            typedef std::ptrdiff_t difference_type;
+            typedef std::random_access_iterator_tag iterator_category;
+
+            ConstIterator() : _vec(nullptr), _index(0)
+            {
+            }
+
+            ConstIterator(const VLConcurrentVector *vec, size_t index) : _vec(vec), _index(index)
+            {
+            }
+
+            reference operator*() const
+            {
+                return _vec->_value(_index);
+            }
+
+            pointer operator->() const
+            {
+                return &_vec->_value(_index);
+            }
+
+            reference operator[](difference_type n) const
+            {
+                return _vec->_value(_index + n);
+            }
+
+            ConstIterator &operator++()
+            {
+                ++_index;
+                return *this;
+            }
+
+            ConstIterator operator++(int)
+            {
+                ConstIterator temp = *this;
+                ++_index;
+                return temp;
+            }
+
+            ConstIterator &operator--()
+            {
+                --_index;
+                return *this;
+            }
+
+            ConstIterator operator--(int)
+            {
+                ConstIterator temp = *this;
+                --_index;
+                return temp;
+            }
+
+            ConstIterator &operator+=(difference_type n)
+            {
+                _index += n;
+                return *this;
+            }
+
+            ConstIterator &operator-=(difference_type n)
+            {
+                _index -= n;
+                return *this;
+            }
+
+            ConstIterator operator+(difference_type n) const
+            {
+                return ConstIterator(_vec, _index + n);
+            }
+
+            friend ConstIterator operator+(difference_type n, const ConstIterator &it)
+            {
+                return it + n;
+            }
+
+            ConstIterator operator-(difference_type n) const
+            {
+                return ConstIterator(_vec, _index - n);
+            }
+
+            difference_type operator-(const ConstIterator &other) const
+            {
+                return (difference_type) _index - (difference_type) other._index;
+            }
+
+            bool operator==(const ConstIterator &other) const
+            {
+                return _index == other._index;
+            }
+
+            bool operator!=(const ConstIterator &other) const
+            {
+                return _index != other._index;
+            }
+
+            bool operator<(const ConstIterator &other) const
+            {
+                return _index < other._index;
+            }
+
+            bool operator>(const ConstIterator &other) const
+            {
+                return _index > other._index;
+            }
+
+            bool operator<=(const ConstIterator &other) const
+            {
+                return _index <= other._index;
+            }
+
+            bool operator>=(const ConstIterator &other) const
+            {
+                return _index >= other._index;
+            }
+        };
+
+        typedef ConstIterator const_iterator;
+        typedef ConstIterator iterator;
+
+        /**
+         * @brief Constructs a snapshot of a prefix of a vector.
+         * @param vec the vector.
+         * @param size the length of the prefix, whose values must all be constructed.
+         */
+        Snapshot(const VLConcurrentVector *vec, size_t size) noexcept : _vec(vec), _size(size)
+        {
+        }
+
+        /**
+         * @brief Returns the number of values in the snapshot.
+         * @return the number of values.
+         */
+        size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        /**
+         * @brief Checks if the snapshot is empty.
+         * @return true iff the snapshot has no values.
+         */
+        bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        /**
+         * @brief Returns the value at a given index.
+         * @param index the index of the value.
+         * @return a reference to the value.
+         */
+        const T &operator[](size_t index) const noexcept
+        {
+            return _vec->_value(index);
+        }
+
+        /**
+         * @brief Returns the value at a given index.
+         * Throws an exception if the index was not found.
+         * @param index the index of the value.
+         * @return a reference to the value.
+         */
+        const T &at(size_t index) const
+        {
+            if (index >= _size)
+            {
+                throw std::out_of_range(AT_EXCEPTION_MSG);
+            }
+            return _vec->_value(index);
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return const_iterator(_vec, 0);
+        }
+
+        const_iterator end() const noexcept
+        {
+            return const_iterator(_vec, _size);
+        }
+
+        const_iterator cbegin() const noexcept
+        {
+            return begin();
+        }
+
+        const_iterator cend() const noexcept
+        {
+            return end();
+        }
+    };
+
+    /********************************************************************
+    *                       Rule of 5 methods                           *
+    ********************************************************************/
+
+    /**
+     * @brief Default constructor. Initialises an empty vector.
+     */
+    VLConcurrentVector() noexcept : _reserved(0), _published(0)
+    {
+        _segments[0].store(_inline, std::memory_order_relaxed);
+        for (size_t i = 1; i < VLCONCURRENT_MAX_SEGMENTS; ++i)
+        {
+            _segments[i].store(nullptr, std::memory_order_relaxed);
+        }
+        for (_Slot &slot : _inline)
+        {
+            slot.ready.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief The vector is shared between threads by reference, so it is neither copied nor moved.
+     */
+    VLConcurrentVector(const VLConcurrentVector &) = delete;
+
+    VLConcurrentVector &operator=(const VLConcurrentVector &) = delete;
+
+    /**
+     * @brief Destructor. Must not run concurrently with any other method.
+     */
+    ~VLConcurrentVector()
+    {
+        const size_t reserved = _reserved.load(std::memory_order_acquire);
+        for (size_t index = 0; index < reserved; ++index)
+        {
+            if (_isReady(index))
+            {
+                const_cast<T &>(_value(index)).~T();
+            }
+        }
+        for (size_t i = 1; i < VLCONCURRENT_MAX_SEGMENTS; ++i)
+        {
+            _deallocateSlots(_segments[i].load(std::memory_order_relaxed));
+        }
+    }
+
+    /********************************************************************
+    *                            API methods                            *
+    ********************************************************************/
+
+    /**
+     * @brief Returns the maximal amount of values the vector can hold.
+     * @return the maximal amount of values.
+     */
+    size_t max_size() const noexcept
+    {
+        return std::numeric_limits<size_t>::max() / sizeof(_Slot);
+    }
+
+    /**
+     * @brief Appends a value constructed in place. Safe to call from many threads at once.
+     * If allocating a new segment throws, the exception propagates and no index is reserved,
+     * since the segment is allocated before the index is.
+     * @tparam Args the types of the arguments.
+     * @param args the arguments to construct the value from.
+     * @return a reference to the new value, which stays valid as long as the vector.
+     */
+    template<typename... Args>
+    T &emplace_back(Args &&... args)
+    {
+        return _append(std::is_nothrow_constructible<T, Args &&...>(), std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Appends a value. Safe to call from many threads at once.
+     * @param value the value to append.
+     * @return a reference to the new value, which stays valid as long as the vector.
+     */
+    T &push_back(const T &value)
+    {
+        return emplace_back(value);
+    }
+
+    /**
+     * @brief Appends a value. Safe to call from many threads at once.
+     * @param value the value to append.
+     * @return a reference to the new value, which stays valid as long as the vector.
+     */
+    T &push_back(T &&value)
+    {
+        return emplace_back(std::move(value));
+    }
+
+    /**
+     * @brief Allocates the segments needed for a given amount of values, so appends up to that
+     * amount never allocate. Safe to call from many threads at once.
+     * @param capacity the amount of values the vector should be able to hold.
+     */
+    void reserve(size_t capacity)
+    {
+        if (capacity <= StaticCapacity)
+        {
+            return;
+        }
+        size_t offset;
+        const size_t last = _locate(capacity - 1, offset);
+        for (size_t segment = 1; segment <= last; ++segment)
+        {
+            _segment(segment);
+        }
+    }
+
+    /**
+     * @brief Returns the amount of values appended so far, including values that other threads
+     * are still constructing.
+     * @return the amount of appended values.
+     */
+    size_t size() const noexcept
+    {
+        return _reserved.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Takes a snapshot of the longest prefix of constructed values.
+     * Values that were appended before the call started are in the snapshot, unless another
+     * thread is still constructing a value at a smaller index.
+     * @return the snapshot.
+     */
+    Snapshot snapshot() const noexcept
+    {
+        const size_t reserved = _reserved.load(std::memory_order_acquire);
+        size_t published = _published.load(std::memory_order_acquire);
+        size_t ready = published;
+        while (ready < reserved && _isReady(ready))
+        {
+            ++ready;
+        }
+        while (published < ready &&
+               !_published.compare_exchange_weak(published, ready, std::memory_order_release,
+                                                 std::memory_order_acquire))
+        {
+        }
+        return Snapshot(this, ready > published ? ready : published);
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLCONCURRENTVECTOR_HPP
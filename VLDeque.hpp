@@ -0,0 +1,1226 @@
+//
+// A double ended queue with the storage scheme of VLVector: up to StaticCapacity elements live
+// in an inline ring buffer, and larger deques spill to a ring buffer on the heap. Elements are
+// added and removed at both ends in constant time, without shifting the other elements.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLDEQUE_HPP
+#define CPP_FINAL_PROJECT_VLDEQUE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "VLVector.hpp"
+
+/**
+ * @brief Represents a double ended queue that stores up to StaticCapacity elements inline.
+ * The elements are kept in a ring buffer: the front element is at some slot of the ring, and
+ * the elements after it follow it, wrapping around to the first slot at the end of the ring.
+ * When the ring is full, the elements are relocated to a larger ring on the heap, unwrapped so
+ * that the front element is at the first slot.
+ * @tparam T the type of values stored in the deque.
+ * @tparam StaticCapacity the amount of elements stored without allocating.
+ * @tparam GrowthPolicy decides how the heap capacity grows and when to return to the stack.
+ * @tparam Allocator the allocator used for the heap storage and for constructing elements.
+ */
+template<typename T, size_t StaticCapacity = DEF_STATIC_CAPACITY,
+        typename GrowthPolicy = VLDefaultGrowthPolicy, typename Allocator = std::allocator<T>>
+class VLDeque
+{
+private:
+    static_assert(StaticCapacity > 0, "VLDeque static capacity must be positive");
+
+    typedef std::allocator_traits<Allocator> _AllocTraits;
+
+#if __cplusplus >= 201703L
+    typedef typename _AllocTraits::is_always_equal _AllocAlwaysEqual;
+#else
+    typedef std::is_empty<Allocator> _AllocAlwaysEqual;
+#endif
+
+    /********************************************************************
+    *                             Class members                         *
+    ********************************************************************/
+
+    /**
+     * @brief The ring storage. The inline ring and the heap pointer share the same bytes,
+     * since only one of them is in use at a time. An empty allocator takes no space.
+     */
+    struct _Storage : VLAllocatorHolder<Allocator>
+    {
+        union
+        {
+            // Raw storage for the inline ring - slots are only constructed while they are in use:
+            alignas(T) unsigned char stackRing[sizeof(T) * StaticCapacity];
+            T *heapRing;
+        };
+
+        /**
+         * @brief Constructs the storage, with no heap ring.
+         * @param alloc the allocator of the deque.
+         */
+        explicit _Storage(const Allocator &alloc) : VLAllocatorHolder<Allocator>(alloc), heapRing(nullptr)
+        {
+        }
+    };
+
+    // The deque is in stack mode iff its capacity equals the static capacity -
+    // a heap capacity is always greater than the static capacity:
+    std::size_t _head;
+    std::size_t _size;
+    std::size_t _capacity;
+    _Storage _storage;
+
+    /**
+     * @brief Returns the allocator of the deque.
+     * @return the allocator of the deque.
+     */
+    Allocator &_getAllocator() noexcept
+    {
+        return _storage.getAllocator();
+    }
+
+    /**
+     * @brief Returns the allocator of the deque.
+     * @return the allocator of the deque.
+     */
+    const Allocator &_getAllocator() const noexcept
+    {
+        return _storage.getAllocator();
+    }
+
+    /**
+     * @brief Checks if the elements are stored in the inline ring.
+     * @return true iff the deque is in stack mode.
+     */
+    bool _isStackMode() const noexcept
+    {
+        return _capacity == StaticCapacity;
+    }
+
+    /**
+     * @brief Returns the inline ring.
+     * @return a pointer to the first slot of the inline ring.
+     */
+    T *_stackData() noexcept
+    {
+        return reinterpret_cast<T *>(_storage.stackRing);
+    }
+
+    /**
+     * @brief Returns the ring that holds the elements.
+     * @return a pointer to the first slot of the ring.
+     */
+    T *_ring() noexcept
+    {
+        return _isStackMode() ? _stackData() : _storage.heapRing;
+    }
+
+    /**
+     * @brief Returns the ring that holds the elements.
+     * @return a pointer to the first slot of the ring.
+     */
+    const T *_ring() const noexcept
+    {
+        return _isStackMode() ? reinterpret_cast<const T *>(_storage.stackRing) : _storage.heapRing;
+    }
+
+    /**
+     * @brief Returns the slot of the ring that holds the element at a given index.
+     * @param index the index of the element, which must be less than the capacity.
+     * @return the slot of the element.
+     */
+    std::size_t _slot(std::size_t index) const noexcept
+    {
+        const std::size_t slot = _head + index;
+        return slot < _capacity ? slot : slot - _capacity;
+    }
+
+    /**
+     * @brief Allocates an uninitialised heap ring for a given amount of elements.
+     * @param count the amount of elements the ring should fit.
+     * @return a pointer to the allocated ring.
+     */
+    T *_allocate(std::size_t count)
+    {
+        if (count > max_size())
+        {
+            throw std::length_error(LENGTH_EXCEPTION_MSG);
+        }
+        return _AllocTraits::allocate(_getAllocator(), count);
+    }
+
+    /**
+     * @brief Releases a heap ring that was allocated by _allocate.
+     * @param ring the ring to release.
+     * @param count the amount of elements the ring was allocated for.
+     */
+    void _deallocate(T *ring, std::size_t count) noexcept
+    {
+        _AllocTraits::deallocate(_getAllocator(), ring, count);
+    }
+
+    /**
+     * @brief Constructs an element in an uninitialised slot with the allocator.
+     * @param slot the slot.
+     * @param args the arguments to pass to the constructor of T.
+     */
+    template<typename... Args>
+    void _construct(T *slot, Args &&... args)
+    {
+        _AllocTraits::construct(_getAllocator(), slot, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Destroys the element in a slot with the allocator, leaving the slot uninitialised.
+     * @param slot the slot.
+     */
+    void _destroy(T *slot) noexcept
+    {
+        _AllocTraits::destroy(_getAllocator(), slot);
+    }
+
+    /**
+     * @brief Relocates the elements into new uninitialised storage, unwrapped so that the front
+     * element is at the first slot. If a constructor throws, the deque is left intact.
+     * The head, size and capacity are left for the caller to update.
+     * @param ring the ring that holds the elements.
+     * @param dest pointer to the new storage.
+     */
+    void _relocateRing(T *ring, T *dest)
+    {
+        _relocateRing(ring, dest, VLTriviallyRelocatable<T>());
+    }
+
+    /**
+     * @brief Relocates trivially relocatable elements with at most two memcpy calls, one for
+     * each side of the wrap.
+     */
+    void _relocateRing(T *ring, T *dest, std::true_type) noexcept
+    {
+        const std::size_t beforeWrap = std::min(_size, _capacity - _head);
+        if (beforeWrap != 0)
+        {
+            std::memcpy(static_cast<void *>(dest), static_cast<const void *>(ring + _head),
+                        beforeWrap * sizeof(T));
+        }
+        if (_size != beforeWrap)
+        {
+            std::memcpy(static_cast<void *>(dest + beforeWrap), static_cast<const void *>(ring),
+                        (_size - beforeWrap) * sizeof(T));
+        }
+    }
+
+    /**
+     * @brief Relocates elements one by one using move_if_noexcept. The old elements are only
+     * destroyed once all of them are in the new storage.
+     */
+    void _relocateRing(T *ring, T *dest, std::false_type)
+    {
+        std::size_t index = 0;
+        try
+        {
+            for (; index < _size; ++index)
+            {
+                _construct(dest + index, std::move_if_noexcept(ring[_slot(index)]));
+            }
+        }
+        catch (...)
+        {
+            while (index > 0)
+            {
+                _destroy(dest + --index);
+            }
+            throw;
+        }
+        for (index = 0; index < _size; ++index)
+        {
+            _destroy(ring + _slot(index));
+        }
+    }
+
+    /**
+     * @brief Changes the capacity of the deque, moving it between the stack and the heap if
+     * needed. A capacity that fits in the static capacity moves the deque to the stack.
+     * The elements are unwrapped whenever they move.
+     * @param newCapacity the new capacity of the deque, which must fit all its elements.
+     */
+    void _setCapacity(std::size_t newCapacity)
+    {
+        if (newCapacity <= StaticCapacity)
+        {
+            if (_isStackMode())
+            {
+                return;
+            }
+            // The inline elements overwrite the heap pointer, so it is kept aside:
+            T *heap = _storage.heapRing;
+            try
+            {
+                _relocateRing(heap, _stackData());
+            }
+            catch (...)
+            {
+                _storage.heapRing = heap;
+                throw;
+            }
+            _deallocate(heap, _capacity);
+            _capacity = StaticCapacity;
+        }
+        else
+        {
+            if (newCapacity == _capacity)
+            {
+                return;
+            }
+            T *newRing = _allocate(newCapacity);
+            try
+            {
+                _relocateRing(_ring(), newRing);
+            }
+            catch (...)
+            {
+                _deallocate(newRing, newCapacity);
+                throw;
+            }
+            if (!_isStackMode())
+            {
+                _deallocate(_storage.heapRing, _capacity);
+            }
+            _storage.heapRing = newRing;
+            _capacity = newCapacity;
+        }
+        _head = 0;
+    }
+
+    /**
+     * @brief Makes room for one more element, moving the deque to the heap or increasing its
+     * heap capacity if needed.
+     */
+    void _growIfFull()
+    {
+        if (_size == _capacity)
+        {
+            _setCapacity(GrowthPolicy::grow(_size + 1));
+        }
+    }
+
+    /**
+     * @brief Moves the deque back to the stack if following a removal the growth policy
+     * decides it should return there.
+     */
+    void _shrinkIfNeeded()
+    {
+        if (!_isStackMode() && GrowthPolicy::shouldReturnToStack(_size, StaticCapacity))
+        {
+            _setCapacity(StaticCapacity);
+        }
+    }
+
+    /**
+     * @brief Takes the elements of another deque, which is left empty on the stack.
+     * The heap ring of other is taken as is if the allocators are equal, otherwise the elements
+     * are relocated. This deque must be empty and in stack mode.
+     * @param other the deque to take the elements from.
+     */
+    void _takeFrom(VLDeque &other)
+    {
+        if (!other._isStackMode() && _getAllocator() == other._getAllocator())
+        {
+            _storage.heapRing = other._storage.heapRing;
+            _capacity = other._capacity;
+            _head = other._head;
+        }
+        else
+        {
+            _setCapacity(other._size);
+            other._relocateRing(other._ring(), _ring());
+            if (!other._isStackMode())
+            {
+                other._deallocate(other._storage.heapRing, other._capacity);
+            }
+        }
+        _size = other._size;
+        other._head = 0;
+        other._size = 0;
+        other._capacity = StaticCapacity;
+    }
+
+    /**
+     * @brief Destroys the elements and releases the heap ring, leaving the deque empty on the stack.
+     */
+    void _release() noexcept
+    {
+        clear();
+        if (!_isStackMode())
+        {
+            _deallocate(_storage.heapRing, _capacity);
+            _capacity = StaticCapacity;
+        }
+    }
+
+    /**
+     * @brief Replaces the allocator of this deque with the allocator of another deque.
+     * Used when the allocator propagates, this deque must be empty and in stack mode.
+     * @param other the deque to take the allocator from.
+     */
+    void _adoptAllocator(const VLDeque &other, std::true_type)
+    {
+        _getAllocator() = other._getAllocator();
+    }
+
+    /**
+     * @brief Keeps the allocator of this deque when the allocator does not propagate.
+     */
+    void _adoptAllocator(const VLDeque &, std::false_type)
+    {
+    }
+
+    /********************************************************************
+    *                             Iterators                             *
+    ********************************************************************/
+
+    /**
+     * @brief A random access iterator over the elements of the deque, which holds an index
+     * rather than a pointer since the elements wrap around the end of the ring.
+     * @tparam Const true iff the iterator gives read only access.
+     */
+    template<bool Const>
+    class VLDequeIterator
+    {
+    private:
+        typedef typename std::conditional<Const, const VLDeque, VLDeque>::type _Owner;
+
+        template<bool> friend class VLDequeIterator;
+
+        _Owner *_deque;
+        std::size_t _index;
+
+    public:
+        /**
+         * @brief Iterator traits.
+         */
+        typedef T value_type;
+        typedef typename std::conditional<Const, const T &, T &>::type reference;
+        typedef typename std::conditional<Const, const T *, T *>::type pointer;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::random_access_iterator_tag iterator_category;
+
+        /**
+         * @brief Constructs a singular iterator that does not point into any deque.
+         */
+        VLDequeIterator() : _deque(nullptr), _index(0)
+        {
+        }
+
+        /**
+         * @brief Constructs an iterator to a given element.
+         * @param deque the deque to iterate over.
+         * @param index the index of the element.
+         */
+        VLDequeIterator(_Owner *deque, std::size_t index) : _deque(deque), _index(index)
+        {
+        }
+
+        /**
+         * @brief Converts a non-const iterator to a const iterator.
+         * @param other the iterator to convert.
+         */
+        template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+        VLDequeIterator(const VLDequeIterator<OtherConst> &other)
+                : _deque(other._deque), _index(other._index)
+        {
+        }
+
+        /**
+         * @brief Returns the element the iterator points at.
+         * @return a reference to the element.
+         */
+        reference operator*() const
+        {
+            return (*_deque)[_index];
+        }
+
+        /**
+         * @brief Returns a pointer to the element the iterator points at.
+         * @return a pointer to the element.
+         */
+        pointer operator->() const
+        {
+            return &(*_deque)[_index];
+        }
+
+        /**
+         * @brief Returns the element at a given distance from the element the iterator points at.
+         * @param n the distance of the element.
+         * @return a reference to the element.
+         */
+        reference operator[](difference_type n) const
+        {
+            return (*_deque)[_index + n];
+        }
+
+        /**
+         * @brief Increments the iterator so that it points to the next element in the deque.
+         * @return the iterator after it was incremented.
+         */
+        VLDequeIterator &operator++()
+        {
+            ++_index;
+            return *this;
+        }
+
+        /**
+         * @brief Increments the iterator so that it points to the next element in the deque.
+         * @return the iterator before it was incremented.
+         */
+        VLDequeIterator operator++(int)
+        {
+            VLDequeIterator temp = *this;
+            ++_index;
+            return temp;
+        }
+
+        /**
+         * @brief Decrements the iterator so that it points to the previous element in the deque.
+         * @return the iterator after it was decremented.
+         */
+        VLDequeIterator &operator--()
+        {
+            --_index;
+            return *this;
+        }
+
+        /**
+         * @brief Decrements the iterator so that it points to the previous element in the deque.
+         * @return the iterator before it was decremented.
+         */
+        VLDequeIterator operator--(int)
+        {
+            VLDequeIterator temp = *this;
+            --_index;
+            return temp;
+        }
+
+        /**
+         * @brief Moves the iterator a given amount of elements forward.
+         * @param n the amount of elements.
+         * @return this iterator after the addition.
+         */
+        VLDequeIterator &operator+=(difference_type n)
+        {
+            _index += n;
+            return *this;
+        }
+
+        /**
+         * @brief Moves the iterator a given amount of elements backward.
+         * @param n the amount of elements.
+         * @return this iterator after the subtraction.
+         */
+        VLDequeIterator &operator-=(difference_type n)
+        {
+            _index -= n;
+            return *this;
+        }
+
+        /**
+         * @brief Returns an iterator to the element a given amount of elements after this
+         * iterator.
+         * @param n the amount of elements.
+         * @return the result of the addition.
+         */
+        VLDequeIterator operator+(difference_type n) const
+        {
+            return VLDequeIterator(_deque, _index + n);
+        }
+
+        /**
+         * @brief Returns an iterator to the element a given amount of elements after an iterator.
+         * @param n the amount of elements.
+         * @param it the iterator.
+         * @return the result of the addition.
+         */
+        friend VLDequeIterator operator+(difference_type n, const VLDequeIterator &it)
+        {
+            return it + n;
+        }
+
+        /**
+         * @brief Returns an iterator to the element a given amount of elements before this
+         * iterator.
+         * @param n the amount of elements.
+         * @return the result of the subtraction.
+         */
+        VLDequeIterator operator-(difference_type n) const
+        {
+            return VLDequeIterator(_deque, _index - n);
+        }
+
+        /**
+         * @brief Returns the distance between two iterators. Either may be const, as a non-const
+         * iterator converts to a const iterator.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return the amount of elements from rhs to lhs.
+         */
+        friend difference_type operator-(const VLDequeIterator &lhs, const VLDequeIterator &rhs)
+        {
+            return (difference_type) lhs._index - (difference_type) rhs._index;
+        }
+
+        /**
+         * @brief Checks if two iterators point to the same position. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff both iterators point to the same position.
+         */
+        friend bool operator==(const VLDequeIterator &lhs, const VLDequeIterator &rhs)
+        {
+            return lhs._index == rhs._index;
+        }
+
+        /**
+         * @brief Checks if two iterators don't point to the same position. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff the iterators don't point to the same position.
+         */
+        friend bool operator!=(const VLDequeIterator &lhs, const VLDequeIterator &rhs)
+        {
+            return lhs._index != rhs._index;
+        }
+
+        /**
+         * @brief Checks if an iterator points to a position before the position of another
+         * iterator. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff lhs points to an earlier position.
+         */
+        friend bool operator<(const VLDequeIterator &lhs, const VLDequeIterator &rhs)
+        {
+            return lhs._index < rhs._index;
+        }
+
+        /**
+         * @brief Checks if an iterator points to a position after the position of another
+         * iterator. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff lhs points to a later position.
+         */
+        friend bool operator>(const VLDequeIterator &lhs, const VLDequeIterator &rhs)
+        {
+            return lhs._index > rhs._index;
+        }
+
+        /**
+         * @brief Checks if an iterator points to a position before the position of another
+         * iterator, or to the same position. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff lhs does not point to a later position.
+         */
+        friend bool operator<=(const VLDequeIterator &lhs, const VLDequeIterator &rhs)
+        {
+            return lhs._index <= rhs._index;
+        }
+
+        /**
+         * @brief Checks if an iterator points to a position after the position of another
+         * iterator, or to the same position. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff lhs does not point to an earlier position.
+         */
+        friend bool operator>=(const VLDequeIterator &lhs, const VLDequeIterator &rhs)
+        {
+            return lhs._index >= rhs._index;
+        }
+    };
+
+public:
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef Allocator allocator_type;
+    typedef VLDequeIterator<false> iterator;
+    typedef VLDequeIterator<true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /********************************************************************
+    *                       Rule of 5 methods                           *
+    ********************************************************************/
+
+    /**
+     * @brief Default constructor. Initialises an empty deque.
+     */
+    VLDeque() : VLDeque(Allocator())
+    {
+    }
+
+    /**
+     * @brief Constructs an empty deque that uses a given allocator for its heap storage.
+     * @param alloc the allocator to use.
+     */
+    explicit VLDeque(const Allocator &alloc)
+            : _head(0), _size(0), _capacity(StaticCapacity), _storage(alloc)
+    {
+    }
+
+    /**
+     * @brief Constructs a deque of the values in a given range.
+     * @param first an iterator to the first value.
+     * @param last an iterator past the last value.
+     * @param alloc the allocator to use.
+     */
+    template<typename InputIterator, typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIterator>::iterator_category,
+            std::input_iterator_tag>::value>::type>
+    VLDeque(InputIterator first, InputIterator last, const Allocator &alloc = Allocator()) : VLDeque(alloc)
+    {
+        try
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+        catch (...)
+        {
+            _release();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Constructs a deque of given values.
+     * @param values the values.
+     * @param alloc the allocator to use.
+     */
+    VLDeque(std::initializer_list<T> values, const Allocator &alloc = Allocator())
+            : VLDeque(values.begin(), values.end(), alloc)
+    {
+    }
+
+    /**
+     * @brief Copy constructor. The elements are copied unwrapped, onto the stack if they fit
+     * there and otherwise into a heap ring of exactly their size.
+     * The allocator is obtained by select_on_container_copy_construction.
+     * @param other the deque to copy from.
+     */
+    VLDeque(const VLDeque &other)
+            : VLDeque(other, _AllocTraits::select_on_container_copy_construction(other._getAllocator()))
+    {
+    }
+
+    /**
+     * @brief Copy constructor with a given allocator.
+     * @param other the deque to copy from.
+     * @param alloc the allocator of the new deque.
+     */
+    VLDeque(const VLDeque &other, const Allocator &alloc) : VLDeque(alloc)
+    {
+        _setCapacity(other._size);
+        T *ring = _ring();
+        try
+        {
+            for (; _size < other._size; ++_size)
+            {
+                _construct(ring + _size, other[_size]);
+            }
+        }
+        catch (...)
+        {
+            _release();
+            throw;
+        }
+    }
+
+    /**
+     * @brief Move constructor.
+     * In heap mode the heap ring is taken as is, in stack mode the elements are moved.
+     * @param other the deque to move from.
+     */
+    VLDeque(VLDeque &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+            : VLDeque(std::move(other._getAllocator()))
+    {
+        _takeFrom(other);
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~VLDeque()
+    {
+        _release();
+    }
+
+    /**
+     * @brief Copy assignment operator. The copy is built before the elements of this deque are
+     * destroyed, so if copying an element throws this deque is left unchanged.
+     * The allocator of other is taken iff the allocator propagates on copy assignment.
+     * @param other the deque to assign from.
+     * @return this deque after assignment.
+     */
+    VLDeque &operator=(const VLDeque &other)
+    {
+        if (this != &other)
+        {
+            typedef typename _AllocTraits::propagate_on_container_copy_assignment propagate;
+            VLDeque copy(other, propagate::value ? other._getAllocator() : _getAllocator());
+            _release();
+            _adoptAllocator(copy, propagate());
+            _takeFrom(copy);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment operator. The allocator of other is taken iff the allocator
+     * propagates on move assignment. The heap ring of other is then taken as is if the allocators
+     * are equal, otherwise its elements are moved.
+     * @param other the deque to assign from.
+     * @return this deque after assignment.
+     */
+    VLDeque &operator=(VLDeque &&other)
+            noexcept(std::is_nothrow_move_constructible<T>::value &&
+                     (_AllocTraits::propagate_on_container_move_assignment::value ||
+                      _AllocAlwaysEqual::value))
+    {
+        if (this != &other)
+        {
+            _release();
+            _adoptAllocator(other, typename _AllocTraits::propagate_on_container_move_assignment());
+            _takeFrom(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Swaps the contents of two deques.
+     * The allocators are swapped only if they propagate on swap, otherwise each deque keeps its
+     * allocator and elements that live in a heap ring of a different allocator are moved.
+     * @param first the first deque.
+     * @param second the second deque.
+     */
+    friend void swap(VLDeque &first, VLDeque &second)
+            noexcept(std::is_nothrow_move_constructible<T>::value &&
+                     (_AllocTraits::propagate_on_container_swap::value || _AllocAlwaysEqual::value))
+    {
+        typedef typename _AllocTraits::propagate_on_container_swap propagate;
+        VLDeque temp(std::move(first));
+        first._adoptAllocator(second, propagate());
+        first._takeFrom(second);
+        second._adoptAllocator(temp, propagate());
+        second._takeFrom(temp);
+    }
+
+    /********************************************************************
+    *                            API methods                            *
+    ********************************************************************/
+
+    /**
+     * @brief Returns the number of elements that are stored in the deque.
+     * @return the number of elements that are stored in the deque.
+     */
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @brief Checks if the deque is empty.
+     * @return true iff the deque is empty.
+     */
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    /**
+     * @brief Returns the amount of elements the deque can hold before it has to reallocate.
+     * @return the capacity of the deque.
+     */
+    std::size_t capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    /**
+     * @brief Returns the largest amount of elements the deque can hold, limited by the allocator.
+     * @return the maximal size of the deque.
+     */
+    std::size_t max_size() const noexcept
+    {
+        return _AllocTraits::max_size(_getAllocator());
+    }
+
+    /**
+     * @brief Returns a copy of the allocator of the deque.
+     * @return the allocator of the deque.
+     */
+    Allocator get_allocator() const
+    {
+        return _getAllocator();
+    }
+
+    /**
+     * @brief Makes sure the deque can hold a given amount of elements without reallocating.
+     * @param newCapacity the amount of elements.
+     */
+    void reserve(std::size_t newCapacity)
+    {
+        if (newCapacity > _capacity)
+        {
+            _setCapacity(newCapacity);
+        }
+    }
+
+    /**
+     * @brief Reduces the capacity to the size of the deque, returning to the stack if the
+     * elements fit there.
+     */
+    void shrink_to_fit()
+    {
+        _setCapacity(_size);
+    }
+
+    /**
+     * @brief Returns the element at a given index, counting from the front.
+     * @param index the index of the element.
+     * @return a reference to the element.
+     */
+    T &operator[](std::size_t index) noexcept
+    {
+        return _ring()[_slot(index)];
+    }
+
+    /**
+     * @brief Returns the element at a given index, counting from the front.
+     * @param index the index of the element.
+     * @return a const reference to the element.
+     */
+    const T &operator[](std::size_t index) const noexcept
+    {
+        return _ring()[_slot(index)];
+    }
+
+    /**
+     * @brief Returns the element at a given index, counting from the front.
+     * Throws an exception if the index was not found.
+     * @param index the index of the element.
+     * @return a reference to the element.
+     */
+    T &at(std::size_t index)
+    {
+        if (index < _size)
+        {
+            return (*this)[index];
+        }
+        throw std::out_of_range(AT_EXCEPTION_MSG);
+    }
+
+    /**
+     * @brief Returns the element at a given index, counting from the front.
+     * Throws an exception if the index was not found.
+     * @param index the index of the element.
+     * @return a const reference to the element.
+     */
+    const T &at(std::size_t index) const
+    {
+        if (index < _size)
+        {
+            return (*this)[index];
+        }
+        throw std::out_of_range(AT_EXCEPTION_MSG);
+    }
+
+    /**
+     * @brief Returns the element at the front of the deque, which must not be empty.
+     * @return a reference to the front element.
+     */
+    T &front() noexcept
+    {
+        return _ring()[_head];
+    }
+
+    /**
+     * @brief Returns the element at the front of the deque, which must not be empty.
+     * @return a const reference to the front element.
+     */
+    const T &front() const noexcept
+    {
+        return _ring()[_head];
+    }
+
+    /**
+     * @brief Returns the element at the back of the deque, which must not be empty.
+     * @return a reference to the back element.
+     */
+    T &back() noexcept
+    {
+        return (*this)[_size - 1];
+    }
+
+    /**
+     * @brief Returns the element at the back of the deque, which must not be empty.
+     * @return a const reference to the back element.
+     */
+    const T &back() const noexcept
+    {
+        return (*this)[_size - 1];
+    }
+
+    /**
+     * @brief Constructs a value in place at the back of the deque.
+     * @param args the arguments to pass to the constructor of T.
+     * @return a reference to the added value.
+     */
+    template<typename... Args>
+    T &emplace_back(Args &&... args)
+    {
+        if (_size == _capacity)
+        {
+            // args may refer to elements of this deque, so the value is built before the ring moves:
+            T value(std::forward<Args>(args)...);
+            _growIfFull();
+            _construct(_ring() + _slot(_size), std::move(value));
+        }
+        else
+        {
+            _construct(_ring() + _slot(_size), std::forward<Args>(args)...);
+        }
+        ++_size;
+        return back();
+    }
+
+    /**
+     * @brief Constructs a value in place at the front of the deque.
+     * @param args the arguments to pass to the constructor of T.
+     * @return a reference to the added value.
+     */
+    template<typename... Args>
+    T &emplace_front(Args &&... args)
+    {
+        if (_size == _capacity)
+        {
+            T value(std::forward<Args>(args)...);
+            _growIfFull();
+            const std::size_t head = _head == 0 ? _capacity - 1 : _head - 1;
+            _construct(_ring() + head, std::move(value));
+            _head = head;
+        }
+        else
+        {
+            const std::size_t head = _head == 0 ? _capacity - 1 : _head - 1;
+            _construct(_ring() + head, std::forward<Args>(args)...);
+            _head = head;
+        }
+        ++_size;
+        return front();
+    }
+
+    /**
+     * @brief Adds a copy of a value at the back of the deque.
+     * @param val the value to add.
+     */
+    void push_back(const T &val)
+    {
+        emplace_back(val);
+    }
+
+    /**
+     * @brief Moves a value to the back of the deque.
+     * @param val the value to add.
+     */
+    void push_back(T &&val)
+    {
+        emplace_back(std::move(val));
+    }
+
+    /**
+     * @brief Adds a copy of a value at the front of the deque.
+     * @param val the value to add.
+     */
+    void push_front(const T &val)
+    {
+        emplace_front(val);
+    }
+
+    /**
+     * @brief Moves a value to the front of the deque.
+     * @param val the value to add.
+     */
+    void push_front(T &&val)
+    {
+        emplace_front(std::move(val));
+    }
+
+    /**
+     * @brief Removes the element at the back of the deque.
+     */
+    void pop_back()
+    {
+        if (_size > 0)
+        {
+            _destroy(_ring() + _slot(_size - 1));
+            --_size;
+            _shrinkIfNeeded();
+        }
+    }
+
+    /**
+     * @brief Removes the element at the front of the deque.
+     */
+    void pop_front()
+    {
+        if (_size > 0)
+        {
+            _destroy(_ring() + _head);
+            _head = _slot(1);
+            --_size;
+            _shrinkIfNeeded();
+        }
+    }
+
+    /**
+     * @brief Destroys all the elements, keeping the capacity.
+     */
+    void clear() noexcept
+    {
+        T *ring = _ring();
+        for (std::size_t index = 0; index < _size; ++index)
+        {
+            _destroy(ring + _slot(index));
+        }
+        _head = 0;
+        _size = 0;
+    }
+
+    /**
+     * @brief Checks if this deque holds the same elements as another deque, in the same order.
+     * @param other the other deque.
+     * @return true iff the deques hold equal elements in the same order.
+     */
+    bool operator==(const VLDeque &other) const
+    {
+        return _size == other._size && std::equal(begin(), end(), other.begin());
+    }
+
+    /**
+     * @brief Checks if this deque differs from another deque.
+     * @param other the other deque.
+     * @return true iff the deques do not hold equal elements in the same order.
+     */
+    bool operator!=(const VLDeque &other) const
+    {
+        return !(*this == other);
+    }
+
+    /********************************************************************
+    *                       Begin and end iterators                     *
+    ********************************************************************/
+
+    /**
+     * @brief Returns an iterator to the front element of the deque.
+     * @return an iterator to the beginning of the deque.
+     */
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    /**
+     * @brief Returns an iterator past the back element of the deque.
+     * @return an iterator to the end of the deque.
+     */
+    iterator end()
+    {
+        return iterator(this, _size);
+    }
+
+    /**
+     * @brief Returns a const iterator to the front element of the deque.
+     * @return an iterator to the beginning of the deque.
+     */
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /**
+     * @brief Returns a const iterator past the back element of the deque.
+     * @return an iterator to the end of the deque.
+     */
+    const_iterator end() const
+    {
+        return const_iterator(this, _size);
+    }
+
+    /**
+     * @brief Returns a const iterator to the front element of the deque.
+     * @return an iterator to the beginning of the deque.
+     */
+    const_iterator cbegin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /**
+     * @brief Returns a const iterator past the back element of the deque.
+     * @return an iterator to the end of the deque.
+     */
+    const_iterator cend() const
+    {
+        return const_iterator(this, _size);
+    }
+
+    /**
+     * @brief Returns a reverse iterator to the back element of the deque.
+     * @return a reverse iterator to the beginning of the reversed deque.
+     */
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    /**
+     * @brief Returns a reverse iterator to the position before the front element.
+     * @return a reverse iterator to the end of the reversed deque.
+     */
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    /**
+     * @brief Returns a const reverse iterator to the back element of the deque.
+     * @return a reverse iterator to the beginning of the reversed deque.
+     */
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /**
+     * @brief Returns a const reverse iterator to the position before the front element.
+     * @return a reverse iterator to the end of the reversed deque.
+     */
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLDEQUE_HPP
@@ -0,0 +1,1011 @@
+//
+// A sorted map stored as two VLVectors, one of keys and one of values: lookups scan only the
+// contiguous keys, which for trivially comparable keys is done with SIMD, and small maps live
+// entirely in the inline storage.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLFLATMAP_HPP
+#define CPP_FINAL_PROJECT_VLFLATMAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "VLVector.hpp"
+#include "VLVectorView.hpp"
+#include "VLFlatSet.hpp"
+
+#define KEY_EXCEPTION_MSG "In function \"at\": Key was not found"
+
+/**
+ * @brief Represents a sorted map of unique keys to values, stored as a VLVector of keys and a
+ * parallel VLVector of values.
+ * Insertion and removal shift the entries after the position, so the map suits small maps and
+ * maps that are built once and then searched.
+ * @tparam K the type of the keys.
+ * @tparam V the type of the values.
+ * @tparam StaticCapacity the amount of entries stored without allocating.
+ * @tparam Compare the strict weak ordering of the keys; a transparent ordering such as
+ * std::less<> enables lookup by any type comparable with the keys.
+ */
+template<typename K, typename V, std::size_t StaticCapacity = DEF_STATIC_CAPACITY,
+        typename Compare = std::less<K>>
+class VLFlatMap
+{
+private:
+    typedef VLFlatSearch<K, Compare> _Search;
+
+    /********************************************************************
+    *                             Class members                         *
+    ********************************************************************/
+
+    VLVector<K, StaticCapacity> _keys;
+    VLVector<V, StaticCapacity> _values;
+    Compare _compare;
+
+    /**
+     * @brief Returns a pointer to the smallest key.
+     */
+    const K *_first() const noexcept
+    {
+        return _keys.data();
+    }
+
+    /**
+     * @brief Returns a pointer past the largest key.
+     */
+    const K *_last() const noexcept
+    {
+        return _keys.data() + _keys.size();
+    }
+
+    /**
+     * @brief Returns the index of the key a pointer points to.
+     */
+    std::size_t _index(const K *key) const noexcept
+    {
+        return key - _keys.data();
+    }
+
+    /**
+     * @brief Inserts a key and a value constructed from given arguments at a given index.
+     * If constructing the value throws, the key is removed again.
+     * @param index the index of the new entry.
+     * @param key the key of the entry.
+     * @param args the arguments of the value's constructor.
+     */
+    template<typename Key, typename... Args>
+    void _insertAt(std::size_t index, Key &&key, Args &&... args)
+    {
+        _keys.emplace(_keys.cbegin() + index, std::forward<Key>(key));
+        try
+        {
+            _values.emplace(_values.cbegin() + index, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            _keys.erase(_keys.cbegin() + index);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Inserts a key with a value constructed from given arguments, if no equivalent key
+     * is in the map.
+     */
+    template<typename Key, typename... Args>
+    std::pair<std::size_t, bool> _tryEmplace(Key &&key, Args &&... args)
+    {
+        const K *position = _Search::lowerBound(_first(), _last(), key, _compare);
+        const std::size_t index = _index(position);
+        if (position != _last() && !_compare(key, *position))
+        {
+            return std::make_pair(index, false);
+        }
+        _insertAt(index, std::forward<Key>(key), std::forward<Args>(args)...);
+        return std::make_pair(index, true);
+    }
+
+    /********************************************************************
+    *                             Iterators                             *
+    ********************************************************************/
+
+    /**
+     * @brief An iterator over the entries of the map. Since keys and values are stored apart,
+     * it yields pairs of references instead of references to pairs, and operator-> returns a
+     * proxy that holds such a pair. A forward iterator must yield real references, so the
+     * iterator is categorised as an input iterator, although it supports the operations of a
+     * random access iterator.
+     * @tparam Const true iff the iterator gives read only access to the values.
+     */
+    template<bool Const>
+    class VLFlatMapIterator
+    {
+    private:
+        typedef typename std::conditional<Const, const VLFlatMap, VLFlatMap>::type _Owner;
+        typedef typename std::conditional<Const, const V, V>::type _Value;
+
+        template<bool> friend class VLFlatMapIterator;
+
+        friend class VLFlatMap;
+
+        _Owner *_map;
+        std::size_t _index;
+
+        /**
+         * @brief Holds the pair of references of an entry, so that it->first and it->second
+         * refer to the key and value of the entry.
+         */
+        class _ArrowProxy
+        {
+        private:
+            std::pair<const K &, _Value &> _entry;
+
+        public:
+            /**
+             * @brief Constructs a proxy of an entry.
+             * @param entry the pair of references to the key and value of the entry.
+             */
+            explicit _ArrowProxy(const std::pair<const K &, _Value &> &entry) : _entry(entry)
+            {
+            }
+
+            /**
+             * @brief Returns a pointer to the pair of references of the entry.
+             * @return a pointer to the pair, valid as long as the proxy.
+             */
+            const std::pair<const K &, _Value &> *operator->() const noexcept
+            {
+                return &_entry;
+            }
+        };
+
+    public:
+        /**
+         * @brief Iterator traits.
+         */
+        typedef std::pair<const K &, _Value &> value_type;
+        typedef value_type reference;
+        typedef _ArrowProxy pointer;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::input_iterator_tag iterator_category;
+
+        /**
+         * @brief Constructs a singular iterator that does not point into any map.
+         */
+        VLFlatMapIterator() : _map(nullptr), _index(0)
+        {
+        }
+
+        /**
+         * @brief Constructs an iterator to a given entry.
+         * @param map the map to iterate over.
+         * @param index the index of the entry.
+         */
+        VLFlatMapIterator(_Owner *map, std::size_t index) : _map(map), _index(index)
+        {
+        }
+
+        /**
+         * @brief Converts a non-const iterator to a const iterator.
+         * @param other the iterator to convert.
+         */
+        template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+        VLFlatMapIterator(const VLFlatMapIterator<OtherConst> &other)
+                : _map(other._map), _index(other._index)
+        {
+        }
+
+        /**
+         * @brief Returns references to the key and value of the current entry.
+         * @return a pair of references to the key and value.
+         */
+        reference operator*() const
+        {
+            return reference(_map->_keys.data()[_index], _map->_values.data()[_index]);
+        }
+
+        /**
+         * @brief Gives access to the key and value of the current entry through it->first and
+         * it->second.
+         * @return a proxy of the current entry.
+         */
+        pointer operator->() const
+        {
+            return pointer(operator*());
+        }
+
+        /**
+         * @brief Returns references to the key and value of the entry at a given distance.
+         * @param n the distance of the entry.
+         * @return a pair of references to the key and value.
+         */
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        /**
+         * @brief Returns the key of the current entry.
+         * @return a reference to the key.
+         */
+        const K &key() const
+        {
+            return _map->_keys.data()[_index];
+        }
+
+        /**
+         * @brief Returns the value of the current entry.
+         * @return a reference to the value.
+         */
+        _Value &value() const
+        {
+            return _map->_values.data()[_index];
+        }
+
+        /**
+         * @brief Increments the iterator so that it points to the next entry in the map.
+         * @return the iterator after it was incremented.
+         */
+        VLFlatMapIterator &operator++()
+        {
+            ++_index;
+            return *this;
+        }
+
+        /**
+         * @brief Increments the iterator so that it points to the next entry in the map.
+         * @return the iterator before it was incremented.
+         */
+        VLFlatMapIterator operator++(int)
+        {
+            VLFlatMapIterator temp = *this;
+            ++_index;
+            return temp;
+        }
+
+        /**
+         * @brief Decrements the iterator so that it points to the previous entry in the map.
+         * @return the iterator after it was decremented.
+         */
+        VLFlatMapIterator &operator--()
+        {
+            --_index;
+            return *this;
+        }
+
+        /**
+         * @brief Decrements the iterator so that it points to the previous entry in the map.
+         * @return the iterator before it was decremented.
+         */
+        VLFlatMapIterator operator--(int)
+        {
+            VLFlatMapIterator temp = *this;
+            --_index;
+            return temp;
+        }
+
+        /**
+         * @brief Moves the iterator a given amount of entries forward.
+         * @param n the amount of entries.
+         * @return this iterator after the addition.
+         */
+        VLFlatMapIterator &operator+=(difference_type n)
+        {
+            _index += n;
+            return *this;
+        }
+
+        /**
+         * @brief Moves the iterator a given amount of entries backward.
+         * @param n the amount of entries.
+         * @return this iterator after the subtraction.
+         */
+        VLFlatMapIterator &operator-=(difference_type n)
+        {
+            _index -= n;
+            return *this;
+        }
+
+        /**
+         * @brief Returns an iterator to the entry a given amount of entries after this iterator.
+         * @param n the amount of entries.
+         * @return the result of the addition.
+         */
+        VLFlatMapIterator operator+(difference_type n) const
+        {
+            return VLFlatMapIterator(_map, _index + n);
+        }
+
+        /**
+         * @brief Returns an iterator to the entry a given amount of entries after an iterator.
+         * @param n the amount of entries.
+         * @param it the iterator.
+         * @return the result of the addition.
+         */
+        friend VLFlatMapIterator operator+(difference_type n, const VLFlatMapIterator &it)
+        {
+            return it + n;
+        }
+
+        /**
+         * @brief Returns an iterator to the entry a given amount of entries before this iterator.
+         * @param n the amount of entries.
+         * @return the result of the subtraction.
+         */
+        VLFlatMapIterator operator-(difference_type n) const
+        {
+            return VLFlatMapIterator(_map, _index - n);
+        }
+
+        /**
+         * @brief Returns the distance between two iterators. Either may be const, as a non-const
+         * iterator converts to a const iterator.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return the amount of entries from rhs to lhs.
+         */
+        friend difference_type operator-(const VLFlatMapIterator &lhs, const VLFlatMapIterator &rhs)
+        {
+            return (difference_type) lhs._index - (difference_type) rhs._index;
+        }
+
+        /**
+         * @brief Checks if two iterators point to the same entry. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff both iterators point to the same entry.
+         */
+        friend bool operator==(const VLFlatMapIterator &lhs, const VLFlatMapIterator &rhs)
+        {
+            return lhs._index == rhs._index;
+        }
+
+        /**
+         * @brief Checks if two iterators don't point to the same entry. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff the iterators don't point to the same entry.
+         */
+        friend bool operator!=(const VLFlatMapIterator &lhs, const VLFlatMapIterator &rhs)
+        {
+            return lhs._index != rhs._index;
+        }
+
+        /**
+         * @brief Checks if an iterator points to an entry before the entry of another iterator.
+         * Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff lhs points to an earlier entry.
+         */
+        friend bool operator<(const VLFlatMapIterator &lhs, const VLFlatMapIterator &rhs)
+        {
+            return lhs._index < rhs._index;
+        }
+
+        /**
+         * @brief Checks if an iterator points to an entry after the entry of another iterator.
+         * Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff lhs points to a later entry.
+         */
+        friend bool operator>(const VLFlatMapIterator &lhs, const VLFlatMapIterator &rhs)
+        {
+            return lhs._index > rhs._index;
+        }
+
+        /**
+         * @brief Checks if an iterator points to an entry before the entry of another iterator,
+         * or to the same entry. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff lhs does not point to a later entry.
+         */
+        friend bool operator<=(const VLFlatMapIterator &lhs, const VLFlatMapIterator &rhs)
+        {
+            return lhs._index <= rhs._index;
+        }
+
+        /**
+         * @brief Checks if an iterator points to an entry after the entry of another iterator,
+         * or to the same entry. Either may be const.
+         * @param lhs the first iterator.
+         * @param rhs the second iterator.
+         * @return true iff lhs does not point to an earlier entry.
+         */
+        friend bool operator>=(const VLFlatMapIterator &lhs, const VLFlatMapIterator &rhs)
+        {
+            return lhs._index >= rhs._index;
+        }
+    };
+
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef Compare key_compare;
+    typedef VLFlatMapIterator<false> iterator;
+    typedef VLFlatMapIterator<true> const_iterator;
+
+    /********************************************************************
+    *                       Rule of 5 methods                           *
+    ********************************************************************/
+
+    /**
+     * @brief Default constructor. Initialises an empty map.
+     * @param compare the ordering of the keys.
+     */
+    explicit VLFlatMap(const Compare &compare = Compare()) : _compare(compare)
+    {
+    }
+
+    /**
+     * @brief Constructs a map of the key-value pairs in a given range, which need not be sorted
+     * or have unique keys. The pairs are sorted once, and of equivalent keys the first is kept.
+     * @param first an iterator to the first pair.
+     * @param last an iterator past the last pair.
+     * @param compare the ordering of the keys.
+     */
+    template<typename InputIterator, typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIterator>::iterator_category,
+            std::input_iterator_tag>::value>::type>
+    VLFlatMap(InputIterator first, InputIterator last, const Compare &compare = Compare())
+            : _compare(compare)
+    {
+        VLVector<std::pair<K, V>, StaticCapacity> entries(first, last);
+        std::pair<K, V> *data = entries.data();
+        std::stable_sort(data, data + entries.size(),
+                         [&compare](const std::pair<K, V> &lhs, const std::pair<K, V> &rhs)
+                         {
+                             return compare(lhs.first, rhs.first);
+                         });
+        _keys.reserve(entries.size());
+        _values.reserve(entries.size());
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            if (!_keys.empty() && !_compare(_keys.data()[_keys.size() - 1], data[i].first))
+            {
+                continue;
+            }
+            _keys.push_back(std::move(data[i].first));
+            _values.push_back(std::move(data[i].second));
+        }
+    }
+
+    /**
+     * @brief Constructs a map of given key-value pairs, which need not be sorted or unique.
+     * @param entries the key-value pairs.
+     * @param compare the ordering of the keys.
+     */
+    VLFlatMap(std::initializer_list<std::pair<K, V>> entries, const Compare &compare = Compare())
+            : VLFlatMap(entries.begin(), entries.end(), compare)
+    {
+    }
+
+    /********************************************************************
+    *                            API methods                            *
+    ********************************************************************/
+
+    /**
+     * @brief Returns the number of entries in the map.
+     * @return the number of entries in the map.
+     */
+    std::size_t size() const noexcept
+    {
+        return _keys.size();
+    }
+
+    /**
+     * @brief Checks if the map is empty.
+     * @return true iff the map holds no entries.
+     */
+    bool empty() const noexcept
+    {
+        return _keys.empty();
+    }
+
+    /**
+     * @brief Returns the amount of entries the map can hold before it has to reallocate.
+     * @return the capacity of the map.
+     */
+    std::size_t capacity() const noexcept
+    {
+        return _keys.capacity();
+    }
+
+    /**
+     * @brief Makes sure the map can hold a given amount of entries without reallocating.
+     * @param newCapacity the amount of entries the map should be able to hold.
+     */
+    void reserve(std::size_t newCapacity)
+    {
+        _keys.reserve(newCapacity);
+        _values.reserve(newCapacity);
+    }
+
+    /**
+     * @brief Removes all entries from the map.
+     */
+    void clear() noexcept
+    {
+        _keys.clear();
+        _values.clear();
+    }
+
+    /**
+     * @brief Returns the sorted keys.
+     * @return a view of the keys.
+     */
+    VLVectorView<K> keys() const noexcept
+    {
+        return VLVectorView<K>(_keys);
+    }
+
+    /**
+     * @brief Returns the values, in the order of their keys.
+     * @return a view of the values.
+     */
+    VLVectorView<V> values() const noexcept
+    {
+        return VLVectorView<V>(_values);
+    }
+
+    /**
+     * @brief Inserts a key with a value constructed from given arguments, if no equivalent key
+     * is in the map. Otherwise, the arguments are left untouched.
+     * @param key the key to insert.
+     * @param args the arguments of the value's constructor.
+     * @return an iterator to the entry of the key, and true iff the entry was inserted.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K &key, Args &&... args)
+    {
+        std::pair<std::size_t, bool> result = _tryEmplace(key, std::forward<Args>(args)...);
+        return std::make_pair(iterator(this, result.first), result.second);
+    }
+
+    /**
+     * @brief Inserts a key, which is moved into the map, with a value constructed from given
+     * arguments, if no equivalent key is in the map. Otherwise, the key and the arguments are left
+     * untouched.
+     * @param key the key to insert.
+     * @param args the arguments of the value's constructor.
+     * @return an iterator to the entry of the key, and true iff the entry was inserted.
+     */
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(K &&key, Args &&... args)
+    {
+        std::pair<std::size_t, bool> result = _tryEmplace(std::move(key), std::forward<Args>(args)...);
+        return std::make_pair(iterator(this, result.first), result.second);
+    }
+
+    /**
+     * @brief Inserts a key-value pair if no equivalent key is in the map.
+     * @param entry the pair to insert.
+     * @return an iterator to the entry of the key, and true iff the entry was inserted.
+     */
+    std::pair<iterator, bool> insert(const std::pair<K, V> &entry)
+    {
+        return try_emplace(entry.first, entry.second);
+    }
+
+    /**
+     * @brief Inserts a key-value pair, which is moved into the map, if no equivalent key is in
+     * the map.
+     * @param entry the pair to insert.
+     * @return an iterator to the entry of the key, and true iff the entry was inserted.
+     */
+    std::pair<iterator, bool> insert(std::pair<K, V> &&entry)
+    {
+        return try_emplace(std::move(entry.first), std::move(entry.second));
+    }
+
+    /**
+     * @brief Assigns a value to a key, inserting the key if it is not in the map.
+     * @param key the key.
+     * @param value the value to assign.
+     * @return an iterator to the entry of the key, and true iff the entry was inserted.
+     */
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const K &key, M &&value)
+    {
+        std::pair<std::size_t, bool> result = _tryEmplace(key, std::forward<M>(value));
+        if (!result.second)
+        {
+            _values.data()[result.first] = std::forward<M>(value);
+        }
+        return std::make_pair(iterator(this, result.first), result.second);
+    }
+
+    /**
+     * @brief Returns the value of a key, inserting a default constructed value if the key is
+     * not in the map.
+     * @param key the key.
+     * @return a reference to the value of the key.
+     */
+    V &operator[](const K &key)
+    {
+        const std::size_t index = _tryEmplace(key).first;
+        return _values.data()[index];
+    }
+
+    /**
+     * @brief Returns the value of a key, which is moved into the map with a default constructed
+     * value if it is not in the map.
+     * @param key the key.
+     * @return a reference to the value of the key.
+     */
+    V &operator[](K &&key)
+    {
+        const std::size_t index = _tryEmplace(std::move(key)).first;
+        return _values.data()[index];
+    }
+
+    /**
+     * @brief Returns the value of a key.
+     * @param key the key.
+     * @return a reference to the value of the key.
+     * @throws std::out_of_range if the key is not in the map.
+     */
+    V &at(const K &key)
+    {
+        const K *found = _Search::find(_first(), _last(), key, _compare);
+        if (found == _last())
+        {
+            throw std::out_of_range(KEY_EXCEPTION_MSG);
+        }
+        return _values.data()[_index(found)];
+    }
+
+    /**
+     * @brief Returns the value of a key.
+     * @param key the key.
+     * @return a const reference to the value of the key.
+     * @throws std::out_of_range if the key is not in the map.
+     */
+    const V &at(const K &key) const
+    {
+        const K *found = _Search::find(_first(), _last(), key, _compare);
+        if (found == _last())
+        {
+            throw std::out_of_range(KEY_EXCEPTION_MSG);
+        }
+        return _values.data()[_index(found)];
+    }
+
+    /**
+     * @brief Removes the entry of the key equivalent to a given key.
+     * @param key the key to remove.
+     * @return the amount of entries that were removed.
+     */
+    std::size_t erase(const K &key)
+    {
+        const K *found = _Search::find(_first(), _last(), key, _compare);
+        if (found == _last())
+        {
+            return 0;
+        }
+        erase(const_iterator(this, _index(found)));
+        return 1;
+    }
+
+    /**
+     * @brief Removes the entry at a given position.
+     * @param position an iterator to the entry.
+     * @return an iterator to the entry after the removed entry.
+     */
+    iterator erase(const_iterator position)
+    {
+        _keys.erase(_keys.cbegin() + position._index);
+        _values.erase(_values.cbegin() + position._index);
+        return iterator(this, position._index);
+    }
+
+    /**
+     * @brief Finds the entry of the key equivalent to a given key.
+     * @param key the key to look for.
+     * @return an iterator to the entry, or end() if there is none.
+     */
+    iterator find(const K &key)
+    {
+        return iterator(this, _index(_Search::find(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Finds the entry of the key equivalent to a given key.
+     * @param key the key to look for.
+     * @return a const iterator to the entry, or end() if there is none.
+     */
+    const_iterator find(const K &key) const
+    {
+        return const_iterator(this, _index(_Search::find(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Finds the entry of the key equivalent to a key of another type. Only enabled for
+     * transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return an iterator to the entry, or end() if there is none.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    iterator find(const Key &key)
+    {
+        return iterator(this, _index(_Search::find(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Finds the entry of the key equivalent to a key of another type. Only enabled for
+     * transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return a const iterator to the entry, or end() if there is none.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    const_iterator find(const Key &key) const
+    {
+        return const_iterator(this, _index(_Search::find(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Checks if the map holds a key equivalent to a given key.
+     * @param key the key to look for.
+     * @return true iff an equivalent key is in the map.
+     */
+    bool contains(const K &key) const
+    {
+        return _Search::find(_first(), _last(), key, _compare) != _last();
+    }
+
+    /**
+     * @brief Checks if the map holds a key equivalent to a key of another type. Only enabled
+     * for transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return true iff an equivalent key is in the map.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    bool contains(const Key &key) const
+    {
+        return _Search::find(_first(), _last(), key, _compare) != _last();
+    }
+
+    /**
+     * @brief Counts the keys equivalent to a given key.
+     * @param key the key to look for.
+     * @return 1 if an equivalent key is in the map, otherwise 0.
+     */
+    std::size_t count(const K &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /**
+     * @brief Counts the keys equivalent to a key of another type. Only enabled for transparent
+     * orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return 1 if an equivalent key is in the map, otherwise 0.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    std::size_t count(const Key &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /**
+     * @brief Returns the first entry whose key is not less than a given key.
+     * @param key the key to look for.
+     * @return an iterator to the first entry whose key is not less than the given key.
+     */
+    iterator lower_bound(const K &key)
+    {
+        return iterator(this, _index(_Search::lowerBound(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Returns the first entry whose key is not less than a given key.
+     * @param key the key to look for.
+     * @return a const iterator to the first entry whose key is not less than the given key.
+     */
+    const_iterator lower_bound(const K &key) const
+    {
+        return const_iterator(this, _index(_Search::lowerBound(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Returns the first entry whose key is not less than a key of another type. Only
+     * enabled for transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return an iterator to the first entry whose key is not less than the given key.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    iterator lower_bound(const Key &key)
+    {
+        return iterator(this, _index(_Search::lowerBound(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Returns the first entry whose key is not less than a key of another type. Only
+     * enabled for transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return a const iterator to the first entry whose key is not less than the given key.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    const_iterator lower_bound(const Key &key) const
+    {
+        return const_iterator(this, _index(_Search::lowerBound(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Returns the first entry whose key is greater than a given key.
+     * @param key the key to look for.
+     * @return an iterator to the first entry whose key is greater than the given key.
+     */
+    iterator upper_bound(const K &key)
+    {
+        return iterator(this, _index(_Search::upperBound(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Returns the first entry whose key is greater than a given key.
+     * @param key the key to look for.
+     * @return a const iterator to the first entry whose key is greater than the given key.
+     */
+    const_iterator upper_bound(const K &key) const
+    {
+        return const_iterator(this, _index(_Search::upperBound(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Returns the first entry whose key is greater than a key of another type. Only
+     * enabled for transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return an iterator to the first entry whose key is greater than the given key.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    iterator upper_bound(const Key &key)
+    {
+        return iterator(this, _index(_Search::upperBound(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Returns the first entry whose key is greater than a key of another type. Only
+     * enabled for transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return a const iterator to the first entry whose key is greater than the given key.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    const_iterator upper_bound(const Key &key) const
+    {
+        return const_iterator(this, _index(_Search::upperBound(_first(), _last(), key, _compare)));
+    }
+
+    /**
+     * @brief Returns the range of entries whose keys are equivalent to a given key, which holds
+     * at most one entry.
+     * @param key the key to look for.
+     * @return the lower bound and the upper bound of the key.
+     */
+    std::pair<iterator, iterator> equal_range(const K &key)
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    /**
+     * @brief Returns the range of entries whose keys are equivalent to a given key, which holds
+     * at most one entry.
+     * @param key the key to look for.
+     * @return const iterators to the lower bound and the upper bound of the key.
+     */
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    /**
+     * @brief Returns the range of entries whose keys are equivalent to a key of another type.
+     * Only enabled for transparent orderings, such as std::less<>. Unlike the other lookups,
+     * the range may hold several entries, since keys that differ may be equivalent to the key.
+     * @param key the key to look for.
+     * @return the lower bound and the upper bound of the key.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    std::pair<iterator, iterator> equal_range(const Key &key)
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    /**
+     * @brief Returns the range of entries whose keys are equivalent to a key of another type.
+     * Only enabled for transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return const iterators to the lower bound and the upper bound of the key.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const Key &key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    /**
+     * @brief Checks if this map holds the same entries as another map.
+     * @param other the other map.
+     * @return true iff the maps hold equal keys mapped to equal values.
+     */
+    bool operator==(const VLFlatMap &other) const
+    {
+        return _keys == other._keys && _values == other._values;
+    }
+
+    /**
+     * @brief Checks if this map differs from another map.
+     * @param other the other map.
+     * @return true iff the maps do not hold the same entries.
+     */
+    bool operator!=(const VLFlatMap &other) const
+    {
+        return !(*this == other);
+    }
+
+    /********************************************************************
+    *                       Begin and end iterators                     *
+    ********************************************************************/
+
+    /**
+     * @brief Returns an iterator to the entry of the smallest key.
+     * @return an iterator to the beginning of the map.
+     */
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    /**
+     * @brief Returns an iterator past the entry of the largest key.
+     * @return an iterator to the end of the map.
+     */
+    iterator end()
+    {
+        return iterator(this, size());
+    }
+
+    /**
+     * @brief Returns a const iterator to the entry of the smallest key.
+     * @return an iterator to the beginning of the map.
+     */
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /**
+     * @brief Returns a const iterator past the entry of the largest key.
+     * @return an iterator to the end of the map.
+     */
+    const_iterator end() const
+    {
+        return const_iterator(this, size());
+    }
+
+    /**
+     * @brief Returns a const iterator to the entry of the smallest key.
+     * @return an iterator to the beginning of the map.
+     */
+    const_iterator cbegin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /**
+     * @brief Returns a const iterator past the entry of the largest key.
+     * @return an iterator to the end of the map.
+     */
+    const_iterator cend() const
+    {
+        return const_iterator(this, size());
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLFLATMAP_HPP
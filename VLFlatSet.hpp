@@ -0,0 +1,540 @@
+//
+// A sorted set stored in a VLVector: small sets live entirely in the inline storage, with no
+// allocation per element, and lookups scan the contiguous keys instead of chasing tree nodes.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLFLATSET_HPP
+#define CPP_FINAL_PROJECT_VLFLATSET_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "VLVector.hpp"
+
+// Sorted keys up to this size are searched linearly, larger ones by binary search:
+#define VLFLAT_LINEAR_THRESHOLD 16
+
+/**
+ * @brief Searches sorted keys, linearly while there are few of them and by binary search
+ * otherwise. Exact lookups of trivially comparable keys ordered by std::less use VLSimd::find,
+ * since for such keys equivalence under the ordering is plain equality.
+ * @tparam K the type of the keys.
+ * @tparam Compare the strict weak ordering of the keys.
+ */
+template<typename K, typename Compare>
+struct VLFlatSearch
+{
+    /**
+     * @brief Tells whether lookups of a given key type may compare keys for equality with SIMD.
+     */
+    template<typename Key>
+    using Simd = std::integral_constant<bool, std::is_same<Key, K>::value &&
+                                              VLTriviallyComparable<K>::value &&
+                                              (std::is_same<Compare, std::less<K>>::value ||
+                                               std::is_same<Compare, std::less<>>::value)>;
+
+    /**
+     * @brief Returns the first key that is not less than a given key.
+     * @param first pointer to the first key.
+     * @param last pointer past the last key.
+     * @param key the key to look for.
+     * @param compare the ordering.
+     * @return a pointer to the first key not less than the given key.
+     */
+    template<typename Key>
+    static const K *lowerBound(const K *first, const K *last, const Key &key, const Compare &compare)
+    {
+        if (last - first <= VLFLAT_LINEAR_THRESHOLD)
+        {
+            while (first != last && compare(*first, key))
+            {
+                ++first;
+            }
+            return first;
+        }
+        return std::lower_bound(first, last, key, compare);
+    }
+
+    /**
+     * @brief Returns the first key that is greater than a given key.
+     * @param first pointer to the first key.
+     * @param last pointer past the last key.
+     * @param key the key to look for.
+     * @param compare the ordering.
+     * @return a pointer to the first key greater than the given key.
+     */
+    template<typename Key>
+    static const K *upperBound(const K *first, const K *last, const Key &key, const Compare &compare)
+    {
+        if (last - first <= VLFLAT_LINEAR_THRESHOLD)
+        {
+            while (first != last && !compare(key, *first))
+            {
+                ++first;
+            }
+            return first;
+        }
+        return std::upper_bound(first, last, key, compare);
+    }
+
+    /**
+     * @brief Finds a key equivalent to a given key.
+     * @param first pointer to the first key.
+     * @param last pointer past the last key.
+     * @param key the key to look for.
+     * @param compare the ordering.
+     * @return a pointer to the equivalent key, or last if there is none.
+     */
+    template<typename Key>
+    static const K *find(const K *first, const K *last, const Key &key, const Compare &compare)
+    {
+        return _find(first, last, key, compare, Simd<Key>());
+    }
+
+private:
+    template<typename Key>
+    static const K *_find(const K *first, const K *last, const Key &key, const Compare &,
+                          std::true_type) noexcept
+    {
+        if (last - first <= VLFLAT_LINEAR_THRESHOLD)
+        {
+            return VLSimd::find<K>(first, last, key);
+        }
+        const K *found = std::lower_bound(first, last, key);
+        return found != last && *found == key ? found : last;
+    }
+
+    template<typename Key>
+    static const K *_find(const K *first, const K *last, const Key &key, const Compare &compare,
+                          std::false_type)
+    {
+        const K *found = lowerBound(first, last, key, compare);
+        return found != last && !compare(key, *found) ? found : last;
+    }
+};
+
+/**
+ * @brief Represents a sorted set of unique keys, stored in a VLVector.
+ * Insertion and removal shift the keys after the position, so the set suits small sets and
+ * sets that are built once and then searched.
+ * @tparam K the type of the keys.
+ * @tparam StaticCapacity the amount of keys stored without allocating.
+ * @tparam Compare the strict weak ordering of the keys; a transparent ordering such as
+ * std::less<> enables lookup by any type comparable with the keys.
+ */
+template<typename K, std::size_t StaticCapacity = DEF_STATIC_CAPACITY, typename Compare = std::less<K>>
+class VLFlatSet
+{
+private:
+    typedef VLFlatSearch<K, Compare> _Search;
+
+    /********************************************************************
+    *                             Class members                         *
+    ********************************************************************/
+
+    VLVector<K, StaticCapacity> _keys;
+    Compare _compare;
+
+    /**
+     * @brief Checks if two keys are equivalent under the ordering.
+     */
+    bool _equivalent(const K &first, const K &second) const
+    {
+        return !_compare(first, second) && !_compare(second, first);
+    }
+
+    /**
+     * @brief Sorts the keys from a given index on, merges them into the sorted keys before it,
+     * and removes duplicates, keeping the first of equivalent keys.
+     * @param sortedSize the amount of sorted unique keys at the beginning.
+     */
+    void _normalize(std::size_t sortedSize)
+    {
+        K *data = _keys.data();
+        std::stable_sort(data + sortedSize, data + _keys.size(), _compare);
+        std::inplace_merge(data, data + sortedSize, data + _keys.size(), _compare);
+        remove_duplicates(_keys, [this](const K &first, const K &second)
+        {
+            return _equivalent(first, second);
+        });
+    }
+
+    /**
+     * @brief Returns an iterator to the key a pointer points to.
+     */
+    typename VLVector<K, StaticCapacity>::const_iterator _at(const K *key) const
+    {
+        return _keys.cbegin() + (key - _keys.data());
+    }
+
+public:
+    typedef K key_type;
+    typedef K value_type;
+    typedef Compare key_compare;
+    typedef typename VLVector<K, StaticCapacity>::const_iterator iterator;
+    typedef typename VLVector<K, StaticCapacity>::const_iterator const_iterator;
+
+    /********************************************************************
+    *                       Rule of 5 methods                           *
+    ********************************************************************/
+
+    /**
+     * @brief Default constructor. Initialises an empty set.
+     * @param compare the ordering of the keys.
+     */
+    explicit VLFlatSet(const Compare &compare = Compare()) : _compare(compare)
+    {
+    }
+
+    /**
+     * @brief Constructs a set of the keys in a given range, which need not be sorted or unique.
+     * The keys are sorted once, and of equivalent keys the first is kept.
+     * @param first an iterator to the first key.
+     * @param last an iterator past the last key.
+     * @param compare the ordering of the keys.
+     */
+    template<typename InputIterator, typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<InputIterator>::iterator_category,
+            std::input_iterator_tag>::value>::type>
+    VLFlatSet(InputIterator first, InputIterator last, const Compare &compare = Compare())
+            : _keys(first, last), _compare(compare)
+    {
+        _normalize(0);
+    }
+
+    /**
+     * @brief Constructs a set of given keys, which need not be sorted or unique.
+     * @param keys the keys.
+     * @param compare the ordering of the keys.
+     */
+    VLFlatSet(std::initializer_list<K> keys, const Compare &compare = Compare())
+            : VLFlatSet(keys.begin(), keys.end(), compare)
+    {
+    }
+
+    /********************************************************************
+    *                            API methods                            *
+    ********************************************************************/
+
+    /**
+     * @brief Returns the number of keys in the set.
+     * @return the number of keys in the set.
+     */
+    std::size_t size() const noexcept
+    {
+        return _keys.size();
+    }
+
+    /**
+     * @brief Checks if the set is empty.
+     * @return true iff the set holds no keys.
+     */
+    bool empty() const noexcept
+    {
+        return _keys.empty();
+    }
+
+    /**
+     * @brief Returns the amount of keys the set can hold before it has to reallocate.
+     * @return the capacity of the set.
+     */
+    std::size_t capacity() const noexcept
+    {
+        return _keys.capacity();
+    }
+
+    /**
+     * @brief Makes sure the set can hold a given amount of keys without reallocating.
+     * @param newCapacity the amount of keys the set should be able to hold.
+     */
+    void reserve(std::size_t newCapacity)
+    {
+        _keys.reserve(newCapacity);
+    }
+
+    /**
+     * @brief Removes all keys from the set.
+     */
+    void clear() noexcept
+    {
+        _keys.clear();
+    }
+
+    /**
+     * @brief Returns the sorted keys.
+     * @return a pointer to the smallest key.
+     */
+    const K *data() const noexcept
+    {
+        return _keys.data();
+    }
+
+    /**
+     * @brief Inserts a key if no equivalent key is in the set.
+     * @param key the key to insert.
+     * @return an iterator to the key in the set, and true iff the key was inserted.
+     */
+    std::pair<iterator, bool> insert(const K &key)
+    {
+        const K *position = _Search::lowerBound(_keys.data(), _keys.data() + _keys.size(), key, _compare);
+        if (position != _keys.data() + _keys.size() && !_compare(key, *position))
+        {
+            return std::make_pair(_at(position), false);
+        }
+        return std::make_pair(iterator(_keys.insert(_at(position), key)), true);
+    }
+
+    /**
+     * @brief Inserts a key if no equivalent key is in the set.
+     * @param key the key to insert.
+     * @return an iterator to the key in the set, and true iff the key was inserted.
+     */
+    std::pair<iterator, bool> insert(K &&key)
+    {
+        const K *position = _Search::lowerBound(_keys.data(), _keys.data() + _keys.size(), key, _compare);
+        if (position != _keys.data() + _keys.size() && !_compare(key, *position))
+        {
+            return std::make_pair(_at(position), false);
+        }
+        return std::make_pair(iterator(_keys.insert(_at(position), std::move(key))), true);
+    }
+
+    /**
+     * @brief Inserts the keys of a range that are not in the set yet.
+     * The new keys are appended, sorted once and merged, instead of inserted one by one.
+     * @param first an iterator to the first key.
+     * @param last an iterator past the last key.
+     */
+    template<typename InputIterator>
+    void insert(InputIterator first, InputIterator last)
+    {
+        const std::size_t sortedSize = _keys.size();
+        _keys.insert(_keys.cend(), first, last);
+        _normalize(sortedSize);
+    }
+
+    /**
+     * @brief Removes the key equivalent to a given key.
+     * @param key the key to remove.
+     * @return the amount of keys that were removed.
+     */
+    std::size_t erase(const K &key)
+    {
+        const_iterator found = find(key);
+        if (found == end())
+        {
+            return 0;
+        }
+        _keys.erase(found);
+        return 1;
+    }
+
+    /**
+     * @brief Removes the key at a given position.
+     * @param position an iterator to the key.
+     * @return an iterator to the key after the removed key.
+     */
+    iterator erase(const_iterator position)
+    {
+        return _keys.erase(position);
+    }
+
+    /**
+     * @brief Finds the key equivalent to a given key.
+     * @param key the key to look for.
+     * @return an iterator to the equivalent key, or end() if there is none.
+     */
+    const_iterator find(const K &key) const
+    {
+        return _at(_Search::find(_keys.data(), _keys.data() + _keys.size(), key, _compare));
+    }
+
+    /**
+     * @brief Finds the key equivalent to a key of another type. Only enabled for transparent
+     * orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return an iterator to the equivalent key, or end() if there is none.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    const_iterator find(const Key &key) const
+    {
+        return _at(_Search::find(_keys.data(), _keys.data() + _keys.size(), key, _compare));
+    }
+
+    /**
+     * @brief Checks if the set holds a key equivalent to a given key.
+     * @param key the key to look for.
+     * @return true iff an equivalent key is in the set.
+     */
+    bool contains(const K &key) const
+    {
+        return find(key) != end();
+    }
+
+    /**
+     * @brief Checks if the set holds a key equivalent to a key of another type. Only enabled
+     * for transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return true iff an equivalent key is in the set.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    bool contains(const Key &key) const
+    {
+        return find(key) != end();
+    }
+
+    /**
+     * @brief Counts the keys equivalent to a given key.
+     * @param key the key to look for.
+     * @return 1 if an equivalent key is in the set, otherwise 0.
+     */
+    std::size_t count(const K &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /**
+     * @brief Counts the keys equivalent to a key of another type. Only enabled for transparent
+     * orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return 1 if an equivalent key is in the set, otherwise 0.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    std::size_t count(const Key &key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    /**
+     * @brief Returns the first key that is not less than a given key.
+     * @param key the key to look for.
+     * @return an iterator to the first key not less than the given key.
+     */
+    const_iterator lower_bound(const K &key) const
+    {
+        return _at(_Search::lowerBound(_keys.data(), _keys.data() + _keys.size(), key, _compare));
+    }
+
+    /**
+     * @brief Returns the first key that is not less than a key of another type. Only enabled
+     * for transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return an iterator to the first key not less than the given key.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    const_iterator lower_bound(const Key &key) const
+    {
+        return _at(_Search::lowerBound(_keys.data(), _keys.data() + _keys.size(), key, _compare));
+    }
+
+    /**
+     * @brief Returns the first key that is greater than a given key.
+     * @param key the key to look for.
+     * @return an iterator to the first key greater than the given key.
+     */
+    const_iterator upper_bound(const K &key) const
+    {
+        return _at(_Search::upperBound(_keys.data(), _keys.data() + _keys.size(), key, _compare));
+    }
+
+    /**
+     * @brief Returns the first key that is greater than a key of another type. Only enabled
+     * for transparent orderings, such as std::less<>.
+     * @param key the key to look for.
+     * @return an iterator to the first key greater than the given key.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    const_iterator upper_bound(const Key &key) const
+    {
+        return _at(_Search::upperBound(_keys.data(), _keys.data() + _keys.size(), key, _compare));
+    }
+
+    /**
+     * @brief Returns the range of keys equivalent to a given key, which holds at most one key.
+     * @param key the key to look for.
+     * @return the lower bound and the upper bound of the key.
+     */
+    std::pair<const_iterator, const_iterator> equal_range(const K &key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    /**
+     * @brief Returns the range of keys equivalent to a key of another type. Only enabled for
+     * transparent orderings, such as std::less<>. The range may hold several keys, since keys
+     * that differ may be equivalent to the key.
+     * @param key the key to look for.
+     * @return the lower bound and the upper bound of the key.
+     */
+    template<typename Key, typename Ordering = Compare, typename = typename Ordering::is_transparent>
+    std::pair<const_iterator, const_iterator> equal_range(const Key &key) const
+    {
+        return std::make_pair(lower_bound(key), upper_bound(key));
+    }
+
+    /**
+     * @brief Checks if this set holds the same keys as another set.
+     * @param other the other set.
+     * @return true iff the sets hold equal keys.
+     */
+    bool operator==(const VLFlatSet &other) const
+    {
+        return _keys == other._keys;
+    }
+
+    /**
+     * @brief Checks if this set differs from another set.
+     * @param other the other set.
+     * @return true iff the sets do not hold equal keys.
+     */
+    bool operator!=(const VLFlatSet &other) const
+    {
+        return _keys != other._keys;
+    }
+
+    /********************************************************************
+    *                       Begin and end iterators                     *
+    ********************************************************************/
+
+    /**
+     * @brief Returns an iterator to the smallest key.
+     * @return an iterator to the beginning of the set.
+     */
+    const_iterator begin() const
+    {
+        return _keys.cbegin();
+    }
+
+    /**
+     * @brief Returns an iterator past the largest key.
+     * @return an iterator to the end of the set.
+     */
+    const_iterator end() const
+    {
+        return _keys.cend();
+    }
+
+    /**
+     * @brief Returns an iterator to the smallest key.
+     * @return an iterator to the beginning of the set.
+     */
+    const_iterator cbegin() const
+    {
+        return _keys.cbegin();
+    }
+
+    /**
+     * @brief Returns an iterator past the largest key.
+     * @return an iterator to the end of the set.
+     */
+    const_iterator cend() const
+    {
+        return _keys.cend();
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLFLATSET_HPP
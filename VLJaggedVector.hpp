@@ -0,0 +1,523 @@
+//
+// A jagged array of many small rows stored in compressed sparse row (CSR) layout: the values
+// of all rows are kept in a single contiguous array, and an offsets array tells where every row
+// starts. Compared to a vector of VLVectors, rows take no unused inline slots, and rows that
+// would have spilled are not scattered over separate heap blocks.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLJAGGEDVECTOR_HPP
+#define CPP_FINAL_PROJECT_VLJAGGEDVECTOR_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "VLVector.hpp"
+#include "VLVectorView.hpp"
+
+/**
+ * @brief Represents a jagged array of rows of values, in CSR layout.
+ * Every row may keep a few unused slots after its values, so values can be pushed to a row
+ * without moving the rows after it. Once the slots of a row run out, the rows after it are
+ * shifted to make room, which costs time linear in the amount of values after the row.
+ * Unused slots hold value initialised values, so T must be default constructible.
+ * @tparam T the type of the values.
+ * @tparam RowSlack the amount of unused slots a new row is given, and at least the amount of
+ * unused slots a row is given when it grows.
+ * @tparam SizeType the type of the offsets, a smaller type (e.g. uint32_t) saves memory when
+ * the amount of values fits in it.
+ */
+template<typename T, std::size_t RowSlack = 0, typename SizeType = std::size_t>
+class VLJaggedVector
+{
+private:
+    static_assert(std::is_default_constructible<T>::value,
+                  "VLJaggedVector values must be default constructible");
+    static_assert(std::is_unsigned<SizeType>::value, "SizeType must be an unsigned type");
+
+    /********************************************************************
+    *                             Class members                         *
+    ********************************************************************/
+
+    // The values of all rows, row after row, each row followed by its unused slots:
+    VLVector<T> _values;
+    // The index of the first slot of every row, followed by the amount of slots:
+    VLVector<SizeType> _offsets;
+    // The amount of values in every row:
+    VLVector<SizeType> _sizes;
+
+    /**
+     * @brief Checks that a row index is valid.
+     * @param row the index of the row.
+     */
+    void _checkRow(std::size_t row) const
+    {
+        if (row >= _sizes.size())
+        {
+            throw std::out_of_range(AT_EXCEPTION_MSG);
+        }
+    }
+
+    /**
+     * @brief Checks that a given amount of slots can be indexed by SizeType.
+     * Throws an exception if it can not.
+     * @param slots the amount of slots.
+     */
+    static void _checkSlots(std::size_t slots)
+    {
+        if (slots > (std::size_t) std::numeric_limits<SizeType>::max())
+        {
+            throw std::length_error(LENGTH_EXCEPTION_MSG);
+        }
+    }
+
+    /**
+     * @brief Returns the amount of slots of a row.
+     * @param row the index of the row.
+     * @return the capacity of the row.
+     */
+    std::size_t _rowCapacity(std::size_t row) const noexcept
+    {
+        return _offsets.data()[row + 1] - _offsets.data()[row];
+    }
+
+    /**
+     * @brief Gives a row more slots by shifting the rows after it.
+     * @param row the index of the row.
+     * @param extra the amount of slots to add.
+     */
+    void _growRow(std::size_t row, std::size_t extra)
+    {
+        _checkSlots(_values.size() + extra);
+        _values.insert(_values.cbegin() + _offsets.data()[row + 1], extra, T());
+        for (std::size_t i = row + 1; i < _offsets.size(); ++i)
+        {
+            _offsets.data()[i] += (SizeType) extra;
+        }
+    }
+
+public:
+    /**
+     * @brief A row of a jagged vector, offering the API of VLVector for reading and changing
+     * its values. A row is invalidated by any change to the amount of values of an earlier row.
+     */
+    class Row
+    {
+    private:
+        VLJaggedVector *_owner;
+        std::size_t _row;
+
+    public:
+        typedef T value_type;
+        typedef T *iterator;
+        typedef const T *const_iterator;
+
+        /**
+         * @brief Constructs a row.
+         * @param owner the jagged vector.
+         * @param row the index of the row.
+         */
+        Row(VLJaggedVector *owner, std::size_t row) noexcept : _owner(owner), _row(row)
+        {
+        }
+
+        /**
+         * @brief Returns a read-only view of the values of the row.
+         * @return a view of the row.
+         */
+        operator VLVectorView<T>() const noexcept
+        {
+            return VLVectorView<T>(data(), size());
+        }
+
+        std::size_t size() const noexcept
+        {
+            return _owner->_sizes.data()[_row];
+        }
+
+        bool empty() const noexcept
+        {
+            return size() == 0;
+        }
+
+        /**
+         * @brief Returns the amount of values the row can hold without shifting the rows after it.
+         * @return the capacity of the row.
+         */
+        std::size_t capacity() const noexcept
+        {
+            return _owner->_rowCapacity(_row);
+        }
+
+        T *data() const noexcept
+        {
+            return _owner->_values.data() + _owner->_offsets.data()[_row];
+        }
+
+        T &operator[](std::size_t index) const noexcept
+        {
+            return data()[index];
+        }
+
+        /**
+         * @brief Gets an index and returns a reference to the value associated to it.
+         * Throws an exception if the index was not found.
+         * @param index the index of the value in the row.
+         * @return a reference to the value that is associated to the index.
+         */
+        T &at(std::size_t index) const
+        {
+            if (index >= size())
+            {
+                throw std::out_of_range(AT_EXCEPTION_MSG);
+            }
+            return data()[index];
+        }
+
+        iterator begin() const noexcept
+        {
+            return data();
+        }
+
+        iterator end() const noexcept
+        {
+            return data() + size();
+        }
+
+        iterator find(const T &val) const
+        {
+            const T *hit = VLSimd::find<T>(begin(), end(), val);
+            return begin() + (hit - begin());
+        }
+
+        bool contains(const T &val) const
+        {
+            return find(val) != end();
+        }
+
+        std::size_t count(const T &val) const
+        {
+            return VLSimd::count<T>(begin(), end(), val);
+        }
+
+        /**
+         * @brief Appends a value to the row.
+         * @param val the value to append.
+         */
+        void push_back(const T &val)
+        {
+            _owner->push_back(_row, val);
+        }
+
+        /**
+         * @brief Removes the last value of the row.
+         */
+        void pop_back()
+        {
+            _owner->pop_back(_row);
+        }
+    };
+
+    /********************************************************************
+    *                       Rule of 5 methods                           *
+    ********************************************************************/
+
+    /**
+     * @brief Default constructor. Initialises a jagged vector without rows.
+     */
+    VLJaggedVector() : _offsets{0}
+    {
+    }
+
+    /**
+     * @brief Constructs a jagged vector with a copy of every row of a given range of rows,
+     * e.g. a range of VLVectors. The storage is allocated once.
+     * @tparam ForwardIterator an iterator over rows, which have begin(), end() and size().
+     * @param first an iterator to the first row.
+     * @param last an iterator past the last row.
+     */
+    template<typename ForwardIterator, typename = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<ForwardIterator>::iterator_category,
+            std::forward_iterator_tag>::value>::type>
+    VLJaggedVector(ForwardIterator first, ForwardIterator last) : VLJaggedVector()
+    {
+        std::size_t rows = 0;
+        std::size_t values = 0;
+        for (ForwardIterator it = first; it != last; ++it)
+        {
+            ++rows;
+            values += it->size() + RowSlack;
+        }
+        reserve(rows, values);
+        for (; first != last; ++first)
+        {
+            push_row(first->begin(), first->end());
+        }
+    }
+
+    /**
+     * @brief Constructs a jagged vector with a copy of every given row.
+     * @param rows the rows.
+     */
+    VLJaggedVector(std::initializer_list<std::initializer_list<T>> rows)
+            : VLJaggedVector(rows.begin(), rows.end())
+    {
+    }
+
+    /********************************************************************
+    *                            API methods                            *
+    ********************************************************************/
+
+    /**
+     * @brief Returns the number of rows.
+     * @return the number of rows.
+     */
+    std::size_t size() const noexcept
+    {
+        return _sizes.size();
+    }
+
+    /**
+     * @brief Checks if the jagged vector has no rows.
+     * @return true iff there are no rows.
+     */
+    bool empty() const noexcept
+    {
+        return _sizes.empty();
+    }
+
+    /**
+     * @brief Returns the number of slots of all rows, used or not.
+     * @return the size of the value array.
+     */
+    std::size_t value_capacity() const noexcept
+    {
+        return _values.size();
+    }
+
+    /**
+     * @brief Makes room for a given amount of rows and slots without reallocating.
+     * @param rows the amount of rows.
+     * @param values the amount of slots of all rows.
+     */
+    void reserve(std::size_t rows, std::size_t values)
+    {
+        _offsets.reserve(rows + 1);
+        _sizes.reserve(rows);
+        _values.reserve(values);
+    }
+
+    /**
+     * @brief Appends an empty row, with RowSlack unused slots.
+     * Throws an exception if the slots of all rows would not fit in SizeType.
+     * @return the new row.
+     */
+    Row push_row()
+    {
+        _checkSlots(_values.size() + RowSlack);
+        _sizes.push_back(0);
+        try
+        {
+            _values.resize(_values.size() + RowSlack);
+            _offsets.push_back((SizeType) _values.size());
+        }
+        catch (...)
+        {
+            _values.resize(_offsets.data()[_offsets.size() - 1]);
+            _sizes.pop_back();
+            throw;
+        }
+        return Row(this, _sizes.size() - 1);
+    }
+
+    /**
+     * @brief Appends a row with a copy of a given range of values, followed by RowSlack unused
+     * slots.
+     * Throws an exception if the slots of all rows would not fit in SizeType.
+     * @param first an iterator to the first value.
+     * @param last an iterator past the last value.
+     * @return the new row.
+     */
+    template<typename InputIterator>
+    Row push_row(InputIterator first, InputIterator last)
+    {
+        const std::size_t start = _values.size();
+        try
+        {
+            _values.insert(_values.cend(), first, last);
+            const std::size_t rowSize = _values.size() - start;
+            _checkSlots(_values.size() + RowSlack);
+            _values.resize(_values.size() + RowSlack);
+            _sizes.push_back((SizeType) rowSize);
+            _offsets.push_back((SizeType) _values.size());
+        }
+        catch (...)
+        {
+            _values.resize(start);
+            _sizes.resize(_offsets.size() - 1);
+            throw;
+        }
+        return Row(this, _sizes.size() - 1);
+    }
+
+    /**
+     * @brief Appends a row with a copy of given values.
+     * @param values the values.
+     * @return the new row.
+     */
+    Row push_row(std::initializer_list<T> values)
+    {
+        return push_row(values.begin(), values.end());
+    }
+
+    /**
+     * @brief Removes the last row.
+     */
+    void pop_row()
+    {
+        if (!empty())
+        {
+            _offsets.pop_back();
+            _sizes.pop_back();
+            _values.resize(_offsets.data()[_offsets.size() - 1]);
+        }
+    }
+
+    /**
+     * @brief Appends a value to a row. Uses an unused slot of the row if there is one, and
+     * otherwise grows the row by the growth policy of VLVector, or by RowSlack if that is larger.
+     * Throws an exception if the slots of all rows would not fit in SizeType.
+     * @param row the index of the row.
+     * @param val the value to append.
+     */
+    void push_back(std::size_t row, const T &val)
+    {
+        _checkRow(row);
+        const std::size_t rowSize = _sizes.data()[row];
+        if (rowSize == _rowCapacity(row))
+        {
+            // val may be a value of this container, so it is copied before the values move:
+            T copy(val);
+            const std::size_t grown = std::max<std::size_t>(VLDefaultGrowthPolicy::grow(rowSize + 1),
+                                                            rowSize + RowSlack + 1);
+            _growRow(row, grown - rowSize);
+            _values.data()[_offsets.data()[row] + rowSize] = std::move(copy);
+        }
+        else
+        {
+            _values.data()[_offsets.data()[row] + rowSize] = val;
+        }
+        ++_sizes.data()[row];
+    }
+
+    /**
+     * @brief Removes the last value of a row, leaving its slot unused.
+     * @param row the index of the row.
+     */
+    void pop_back(std::size_t row)
+    {
+        _checkRow(row);
+        if (_sizes.data()[row] > 0)
+        {
+            --_sizes.data()[row];
+            _values.data()[_offsets.data()[row] + _sizes.data()[row]] = T();
+        }
+    }
+
+    /**
+     * @brief Removes all rows.
+     */
+    void clear() noexcept
+    {
+        _values.clear();
+        _sizes.clear();
+        _offsets.clear();
+        _offsets.push_back(0);
+    }
+
+    /**
+     * @brief Removes the unused slots of all rows, packing the values of all rows together.
+     */
+    void shrink_to_fit()
+    {
+        std::size_t packed = 0;
+        for (std::size_t row = 0; row < size(); ++row)
+        {
+            const std::size_t start = _offsets.data()[row];
+            std::move(_values.begin() + start, _values.begin() + start + _sizes.data()[row],
+                      _values.begin() + packed);
+            _offsets.data()[row] = (SizeType) packed;
+            packed += _sizes.data()[row];
+        }
+        _offsets.data()[size()] = (SizeType) packed;
+        _values.resize(packed);
+        _values.shrink_to_fit();
+    }
+
+    /**
+     * @brief Returns a row.
+     * @param row the index of the row.
+     * @return the row.
+     */
+    Row operator[](std::size_t row) noexcept
+    {
+        return Row(this, row);
+    }
+
+    /**
+     * @brief Returns a read-only view of a row.
+     * @param row the index of the row.
+     * @return a view of the row.
+     */
+    VLVectorView<T> operator[](std::size_t row) const noexcept
+    {
+        return VLVectorView<T>(_values.data() + _offsets.data()[row], _sizes.data()[row]);
+    }
+
+    /**
+     * @brief Returns a row.
+     * Throws an exception if the index was not found.
+     * @param row the index of the row.
+     * @return the row.
+     */
+    Row at(std::size_t row)
+    {
+        _checkRow(row);
+        return Row(this, row);
+    }
+
+    /**
+     * @brief Returns a read-only view of a row.
+     * Throws an exception if the index was not found.
+     * @param row the index of the row.
+     * @return a view of the row.
+     */
+    VLVectorView<T> at(std::size_t row) const
+    {
+        _checkRow(row);
+        return (*this)[row];
+    }
+
+    /**
+     * @brief Returns the value array, in which row i starts at offsets()[i].
+     * @return a pointer to the first slot.
+     */
+    const T *values() const noexcept
+    {
+        return _values.data();
+    }
+
+    /**
+     * @brief Returns the offsets array, which holds size() + 1 offsets.
+     * @return a pointer to the first offset.
+     */
+    const SizeType *offsets() const noexcept
+    {
+        return _offsets.data();
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLJAGGEDVECTOR_HPP
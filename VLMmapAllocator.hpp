@@ -0,0 +1,382 @@
+//
+// An allocator that places very large VLVector heap storage in memory mappings.
+// Blocks below a threshold come from the global heap as usual. Larger blocks are mapped
+// anonymously, or in an unlinked temporary file for data that should be paged to disk instead
+// of swap, and grow with mremap: the kernel moves the pages instead of copying the elements,
+// so growing does not need the old and the new storage at the same time. data() stays contiguous.
+//
+// The mapping path is Linux only; elsewhere the allocator falls back to the global heap.
+//
+// Usage: VLMappedVector<T, StaticCapacity> vec(VLMmapAllocator<T>(VLMmapOptions(...)));
+//
+
+#ifndef CPP_FINAL_PROJECT_VLMMAPALLOCATOR_HPP
+#define CPP_FINAL_PROJECT_VLMMAPALLOCATOR_HPP
+
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <string>
+#include <type_traits>
+#include "VLVector.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstdlib>
+#include <sys/mman.h>
+#include <unistd.h>
+#define VLMMAP_SUPPORTED
+#endif
+
+#define VLMMAP_DEF_THRESHOLD (64 * 1024 * 1024)
+
+/**
+ * @brief How a VLMmapAllocator places its blocks.
+ */
+struct VLMmapOptions
+{
+    // Blocks of at least this many bytes are mapped, smaller blocks come from the global heap:
+    std::size_t threshold;
+    // A directory for file-backed mappings, or empty for anonymous mappings:
+    std::string directory;
+    // Advises the kernel that the mapping is accessed sequentially (read-ahead, early reclaim):
+    bool sequential;
+
+    /**
+     * @brief Constructs the options.
+     * @param threshold the smallest block size in bytes that is mapped.
+     * @param directory a directory for file-backed mappings, or empty for anonymous mappings.
+     * @param sequential whether to advise the kernel of sequential access.
+     */
+    explicit VLMmapOptions(std::size_t threshold = VLMMAP_DEF_THRESHOLD, std::string directory = "",
+                           bool sequential = true)
+            : threshold(threshold), directory(std::move(directory)), sequential(sequential)
+    {
+    }
+};
+
+/**
+ * @brief The mapping functions behind VLMmapAllocator, independent of the value type.
+ * Every mapping starts with a header page that records its length and its backing file, and
+ * the block handed out starts right after it.
+ */
+class VLMmapRegion
+{
+private:
+#ifdef VLMMAP_SUPPORTED
+    /**
+     * @brief The header at the start of a mapping.
+     */
+    struct _Header
+    {
+        std::size_t length;
+        int fd;
+    };
+
+    /**
+     * @brief Returns the size of a page, which is also the size of the header.
+     */
+    static std::size_t _pageSize() noexcept
+    {
+        static const std::size_t pageSize = (std::size_t) sysconf(_SC_PAGESIZE);
+        return pageSize;
+    }
+
+    /**
+     * @brief Returns the length of a mapping holding a block of a given size.
+     */
+    static std::size_t _length(std::size_t bytes) noexcept
+    {
+        const std::size_t page = _pageSize();
+        return page + (bytes + page - 1) / page * page;
+    }
+
+    /**
+     * @brief Returns the header of the mapping of a block.
+     */
+    static _Header *_header(void *block) noexcept
+    {
+        return reinterpret_cast<_Header *>(static_cast<unsigned char *>(block) - _pageSize());
+    }
+
+    /**
+     * @brief Creates an unlinked temporary file in a directory.
+     * @param directory the directory.
+     * @return the descriptor of the file, or -1 on failure.
+     */
+    static int _createFile(const std::string &directory)
+    {
+        std::string path = directory + "/VLVector.XXXXXX";
+        const int fd = mkstemp(&path[0]);
+        if (fd != -1)
+        {
+            unlink(path.c_str());
+        }
+        return fd;
+    }
+
+    /**
+     * @brief Applies the access advice to a mapping.
+     */
+    static void _advise(void *base, std::size_t length, const VLMmapOptions &options) noexcept
+    {
+        if (options.sequential)
+        {
+            // Advice is a hint, so a failure is ignored:
+            (void) madvise(base, length, MADV_SEQUENTIAL);
+        }
+    }
+#endif
+
+public:
+    /**
+     * @brief Tells whether blocks of a given size are mapped.
+     * @param bytes the size of the block.
+     * @param options the options of the allocator.
+     * @return true iff the block is mapped rather than allocated on the global heap.
+     */
+    static bool isMapped(std::size_t bytes, const VLMmapOptions &options) noexcept
+    {
+#ifdef VLMMAP_SUPPORTED
+        return bytes >= options.threshold;
+#else
+        (void) bytes;
+        (void) options;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Maps a block of a given size.
+     * Throws std::bad_alloc if the mapping or its backing file cannot be created.
+     * @param bytes the size of the block.
+     * @param options the options of the allocator.
+     * @return a pointer to the block, aligned to a page.
+     */
+    static void *map(std::size_t bytes, const VLMmapOptions &options)
+    {
+#ifdef VLMMAP_SUPPORTED
+        const std::size_t length = _length(bytes);
+        int fd = -1;
+        void *base;
+        if (options.directory.empty())
+        {
+            base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        else
+        {
+            fd = _createFile(options.directory);
+            if (fd == -1 || ftruncate(fd, (off_t) length) != 0)
+            {
+                if (fd != -1)
+                {
+                    close(fd);
+                }
+                throw std::bad_alloc();
+            }
+            base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        if (base == MAP_FAILED)
+        {
+            if (fd != -1)
+            {
+                close(fd);
+            }
+            throw std::bad_alloc();
+        }
+        _advise(base, length, options);
+        _Header *header = static_cast<_Header *>(base);
+        header->length = length;
+        header->fd = fd;
+        return static_cast<unsigned char *>(base) + _pageSize();
+#else
+        (void) options;
+        return ::operator new(bytes);
+#endif
+    }
+
+    /**
+     * @brief Resizes the mapping of a block, keeping its bytes. The kernel may move the pages
+     * to another address, but never copies them.
+     * @param block the block, which must have been mapped.
+     * @param bytes the new size of the block.
+     * @param options the options of the allocator.
+     * @return a pointer to the resized block, or nullptr if it could not be resized, in which
+     * case the block is left as it was.
+     */
+    static void *remap(void *block, std::size_t bytes, const VLMmapOptions &options) noexcept
+    {
+#ifdef VLMMAP_SUPPORTED
+        _Header *header = _header(block);
+        const std::size_t oldLength = header->length;
+        const std::size_t length = _length(bytes);
+        const int fd = header->fd;
+        if (fd != -1 && length > oldLength && ftruncate(fd, (off_t) length) != 0)
+        {
+            return nullptr;
+        }
+        void *base = mremap(header, oldLength, length, MREMAP_MAYMOVE);
+        if (base == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        if (fd != -1 && length < oldLength)
+        {
+            // Releases the disk space of the pages that were unmapped:
+            (void) ftruncate(fd, (off_t) length);
+        }
+        _advise(base, length, options);
+        static_cast<_Header *>(base)->length = length;
+        return static_cast<unsigned char *>(base) + _pageSize();
+#else
+        (void) block;
+        (void) bytes;
+        (void) options;
+        return nullptr;
+#endif
+    }
+
+    /**
+     * @brief Unmaps a block, closing its backing file.
+     * @param block the block, which must have been mapped.
+     */
+    static void unmap(void *block) noexcept
+    {
+#ifdef VLMMAP_SUPPORTED
+        _Header *header = _header(block);
+        const int fd = header->fd;
+        munmap(header, header->length);
+        if (fd != -1)
+        {
+            close(fd);
+        }
+#else
+        ::operator delete(block);
+#endif
+    }
+};
+
+/**
+ * @brief An allocator that maps blocks of at least a threshold size and grows them in place.
+ * VLVector detects the reallocate method and uses it when growing heap storage of trivially
+ * relocatable elements, instead of allocating new storage and relocating the elements.
+ * Instances with the same threshold may release each other's blocks, since the threshold tells
+ * whether a block was mapped.
+ * @tparam T the type of values to allocate.
+ */
+template<typename T>
+class VLMmapAllocator
+{
+private:
+    template<typename> friend class VLMmapAllocator;
+
+    VLMmapOptions _options;
+
+public:
+    typedef T value_type;
+    typedef std::false_type is_always_equal;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    /**
+     * @brief Constructs an allocator.
+     * @param options how to place the blocks.
+     */
+    explicit VLMmapAllocator(VLMmapOptions options = VLMmapOptions()) : _options(std::move(options))
+    {
+    }
+
+    /**
+     * @brief Converts an allocator of another type, keeping its options.
+     */
+    template<typename U>
+    VLMmapAllocator(const VLMmapAllocator<U> &other) : _options(other._options)
+    {
+    }
+
+    /**
+     * @brief Returns the options of the allocator.
+     * @return the options.
+     */
+    const VLMmapOptions &options() const noexcept
+    {
+        return _options;
+    }
+
+    /**
+     * @brief Allocates storage for a given amount of values.
+     * @param count the amount of values.
+     * @return a pointer to the storage.
+     */
+    T *allocate(std::size_t count)
+    {
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        const std::size_t bytes = count * sizeof(T);
+        if (VLMmapRegion::isMapped(bytes, _options))
+        {
+            return static_cast<T *>(VLMmapRegion::map(bytes, _options));
+        }
+        return static_cast<T *>(::operator new(bytes));
+    }
+
+    /**
+     * @brief Releases storage that was allocated for a given amount of values.
+     * @param storage the storage.
+     * @param count the amount of values the storage was allocated for.
+     */
+    void deallocate(T *storage, std::size_t count) noexcept
+    {
+        if (VLMmapRegion::isMapped(count * sizeof(T), _options))
+        {
+            VLMmapRegion::unmap(storage);
+        }
+        else
+        {
+            ::operator delete(storage);
+        }
+    }
+
+    /**
+     * @brief Resizes storage without copying its bytes, if both the old and the new size are
+     * mapped.
+     * @param storage the storage.
+     * @param oldCount the amount of values the storage was allocated for.
+     * @param newCount the amount of values the storage should fit.
+     * @return the resized storage, or nullptr if the storage was left as it was and the caller
+     * should allocate new storage instead.
+     */
+    T *reallocate(T *storage, std::size_t oldCount, std::size_t newCount) noexcept
+    {
+        if (newCount > std::numeric_limits<std::size_t>::max() / sizeof(T) ||
+            !VLMmapRegion::isMapped(oldCount * sizeof(T), _options) ||
+            !VLMmapRegion::isMapped(newCount * sizeof(T), _options))
+        {
+            return nullptr;
+        }
+        return static_cast<T *>(VLMmapRegion::remap(storage, newCount * sizeof(T), _options));
+    }
+
+    template<typename U>
+    bool operator==(const VLMmapAllocator<U> &other) const noexcept
+    {
+        return _options.threshold == other._options.threshold;
+    }
+
+    template<typename U>
+    bool operator!=(const VLMmapAllocator<U> &other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief A VLVector whose heap storage is mapped once it reaches the threshold of its allocator.
+ */
+template<typename T, std::size_t StaticCapacity = DEF_STATIC_CAPACITY>
+using VLMappedVector = VLVector<T, StaticCapacity, VLDefaultGrowthPolicy, VLMmapAllocator<T>>;
+
+#endif //CPP_FINAL_PROJECT_VLMMAPALLOCATOR_HPP
@@ -0,0 +1,562 @@
+//
+// Parallel bulk algorithms for large VLVectors - for_each, transform, reduce, sort and
+// compact - running on a work-stealing thread pool.
+// Vectors smaller than a tunable threshold (which includes every vector still in stack mode,
+// unless the threshold is set below its static capacity) run the plain sequential algorithm
+// inline, so the pool is only involved where splitting the work pays for it.
+// The algorithms take any vector with data() and size(), e.g. VLVector or std::vector.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLPARALLEL_HPP
+#define CPP_FINAL_PROJECT_VLPARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#define VLPARALLEL_DEF_THRESHOLD (1 << 16)
+#define VLPARALLEL_MIN_GRAIN 4096
+#define VLPARALLEL_CHUNKS_PER_THREAD 4
+
+/**
+ * @brief A fixed set of worker threads, each with its own task deque.
+ * Workers take their own newest tasks first and steal the oldest tasks of other workers when
+ * they run out, and a thread waiting for a task group runs tasks instead of blocking, so tasks
+ * may themselves split work without deadlocking the pool.
+ */
+class VLWorkStealingPool
+{
+private:
+    /**
+     * @brief The task deque of a single worker.
+     */
+    struct _Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<_Queue>> _queues;
+    std::vector<std::thread> _threads;
+    std::atomic<std::size_t> _pending;
+    std::atomic<std::size_t> _nextQueue;
+    std::atomic<bool> _stop;
+    std::mutex _sleepMutex;
+    std::condition_variable _wake;
+
+    /**
+     * @brief Returns the pool the calling thread works for, and its queue in that pool.
+     */
+    static std::pair<const VLWorkStealingPool *, std::size_t> &_current() noexcept
+    {
+        static thread_local std::pair<const VLWorkStealingPool *, std::size_t> current(nullptr, 0);
+        return current;
+    }
+
+    /**
+     * @brief Takes a task, first from the back of a given queue and then from the front of the
+     * other queues.
+     * @param own the queue to take from first.
+     * @param task set to the task that was taken.
+     * @return true iff a task was taken.
+     */
+    bool _take(std::size_t own, std::function<void()> &task)
+    {
+        if (own < _queues.size())
+        {
+            _Queue &queue = *_queues[own];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        for (std::size_t i = 0; i < _queues.size(); ++i)
+        {
+            _Queue &queue = *_queues[(own + 1 + i) % _queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                _pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief The loop of a worker thread: runs tasks until the pool is destroyed.
+     * @param index the index of the queue of the worker.
+     */
+    void _work(std::size_t index)
+    {
+        _current() = std::make_pair(this, index);
+        std::function<void()> task;
+        while (true)
+        {
+            if (_take(index, task))
+            {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _wake.wait(lock, [this]
+            {
+                return _stop.load() || _pending.load() > 0;
+            });
+            if (_stop.load() && _pending.load() == 0)
+            {
+                return;
+            }
+        }
+    }
+
+public:
+    /**
+     * @brief Constructs a pool.
+     * @param concurrency the amount of threads that run tasks, including the thread that waits
+     * for them, so a pool of concurrency 1 runs every task on the waiting thread.
+     */
+    explicit VLWorkStealingPool(std::size_t concurrency = std::thread::hardware_concurrency())
+            : _pending(0), _nextQueue(0), _stop(false)
+    {
+        const std::size_t workers = concurrency > 1 ? concurrency - 1 : 0;
+        for (std::size_t i = 0; i < workers; ++i)
+        {
+            _queues.emplace_back(new _Queue);
+        }
+        for (std::size_t i = 0; i < workers; ++i)
+        {
+            _threads.emplace_back(&VLWorkStealingPool::_work, this, i);
+        }
+    }
+
+    VLWorkStealingPool(const VLWorkStealingPool &) = delete;
+
+    VLWorkStealingPool &operator=(const VLWorkStealingPool &) = delete;
+
+    /**
+     * @brief Runs the remaining tasks and joins the worker threads.
+     */
+    ~VLWorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _stop.store(true);
+        }
+        _wake.notify_all();
+        for (std::thread &thread : _threads)
+        {
+            thread.join();
+        }
+    }
+
+    /**
+     * @brief Returns the shared pool, with a thread per hardware thread.
+     * @return the shared pool.
+     */
+    static VLWorkStealingPool &instance()
+    {
+        static VLWorkStealingPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Returns the amount of threads that run tasks, including the waiting thread.
+     * @return the concurrency of the pool.
+     */
+    std::size_t concurrency() const noexcept
+    {
+        return _threads.size() + 1;
+    }
+
+    /**
+     * @brief Submits a task. A worker of the pool pushes it on its own queue, other threads
+     * spread their tasks over the queues.
+     * @param task the task.
+     */
+    void submit(std::function<void()> task)
+    {
+        if (_queues.empty())
+        {
+            task();
+            return;
+        }
+        const std::pair<const VLWorkStealingPool *, std::size_t> &current = _current();
+        const std::size_t index = current.first == this
+                                  ? current.second
+                                  : _nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+        // Counted before it is queued, so a worker that takes it never sees the count drop below 0:
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        {
+            std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+            _queues[index]->tasks.push_back(std::move(task));
+        }
+        _wake.notify_one();
+    }
+
+    /**
+     * @brief Runs a single pending task on the calling thread, if there is one.
+     * @return true iff a task was run.
+     */
+    bool runPending()
+    {
+        const std::pair<const VLWorkStealingPool *, std::size_t> &current = _current();
+        std::function<void()> task;
+        if (!_take(current.first == this ? current.second : 0, task))
+        {
+            return false;
+        }
+        task();
+        return true;
+    }
+};
+
+/**
+ * @brief A set of tasks submitted to a pool and waited for together.
+ * The first exception a task throws is rethrown by wait.
+ */
+class VLTaskGroup
+{
+private:
+    VLWorkStealingPool &_pool;
+    std::atomic<std::size_t> _remaining;
+    std::exception_ptr _error;
+    std::mutex _errorMutex;
+
+public:
+    /**
+     * @brief Constructs an empty group.
+     * @param pool the pool to run the tasks on.
+     */
+    explicit VLTaskGroup(VLWorkStealingPool &pool) : _pool(pool), _remaining(0)
+    {
+    }
+
+    VLTaskGroup(const VLTaskGroup &) = delete;
+
+    VLTaskGroup &operator=(const VLTaskGroup &) = delete;
+
+    /**
+     * @brief Waits for the tasks, so they never outlive the group.
+     */
+    ~VLTaskGroup()
+    {
+        try
+        {
+            wait();
+        }
+        catch (...)
+        {
+            // Only reached while another exception unwinds the owner of the group.
+        }
+    }
+
+    /**
+     * @brief Submits a task.
+     * @param task the task, which must stay valid until wait returns.
+     */
+    template<typename Task>
+    void run(Task task)
+    {
+        _remaining.fetch_add(1, std::memory_order_relaxed);
+        _pool.submit([this, task]()
+                     {
+                         try
+                         {
+                             task();
+                         }
+                         catch (...)
+                         {
+                             std::lock_guard<std::mutex> lock(_errorMutex);
+                             if (!_error)
+                             {
+                                 _error = std::current_exception();
+                             }
+                         }
+                         _remaining.fetch_sub(1, std::memory_order_release);
+                     });
+    }
+
+    /**
+     * @brief Runs pending tasks of the pool until all tasks of the group finished.
+     * Rethrows the first exception a task threw.
+     */
+    void wait()
+    {
+        while (_remaining.load(std::memory_order_acquire) > 0)
+        {
+            if (!_pool.runPending())
+            {
+                std::this_thread::yield();
+            }
+        }
+        if (_error)
+        {
+            std::exception_ptr error = _error;
+            _error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+/**
+ * @brief Parallel algorithms over the elements of a vector.
+ * Every algorithm runs sequentially when the vector is smaller than threshold() or the pool
+ * has a single thread.
+ */
+struct VLParallel
+{
+private:
+    /**
+     * @brief Returns the threshold.
+     */
+    static std::atomic<std::size_t> &_threshold() noexcept
+    {
+        static std::atomic<std::size_t> threshold(VLPARALLEL_DEF_THRESHOLD);
+        return threshold;
+    }
+
+    /**
+     * @brief Returns the amount of chunks to split a given amount of elements into.
+     * @param size the amount of elements.
+     * @param pool the pool to run on.
+     * @return the amount of chunks, 1 if the elements should be processed sequentially.
+     */
+    static std::size_t _chunks(std::size_t size, const VLWorkStealingPool &pool) noexcept
+    {
+        if (size < threshold() || pool.concurrency() == 1)
+        {
+            return 1;
+        }
+        const std::size_t byGrain = (size + VLPARALLEL_MIN_GRAIN - 1) / VLPARALLEL_MIN_GRAIN;
+        return std::max<std::size_t>(1, std::min(pool.concurrency() * VLPARALLEL_CHUNKS_PER_THREAD,
+                                                 byGrain));
+    }
+
+    /**
+     * @brief Returns the index of the first element of a chunk.
+     */
+    static std::size_t _chunkBegin(std::size_t chunk, std::size_t chunks, std::size_t size) noexcept
+    {
+        return size / chunks * chunk + std::min(chunk, size % chunks);
+    }
+
+    /**
+     * @brief Calls a function with the bounds of every chunk, on the pool.
+     * @param chunks the amount of chunks.
+     * @param size the amount of elements.
+     * @param pool the pool to run on.
+     * @param body the function, called with the index of the chunk and its first and last index.
+     */
+    template<typename Body>
+    static void _forChunks(std::size_t chunks, std::size_t size, VLWorkStealingPool &pool,
+                           const Body &body)
+    {
+        VLTaskGroup group(pool);
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            group.run([&body, chunk, chunks, size]()
+                      {
+                          body(chunk, _chunkBegin(chunk, chunks, size), _chunkBegin(chunk + 1, chunks, size));
+                      });
+        }
+        // The calling thread takes the first chunk instead of waiting idle:
+        body(0, 0, _chunkBegin(1, chunks, size));
+        group.wait();
+    }
+
+public:
+    /**
+     * @brief Returns the size from which the algorithms run in parallel.
+     * @return the threshold in elements.
+     */
+    static std::size_t threshold() noexcept
+    {
+        return _threshold().load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sets the size from which the algorithms run in parallel.
+     * @param threshold the threshold in elements.
+     */
+    static void setThreshold(std::size_t threshold) noexcept
+    {
+        _threshold().store(threshold, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Calls a function on every element.
+     * @param vec the vector.
+     * @param function the function, called with a reference to an element.
+     * @param pool the pool to run on.
+     */
+    template<typename Vector, typename Function>
+    static void for_each(Vector &vec, Function function,
+                         VLWorkStealingPool &pool = VLWorkStealingPool::instance())
+    {
+        auto *data = vec.data();
+        const std::size_t size = vec.size();
+        _forChunks(_chunks(size, pool), size, pool, [data, &function](std::size_t, std::size_t first,
+                                                                        std::size_t last)
+        {
+            std::for_each(data + first, data + last, function);
+        });
+    }
+
+    /**
+     * @brief Stores the result of a function on every element of a vector in another vector,
+     * which is resized to the size of the first. The vectors may be the same vector.
+     * @param in the input vector.
+     * @param out the output vector.
+     * @param function the function, called with a const reference to an element.
+     * @param pool the pool to run on.
+     */
+    template<typename InVector, typename OutVector, typename Function>
+    static void transform(const InVector &in, OutVector &out, Function function,
+                          VLWorkStealingPool &pool = VLWorkStealingPool::instance())
+    {
+        const std::size_t size = in.size();
+        out.resize(size);
+        const auto *source = in.data();
+        auto *dest = out.data();
+        _forChunks(_chunks(size, pool), size, pool, [source, dest, &function](std::size_t,
+                                                                              std::size_t first,
+                                                                              std::size_t last)
+        {
+            std::transform(source + first, source + last, dest + first, function);
+        });
+    }
+
+    /**
+     * @brief Combines the elements with an associative operation, in order.
+     * @param vec the vector.
+     * @param init the value to combine the elements into.
+     * @param operation the associative operation.
+     * @param pool the pool to run on.
+     * @return init combined with all elements.
+     */
+    template<typename Vector, typename Value, typename Operation>
+    static Value reduce(const Vector &vec, Value init, Operation operation,
+                        VLWorkStealingPool &pool = VLWorkStealingPool::instance())
+    {
+        const auto *data = vec.data();
+        const std::size_t size = vec.size();
+        const std::size_t chunks = _chunks(size, pool);
+        if (chunks == 1)
+        {
+            return std::accumulate(data, data + size, std::move(init), operation);
+        }
+        std::vector<Value> partials(chunks, init);
+        _forChunks(chunks, size, pool, [data, &operation, &partials](std::size_t chunk,
+                                                                     std::size_t first,
+                                                                     std::size_t last)
+        {
+            Value partial(data[first]);
+            partials[chunk] = std::accumulate(data + first + 1, data + last, std::move(partial), operation);
+        });
+        for (Value &partial : partials)
+        {
+            init = operation(std::move(init), std::move(partial));
+        }
+        return init;
+    }
+
+    /**
+     * @brief Sorts the elements: the chunks are sorted in parallel and then merged in pairs,
+     * each round of merges running in parallel.
+     * @param vec the vector.
+     * @param compare the strict weak ordering to sort by.
+     * @param pool the pool to run on.
+     */
+    template<typename Vector, typename Compare = std::less<typename Vector::value_type>>
+    static void sort(Vector &vec, Compare compare = Compare(),
+                     VLWorkStealingPool &pool = VLWorkStealingPool::instance())
+    {
+        auto *data = vec.data();
+        const std::size_t size = vec.size();
+        const std::size_t chunks = _chunks(size, pool);
+        _forChunks(chunks, size, pool, [data, &compare](std::size_t, std::size_t first, std::size_t last)
+        {
+            std::sort(data + first, data + last, compare);
+        });
+        for (std::size_t width = 1; width < chunks; width *= 2)
+        {
+            const std::size_t merges = (chunks + 2 * width - 1) / (2 * width);
+            VLTaskGroup group(pool);
+            for (std::size_t merge = 0; merge < merges; ++merge)
+            {
+                const std::size_t left = merge * 2 * width;
+                if (left + width >= chunks)
+                {
+                    continue;
+                }
+                const std::size_t middle = _chunkBegin(left + width, chunks, size);
+                const std::size_t last = _chunkBegin(std::min(left + 2 * width, chunks), chunks, size);
+                const std::size_t first = _chunkBegin(left, chunks, size);
+                group.run([data, first, middle, last, &compare]()
+                          {
+                              std::inplace_merge(data + first, data + middle, data + last, compare);
+                          });
+            }
+            group.wait();
+        }
+    }
+
+    /**
+     * @brief Removes the elements that do not satisfy a predicate, keeping the order of the
+     * others. Every chunk is compacted in parallel, and the compacted chunks are then moved
+     * next to each other.
+     * @param vec the vector.
+     * @param predicate the predicate, true for the elements to keep.
+     * @param pool the pool to run on.
+     * @return the amount of elements that were removed.
+     */
+    template<typename Vector, typename Predicate>
+    static std::size_t compact(Vector &vec, Predicate predicate,
+                               VLWorkStealingPool &pool = VLWorkStealingPool::instance())
+    {
+        auto *data = vec.data();
+        const std::size_t size = vec.size();
+        const std::size_t chunks = _chunks(size, pool);
+        std::vector<std::size_t> kept(chunks);
+        _forChunks(chunks, size, pool, [data, &predicate, &kept](std::size_t chunk, std::size_t first,
+                                                                 std::size_t last)
+        {
+            auto *end = std::remove_if(data + first, data + last, [&predicate](const typename Vector::value_type &value)
+            {
+                return !predicate(value);
+            });
+            kept[chunk] = end - (data + first);
+        });
+        std::size_t newSize = kept[0];
+        for (std::size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            auto *first = data + _chunkBegin(chunk, chunks, size);
+            std::move(first, first + kept[chunk], data + newSize);
+            newSize += kept[chunk];
+        }
+        vec.erase(vec.begin() + newSize, vec.end());
+        return size - newSize;
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLPARALLEL_HPP
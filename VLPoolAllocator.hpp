@@ -0,0 +1,380 @@
+//
+// A thread-local pooled allocator for the heap storage of VLVector.
+// A vector that oscillates around its static capacity, or many short-lived vectors of similar
+// sizes, keep allocating the same few heap capacities, since the growth policy maps a size to a
+// fixed capacity. The pool keeps the released blocks of every size class in a per-thread free
+// list and hands them out again without going through the global heap.
+//
+// Usage: VLVector<T, StaticCapacity, VLDefaultGrowthPolicy, VLPoolAllocator<T>>, or the
+// VLPooledVector<T, StaticCapacity> alias.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLPOOLALLOCATOR_HPP
+#define CPP_FINAL_PROJECT_VLPOOLALLOCATOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include "VLVector.hpp"
+
+#define VLPOOL_MIN_BYTES 16
+#define VLPOOL_MAX_BYTES (64 * 1024)
+#define VLPOOL_MAX_CACHED_BLOCKS 32
+// Four size classes per power of 2 between the smallest and the largest pooled block:
+#define VLPOOL_SIZE_CLASSES 49
+
+/**
+ * @brief Counters of a pool, or of all pools of the process.
+ */
+struct VLPoolStats
+{
+    // Allocations served from a free list:
+    std::size_t hits;
+    // Allocations of a pooled size class that went to the global heap:
+    std::size_t misses;
+    // Allocations too large to pool:
+    std::size_t bypassed;
+    // Deallocations kept in a free list:
+    std::size_t recycled;
+    // Deallocations of a pooled size class returned to the global heap since the list was full:
+    std::size_t released;
+
+    /**
+     * @brief Returns the fraction of the pooled allocations served from a free list.
+     * @return the hit rate, or 0 if there were no pooled allocations.
+     */
+    double hitRate() const noexcept
+    {
+        const std::size_t pooled = hits + misses;
+        return pooled == 0 ? 0.0 : (double) hits / pooled;
+    }
+};
+
+/**
+ * @brief The free lists of the blocks released by a single thread, one list per size class.
+ * Blocks are linked through their first bytes, so a cached block costs no extra memory.
+ */
+class VLThreadPool
+{
+private:
+    /**
+     * @brief A block in a free list.
+     */
+    struct _FreeBlock
+    {
+        _FreeBlock *next;
+    };
+
+    _FreeBlock *_freeLists[VLPOOL_SIZE_CLASSES];
+    std::size_t _cached[VLPOOL_SIZE_CLASSES];
+    VLPoolStats _stats;
+
+    /**
+     * @brief The counters of the pools of threads that already exited.
+     */
+    static std::atomic<std::size_t> *_exitedStats()
+    {
+        static std::atomic<std::size_t> stats[5];
+        return stats;
+    }
+
+    VLThreadPool() noexcept : _freeLists(), _cached(), _stats()
+    {
+    }
+
+    /**
+     * @brief Tells whether the pool of the calling thread was already destroyed, which happens
+     * when vectors with thread storage duration outlive it. The flag is trivially destructible,
+     * so it can still be read at that point.
+     * @return a reference to the flag of the calling thread.
+     */
+    static bool &_tornDown() noexcept
+    {
+        static thread_local bool tornDown = false;
+        return tornDown;
+    }
+
+    /**
+     * @brief Returns the size class of a block size.
+     * Sizes up to VLPOOL_MIN_BYTES share class 0, and every power of 2 above it is split into
+     * four classes, so a block is at most a quarter larger than requested.
+     * @param bytes the requested size, at most VLPOOL_MAX_BYTES.
+     * @return the index of the size class.
+     */
+    static std::size_t _sizeClass(std::size_t bytes) noexcept
+    {
+        if (bytes <= VLPOOL_MIN_BYTES)
+        {
+            return 0;
+        }
+        const std::size_t last = bytes - 1;
+        const std::size_t exponent = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(last);
+        return 1 + (exponent - 4) * 4 + ((last >> (exponent - 2)) & 3);
+    }
+
+    /**
+     * @brief Returns the size of the blocks of a size class.
+     * @param sizeClass the index of the size class.
+     * @return the size of the blocks in bytes.
+     */
+    static std::size_t _classBytes(std::size_t sizeClass) noexcept
+    {
+        if (sizeClass == 0)
+        {
+            return VLPOOL_MIN_BYTES;
+        }
+        const std::size_t exponent = (sizeClass - 1) / 4 + 4;
+        return (5 + (sizeClass - 1) % 4) << (exponent - 2);
+    }
+
+public:
+    VLThreadPool(const VLThreadPool &) = delete;
+
+    VLThreadPool &operator=(const VLThreadPool &) = delete;
+
+    /**
+     * @brief Returns the cached blocks to the global heap and adds the counters of the thread
+     * to the process counters.
+     */
+    ~VLThreadPool()
+    {
+        _tornDown() = true;
+        trim();
+        std::atomic<std::size_t> *exited = _exitedStats();
+        exited[0].fetch_add(_stats.hits, std::memory_order_relaxed);
+        exited[1].fetch_add(_stats.misses, std::memory_order_relaxed);
+        exited[2].fetch_add(_stats.bypassed, std::memory_order_relaxed);
+        exited[3].fetch_add(_stats.recycled, std::memory_order_relaxed);
+        exited[4].fetch_add(_stats.released, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the pool of the calling thread.
+     * @return the pool of the thread.
+     */
+    static VLThreadPool &instance() noexcept
+    {
+        static thread_local VLThreadPool pool;
+        return pool;
+    }
+
+    /**
+     * @brief Allocates a block, from the free list of its size class if it is not empty.
+     * @param bytes the size of the block.
+     * @return a pointer to the block, aligned for any fundamental type.
+     */
+    void *allocate(std::size_t bytes)
+    {
+        if (bytes > VLPOOL_MAX_BYTES)
+        {
+            ++_stats.bypassed;
+            return ::operator new(bytes);
+        }
+        const std::size_t sizeClass = _sizeClass(bytes);
+        _FreeBlock *block = _freeLists[sizeClass];
+        if (block != nullptr)
+        {
+            _freeLists[sizeClass] = block->next;
+            --_cached[sizeClass];
+            ++_stats.hits;
+            return block;
+        }
+        ++_stats.misses;
+        return ::operator new(_classBytes(sizeClass));
+    }
+
+    /**
+     * @brief Releases a block, keeping it in the free list of its size class unless the list
+     * is full. The block may have been allocated by the pool of another thread.
+     * @param storage the block.
+     * @param bytes the size the block was allocated with.
+     */
+    void deallocate(void *storage, std::size_t bytes) noexcept
+    {
+        if (bytes > VLPOOL_MAX_BYTES)
+        {
+            ::operator delete(storage);
+            return;
+        }
+        const std::size_t sizeClass = _sizeClass(bytes);
+        if (_cached[sizeClass] == VLPOOL_MAX_CACHED_BLOCKS)
+        {
+            ++_stats.released;
+            ::operator delete(storage);
+            return;
+        }
+        _FreeBlock *block = ::new(storage) _FreeBlock;
+        block->next = _freeLists[sizeClass];
+        _freeLists[sizeClass] = block;
+        ++_cached[sizeClass];
+        ++_stats.recycled;
+    }
+
+    /**
+     * @brief Allocates a block from the pool of the calling thread, or from the global heap if
+     * the pool was already destroyed.
+     * @param bytes the size of the block.
+     * @return a pointer to the block.
+     */
+    static void *allocateBlock(std::size_t bytes)
+    {
+        if (_tornDown())
+        {
+            return ::operator new(bytes > VLPOOL_MAX_BYTES ? bytes : _classBytes(_sizeClass(bytes)));
+        }
+        return instance().allocate(bytes);
+    }
+
+    /**
+     * @brief Releases a block to the pool of the calling thread, or to the global heap if the
+     * pool was already destroyed.
+     * @param storage the block.
+     * @param bytes the size the block was allocated with.
+     */
+    static void deallocateBlock(void *storage, std::size_t bytes) noexcept
+    {
+        if (_tornDown())
+        {
+            ::operator delete(storage);
+            return;
+        }
+        instance().deallocate(storage, bytes);
+    }
+
+    /**
+     * @brief Returns all cached blocks of the thread to the global heap.
+     */
+    void trim() noexcept
+    {
+        for (std::size_t sizeClass = 0; sizeClass < VLPOOL_SIZE_CLASSES; ++sizeClass)
+        {
+            while (_freeLists[sizeClass] != nullptr)
+            {
+                _FreeBlock *block = _freeLists[sizeClass];
+                _freeLists[sizeClass] = block->next;
+                ::operator delete(block);
+            }
+            _cached[sizeClass] = 0;
+        }
+    }
+
+    /**
+     * @brief Returns the counters of the pool of the calling thread.
+     * @return the counters of the thread.
+     */
+    const VLPoolStats &stats() const noexcept
+    {
+        return _stats;
+    }
+
+    /**
+     * @brief Resets the counters of the pool of the calling thread.
+     */
+    void resetStats() noexcept
+    {
+        _stats = VLPoolStats();
+    }
+
+    /**
+     * @brief Returns the counters of the threads that exited, added to those of the calling
+     * thread. Threads that are still running are not counted.
+     * @return the counters of the process.
+     */
+    static VLPoolStats processStats() noexcept
+    {
+        const std::atomic<std::size_t> *exited = _exitedStats();
+        VLPoolStats stats = instance().stats();
+        stats.hits += exited[0].load(std::memory_order_relaxed);
+        stats.misses += exited[1].load(std::memory_order_relaxed);
+        stats.bypassed += exited[2].load(std::memory_order_relaxed);
+        stats.recycled += exited[3].load(std::memory_order_relaxed);
+        stats.released += exited[4].load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    /**
+     * @brief Prints counters in a single line.
+     * @param out the stream to write to.
+     * @param stats the counters to print.
+     */
+    static void report(std::FILE *out, const VLPoolStats &stats)
+    {
+        std::fprintf(out, "VLPool: %zu hits, %zu misses (%.1f%% hit rate), %zu bypassed, "
+                          "%zu recycled, %zu released\n", stats.hits, stats.misses,
+                     stats.hitRate() * 100, stats.bypassed, stats.recycled, stats.released);
+    }
+};
+
+/**
+ * @brief A stateless allocator that takes its blocks from the pool of the calling thread.
+ * All instances are interchangeable, so vectors using it swap and move heap storage freely.
+ * @tparam T the type of values to allocate.
+ */
+template<typename T>
+class VLPoolAllocator
+{
+public:
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "VLPoolAllocator does not support over-aligned types");
+
+    typedef T value_type;
+    typedef std::true_type is_always_equal;
+    typedef std::true_type propagate_on_container_move_assignment;
+
+    VLPoolAllocator() noexcept = default;
+
+    /**
+     * @brief Converts an allocator of another type.
+     */
+    template<typename U>
+    VLPoolAllocator(const VLPoolAllocator<U> &) noexcept
+    {
+    }
+
+    /**
+     * @brief Allocates storage for a given amount of values.
+     * @param count the amount of values.
+     * @return a pointer to the storage.
+     */
+    T *allocate(std::size_t count)
+    {
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+            throw std::bad_alloc();
+        }
+        return static_cast<T *>(VLThreadPool::allocateBlock(count * sizeof(T)));
+    }
+
+    /**
+     * @brief Releases storage that was allocated for a given amount of values.
+     * @param storage the storage.
+     * @param count the amount of values the storage was allocated for.
+     */
+    void deallocate(T *storage, std::size_t count) noexcept
+    {
+        VLThreadPool::deallocateBlock(storage, count * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const VLPoolAllocator<U> &) const noexcept
+    {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const VLPoolAllocator<U> &) const noexcept
+    {
+        return false;
+    }
+};
+
+/**
+ * @brief A VLVector whose heap storage comes from the pool of the calling thread.
+ */
+template<typename T, std::size_t StaticCapacity = DEF_STATIC_CAPACITY>
+using VLPooledVector = VLVector<T, StaticCapacity, VLDefaultGrowthPolicy, VLPoolAllocator<T>>;
+
+#endif //CPP_FINAL_PROJECT_VLPOOLALLOCATOR_HPP
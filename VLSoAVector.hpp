@@ -0,0 +1,977 @@
+//
+// A structure-of-arrays sibling of VLVector: every field of a row is stored in its own
+// contiguous array, so loops that touch one or two fields read only those fields.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLSOAVECTOR_HPP
+#define CPP_FINAL_PROJECT_VLSOAVECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "VLVector.hpp"
+
+/**
+ * @brief A contiguous view of one field of a VLSoAVector, for loops over a single field.
+ * The span is invalidated by any operation that changes the capacity of the vector.
+ * @tparam T the type of the field, const qualified for read-only spans.
+ */
+template<typename T>
+class VLFieldSpan
+{
+private:
+    T *_data;
+    std::size_t _size;
+
+public:
+    /**
+     * @brief Constructs a span.
+     * @param data pointer to the first value of the field.
+     * @param size the amount of values.
+     */
+    VLFieldSpan(T *data, std::size_t size) noexcept : _data(data), _size(size)
+    {
+    }
+
+    /**
+     * @brief Returns a pointer to the first value.
+     * @return a pointer to the first value.
+     */
+    T *data() const noexcept
+    {
+        return _data;
+    }
+
+    /**
+     * @brief Returns the amount of values.
+     * @return the amount of values.
+     */
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @brief Returns a pointer to the first value.
+     * @return a pointer to the first value.
+     */
+    T *begin() const noexcept
+    {
+        return _data;
+    }
+
+    /**
+     * @brief Returns a pointer past the last value.
+     * @return a pointer past the last value.
+     */
+    T *end() const noexcept
+    {
+        return _data + _size;
+    }
+
+    /**
+     * @brief Returns the value at a given index.
+     * @param index the index of the value.
+     * @return a reference to the value.
+     */
+    T &operator[](std::size_t index) const noexcept
+    {
+        return _data[index];
+    }
+};
+
+/**
+ * @brief Represents a Virtual Length Vector of rows stored as a structure of arrays.
+ * Every field has its own inline array of StaticCapacity values, and once the rows do not fit
+ * there all fields move to a single heap block, following the same growth policy as VLVector.
+ * Fields must be nothrow move constructible, so moving rows between storages never fails.
+ * The storage is managed here rather than by a VLVector per field: all fields share one size,
+ * one capacity and one heap block, so spilling or growing costs a single allocation however many
+ * fields there are. It shares the VLTriviallyRelocatable trait with VLVector, but it has no
+ * allocator parameter and allocates with operator new.
+ * @tparam StaticCapacity the amount of rows the vector stores without allocating.
+ * @tparam GrowthPolicy decides how the heap capacity grows and when to return to the stack.
+ * @tparam Ts the types of the fields of a row.
+ */
+template<std::size_t StaticCapacity, typename GrowthPolicy, typename... Ts>
+class VLBasicSoAVector
+{
+private:
+    static_assert(sizeof...(Ts) > 0, "VLSoAVector needs at least one field");
+
+    /**
+     * @brief Tells whether a trait holds for all fields.
+     */
+    template<bool... Values>
+    using _All = std::is_same<std::integer_sequence<bool, true, Values...>,
+            std::integer_sequence<bool, Values..., true>>;
+
+    static_assert(_All<std::is_nothrow_move_constructible<Ts>::value...>::value,
+                  "VLSoAVector fields must be nothrow move constructible");
+    static_assert(_All<(alignof(Ts) <= alignof(std::max_align_t))...>::value,
+                  "VLSoAVector fields must not be over-aligned");
+
+    typedef std::tuple<Ts...> _Fields;
+    typedef std::index_sequence_for<Ts...> _FieldIndices;
+
+    /**
+     * @brief The type of the field with a given index.
+     */
+    template<std::size_t I>
+    using _Field = typename std::tuple_element<I, _Fields>::type;
+
+    /**
+     * @brief Raw storage for the inline values of a single field.
+     */
+    template<typename T>
+    struct _InlineArray
+    {
+        alignas(T) unsigned char bytes[sizeof(T) * StaticCapacity];
+    };
+
+    /********************************************************************
+    *                             Class members                         *
+    ********************************************************************/
+
+    // The vector is in stack mode iff its capacity does not exceed the static capacity:
+    std::size_t _size;
+    std::size_t _capacity;
+    unsigned char *_heap;
+    std::tuple<_InlineArray<Ts>...> _inline;
+
+    /**
+     * @brief Checks if the rows are stored on the stack.
+     * @return true iff the vector is in stack mode.
+     */
+    bool _isStackMode() const noexcept
+    {
+        return _capacity <= StaticCapacity;
+    }
+
+    /**
+     * @brief Calls a function with the index of every field, as a std::integral_constant.
+     * @param function the function to call.
+     */
+    template<typename Function>
+    static void _forEachField(Function &&function)
+    {
+        _forEachField(function, _FieldIndices());
+    }
+
+    template<typename Function, std::size_t... I>
+    static void _forEachField(Function &function, std::index_sequence<I...>)
+    {
+        using expand = int[];
+        (void) expand{0, (function(std::integral_constant<std::size_t, I>()), 0)...};
+    }
+
+    /********************************************************************
+    *                          Storage methods                          *
+    ********************************************************************/
+
+    /**
+     * @brief Returns the offset of a field inside a heap block of a given capacity.
+     * Fields are laid out one after the other, each aligned for its type.
+     * @param field the index of the field.
+     * @param capacity the capacity of the heap block.
+     * @return the offset of the field in bytes.
+     */
+    static std::size_t _offset(std::size_t field, std::size_t capacity) noexcept
+    {
+        const std::size_t sizes[] = {sizeof(Ts)...};
+        const std::size_t alignments[] = {alignof(Ts)...};
+        std::size_t offset = 0;
+        for (std::size_t i = 0; i < field; ++i)
+        {
+            offset += sizes[i] * capacity;
+            offset = (offset + alignments[i + 1] - 1) / alignments[i + 1] * alignments[i + 1];
+        }
+        return offset;
+    }
+
+    /**
+     * @brief Returns the size of a heap block of a given capacity.
+     * @param capacity the capacity of the heap block.
+     * @return the size of the heap block in bytes.
+     */
+    static std::size_t _blockSize(std::size_t capacity) noexcept
+    {
+        return _offset(sizeof...(Ts) - 1, capacity) + sizeof(_Field<sizeof...(Ts) - 1>) * capacity;
+    }
+
+    /**
+     * @brief Returns a pointer to the first inline value of a field.
+     */
+    template<std::size_t I>
+    _Field<I> *_inlineData() noexcept
+    {
+        return reinterpret_cast<_Field<I> *>(std::get<I>(_inline).bytes);
+    }
+
+    /**
+     * @brief Returns a pointer to the first value of a field inside a heap block.
+     */
+    template<std::size_t I>
+    static _Field<I> *_heapData(unsigned char *heap, std::size_t capacity) noexcept
+    {
+        return reinterpret_cast<_Field<I> *>(heap + _offset(I, capacity));
+    }
+
+    /**
+     * @brief Allocates a heap block for a given capacity.
+     * @param capacity the amount of rows the block should fit.
+     * @return a pointer to the heap block.
+     */
+    unsigned char *_allocate(std::size_t capacity) const
+    {
+        if (capacity > max_size())
+        {
+            throw std::length_error(LENGTH_EXCEPTION_MSG);
+        }
+        return static_cast<unsigned char *>(::operator new(_blockSize(capacity)));
+    }
+
+    /**
+     * @brief Relocates trivially relocatable values with a single memcpy.
+     */
+    template<typename T>
+    static void _relocate(T *first, T *last, T *dest, std::true_type) noexcept
+    {
+        if (first != last)
+        {
+            std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first),
+                        (last - first) * sizeof(T));
+        }
+    }
+
+    /**
+     * @brief Relocates values one by one, moving them and destroying the sources.
+     */
+    template<typename T>
+    static void _relocate(T *first, T *last, T *dest, std::false_type) noexcept
+    {
+        for (; first != last; ++first, ++dest)
+        {
+            ::new(static_cast<void *>(dest)) T(std::move(*first));
+            first->~T();
+        }
+    }
+
+    /**
+     * @brief Moves all rows to new storage with a given capacity: the inline arrays if the
+     * capacity fits in the static capacity, otherwise a new heap block.
+     * @param newCapacity the new capacity, which must fit all rows.
+     */
+    void _setCapacity(std::size_t newCapacity)
+    {
+        if (_isStackMode() && newCapacity <= StaticCapacity)
+        {
+            return;
+        }
+        unsigned char *newHeap = newCapacity > StaticCapacity ? _allocate(newCapacity) : nullptr;
+        _forEachField([&](auto field)
+                      {
+                          constexpr std::size_t I = decltype(field)::value;
+                          _Field<I> *source = this->template field<I>();
+                          _Field<I> *dest = newHeap != nullptr ? _heapData<I>(newHeap, newCapacity)
+                                                               : this->template _inlineData<I>();
+                          _relocate(source, source + _size, dest, VLTriviallyRelocatable<_Field<I>>());
+                      });
+        if (!_isStackMode())
+        {
+            ::operator delete(_heap);
+        }
+        _heap = newHeap;
+        _capacity = newHeap != nullptr ? newCapacity : StaticCapacity;
+    }
+
+    /**
+     * @brief Makes room for one more row, moving the vector to the heap or increasing its heap
+     * capacity if needed.
+     */
+    void _growIfFull()
+    {
+        if (_size == _capacity)
+        {
+            _setCapacity(GrowthPolicy::grow(_size + 1));
+        }
+    }
+
+    /**
+     * @brief Moves the vector back to the stack if following a removal the growth policy decides
+     * it should return there.
+     */
+    void _shrinkIfNeeded()
+    {
+        if (!_isStackMode() && GrowthPolicy::shouldReturnToStack(_size, StaticCapacity))
+        {
+            _setCapacity(StaticCapacity);
+        }
+    }
+
+    /**
+     * @brief Destroys a single value.
+     */
+    template<typename T>
+    static void _destroy(T *value) noexcept
+    {
+        value->~T();
+    }
+
+    /**
+     * @brief Destroys the values of the rows in a given range of indices.
+     * @param first the index of the first row to destroy.
+     * @param last the index past the last row to destroy.
+     */
+    void _destroyRows(std::size_t first, std::size_t last) noexcept
+    {
+        _forEachField([&](auto field)
+                      {
+                          constexpr std::size_t I = decltype(field)::value;
+                          _Field<I> *values = this->template field<I>();
+                          for (std::size_t i = first; i < last; ++i)
+                          {
+                              _destroy(values + i);
+                          }
+                      });
+    }
+
+    /**
+     * @brief Constructs the values of a row in uninitialised slots, one argument per field.
+     * If a constructor throws, the values that were already constructed are destroyed.
+     * @param index the index of the row.
+     * @param args a tuple of references to the arguments.
+     */
+    template<typename Args>
+    void _constructRow(std::size_t index, Args &&args)
+    {
+        std::size_t constructed = 0;
+        try
+        {
+            _forEachField([&](auto field)
+                          {
+                              constexpr std::size_t I = decltype(field)::value;
+                              ::new(static_cast<void *>(this->template field<I>() + index))
+                                      _Field<I>(std::get<I>(std::forward<Args>(args)));
+                              ++constructed;
+                          });
+        }
+        catch (...)
+        {
+            _forEachField([&](auto field)
+                          {
+                              constexpr std::size_t I = decltype(field)::value;
+                              if (I < constructed)
+                              {
+                                  _destroy(this->template field<I>() + index);
+                              }
+                          });
+            throw;
+        }
+    }
+
+    /**
+     * @brief Takes the rows of another vector, leaving it empty.
+     * The heap block of the other vector is taken as is, inline rows are relocated.
+     * This vector must be empty and in stack mode.
+     * @param other the vector to take the rows from.
+     */
+    void _takeFrom(VLBasicSoAVector &other) noexcept
+    {
+        if (!other._isStackMode())
+        {
+            _heap = other._heap;
+            _capacity = other._capacity;
+            other._heap = nullptr;
+            other._capacity = StaticCapacity;
+        }
+        else
+        {
+            _forEachField([&](auto field)
+                          {
+                              constexpr std::size_t I = decltype(field)::value;
+                              _Field<I> *source = other.template field<I>();
+                              _relocate(source, source + other._size, this->template field<I>(),
+                                        VLTriviallyRelocatable<_Field<I>>());
+                          });
+        }
+        _size = other._size;
+        other._size = 0;
+    }
+
+    /**
+     * @brief Tells whether all fields may be copied with memcpy.
+     */
+    typedef std::integral_constant<bool, _All<std::is_trivially_copyable<Ts>::value...>::value> _TriviallyCopyable;
+
+    /**
+     * @brief Copies the rows of another vector field by field with memcpy.
+     */
+    void _copyRows(const VLBasicSoAVector &other, std::true_type) noexcept
+    {
+        _forEachField([&](auto field)
+                      {
+                          constexpr std::size_t I = decltype(field)::value;
+                          if (other._size != 0)
+                          {
+                              std::memcpy(static_cast<void *>(this->template field<I>()),
+                                          static_cast<const void *>(other.template field<I>()),
+                                          other._size * sizeof(_Field<I>));
+                          }
+                      });
+        _size = other._size;
+    }
+
+    /**
+     * @brief Copies the rows of another vector row by row.
+     */
+    void _copyRows(const VLBasicSoAVector &other, std::false_type)
+    {
+        for (std::size_t i = 0; i < other._size; ++i)
+        {
+            _constructRow(_size, other[i]);
+            ++_size;
+        }
+    }
+
+public:
+    /**
+     * @brief The type of the field with a given index.
+     */
+    template<std::size_t I>
+    using field_type = _Field<I>;
+
+    /**
+     * @brief A row as values, and proxy references to the fields of a row.
+     */
+    typedef std::tuple<Ts...> value_type;
+    typedef std::tuple<Ts &...> reference;
+    typedef std::tuple<const Ts &...> const_reference;
+
+    /**
+     * @brief An iterator over the rows, whose references are tuples of references to the fields
+     * of a row. A forward iterator must yield real references, so the iterator is categorised as
+     * an input iterator, although it supports the operations of a random access iterator.
+     * Since the references are proxies, it suits row-wise loops and non-mutating algorithms,
+     * not algorithms that swap rows.
+     * @tparam Const true for an iterator over a const vector.
+     */
+    template<bool Const>
+    class VLSoAIterator
+    {
+    private:
+        typedef typename std::conditional<Const, const VLBasicSoAVector, VLBasicSoAVector>::type _Owner;
+
+        template<bool> friend class VLSoAIterator;
+
+        _Owner *_vec;
+        std::size_t _index;
+
+    public:
+        /**
+         * @brief Iterator traits.
+         */
+        typedef VLBasicSoAVector::value_type value_type;
+        typedef typename std::conditional<Const, const_reference, VLBasicSoAVector::reference>::type reference;
+        typedef void pointer;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::input_iterator_tag iterator_category;
+
+        /**
+         * @brief Constructs a singular iterator that does not point into any vector.
+         */
+        VLSoAIterator() : _vec(nullptr), _index(0)
+        {
+        }
+
+        /**
+         * @brief Constructs an iterator to a given row.
+         * @param vec the vector to iterate over.
+         * @param index the index of the row.
+         */
+        VLSoAIterator(_Owner *vec, std::size_t index) : _vec(vec), _index(index)
+        {
+        }
+
+        /**
+         * @brief Converts a non-const iterator to a const iterator.
+         * @param other the iterator to convert.
+         */
+        template<bool OtherConst, typename = typename std::enable_if<Const && !OtherConst>::type>
+        VLSoAIterator(const VLSoAIterator<OtherConst> &other) : _vec(other._vec), _index(other._index)
+        {
+        }
+
+        /**
+         * @brief Returns references to the fields of the current row.
+         * @return a tuple of references to the fields of the row.
+         */
+        reference operator*() const
+        {
+            return (*_vec)[_index];
+        }
+
+        /**
+         * @brief Returns references to the fields of the row at a given distance.
+         * @param n the distance of the row.
+         * @return a tuple of references to the fields of the row.
+         */
+        reference operator[](difference_type n) const
+        {
+            return (*_vec)[_index + n];
+        }
+
+        VLSoAIterator &operator++()
+        {
+            ++_index;
+            return *this;
+        }
+
+        VLSoAIterator operator++(int)
+        {
+            VLSoAIterator temp = *this;
+            ++_index;
+            return temp;
+        }
+
+        VLSoAIterator &operator--()
+        {
+            --_index;
+            return *this;
+        }
+
+        VLSoAIterator operator--(int)
+        {
+            VLSoAIterator temp = *this;
+            --_index;
+            return temp;
+        }
+
+        VLSoAIterator &operator+=(difference_type n)
+        {
+            _index += n;
+            return *this;
+        }
+
+        VLSoAIterator &operator-=(difference_type n)
+        {
+            _index -= n;
+            return *this;
+        }
+
+        VLSoAIterator operator+(difference_type n) const
+        {
+            return VLSoAIterator(_vec, _index + n);
+        }
+
+        friend VLSoAIterator operator+(difference_type n, const VLSoAIterator &it)
+        {
+            return it + n;
+        }
+
+        VLSoAIterator operator-(difference_type n) const
+        {
+            return VLSoAIterator(_vec, _index - n);
+        }
+
+        difference_type operator-(const VLSoAIterator &other) const
+        {
+            return (difference_type) _index - (difference_type) other._index;
+        }
+
+        bool operator==(const VLSoAIterator &other) const
+        {
+            return _index == other._index;
+        }
+
+        bool operator!=(const VLSoAIterator &other) const
+        {
+            return _index != other._index;
+        }
+
+        bool operator<(const VLSoAIterator &other) const
+        {
+            return _index < other._index;
+        }
+
+        bool operator>(const VLSoAIterator &other) const
+        {
+            return _index > other._index;
+        }
+
+        bool operator<=(const VLSoAIterator &other) const
+        {
+            return _index <= other._index;
+        }
+
+        bool operator>=(const VLSoAIterator &other) const
+        {
+            return _index >= other._index;
+        }
+    };
+
+    /**
+     * @brief Typedefs for const and non-const iterators for the vector.
+     */
+    typedef VLSoAIterator<false> iterator;
+    typedef VLSoAIterator<true> const_iterator;
+
+    /********************************************************************
+    *                       Rule of 5 methods                           *
+    ********************************************************************/
+
+    /**
+     * @brief Default constructor. Initialises an empty vector.
+     */
+    VLBasicSoAVector() noexcept : _size(0), _capacity(StaticCapacity), _heap(nullptr)
+    {
+    }
+
+    /**
+     * @brief Copy constructor. Only the live rows are copied, onto the stack if they fit there.
+     * @param other the vector to copy from.
+     */
+    VLBasicSoAVector(const VLBasicSoAVector &other) : VLBasicSoAVector()
+    {
+        _setCapacity(other._size);
+        _copyRows(other, _TriviallyCopyable());
+    }
+
+    /**
+     * @brief Move constructor.
+     * In heap mode the heap block is taken as is, in stack mode the rows are relocated.
+     * @param other the vector to move from.
+     */
+    VLBasicSoAVector(VLBasicSoAVector &&other) noexcept : VLBasicSoAVector()
+    {
+        _takeFrom(other);
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~VLBasicSoAVector()
+    {
+        clear();
+    }
+
+    /**
+     * @brief Swaps the contents of two vectors.
+     * @param first the first vector.
+     * @param second the second vector.
+     */
+    friend void swap(VLBasicSoAVector &first, VLBasicSoAVector &second) noexcept
+    {
+        VLBasicSoAVector temp(std::move(first));
+        first._takeFrom(second);
+        second._takeFrom(temp);
+    }
+
+    /**
+     * @brief Assignment operator, implementing the "Copy and Swap" idiom.
+     * @param other the other vector to assign from.
+     * @return this vector after assignment.
+     */
+    VLBasicSoAVector &operator=(VLBasicSoAVector other) noexcept
+    {
+        swap(*this, other);
+        return *this;
+    }
+
+    /********************************************************************
+    *                            API methods                            *
+    ********************************************************************/
+
+    /**
+     * @brief Returns the maximal amount of rows the vector can hold.
+     * @return the maximal amount of rows.
+     */
+    std::size_t max_size() const noexcept
+    {
+        const std::size_t sizes[] = {sizeof(Ts)...};
+        std::size_t rowSize = 0;
+        for (std::size_t size : sizes)
+        {
+            rowSize += size;
+        }
+        // Leaves room for the padding between fields:
+        return (std::numeric_limits<std::size_t>::max() - sizeof...(Ts) * alignof(std::max_align_t)) / rowSize;
+    }
+
+    /**
+     * @brief Returns the number of rows that are stored in the vector.
+     * @return the number of rows.
+     */
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @brief Returns the number of rows the vector can currently hold.
+     * @return the capacity of the vector.
+     */
+    std::size_t capacity() const noexcept
+    {
+        return _capacity;
+    }
+
+    /**
+     * @brief Checks if the vector is empty.
+     * @return true iff the vector has no rows.
+     */
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    /**
+     * @brief Makes sure the vector can hold a given amount of rows without reallocating.
+     * @param newCapacity the amount of rows the vector should be able to hold.
+     */
+    void reserve(std::size_t newCapacity)
+    {
+        if (newCapacity > _capacity)
+        {
+            _setCapacity(newCapacity);
+        }
+    }
+
+    /**
+     * @brief Changes the amount of rows, appending value initialised rows or destroying rows
+     * at the end.
+     * @param newSize the new amount of rows.
+     */
+    void resize(std::size_t newSize)
+    {
+        if (newSize < _size)
+        {
+            _destroyRows(newSize, _size);
+            _size = newSize;
+            _shrinkIfNeeded();
+            return;
+        }
+        if (newSize > _capacity)
+        {
+            _setCapacity(std::max(newSize, GrowthPolicy::grow(_size + 1)));
+        }
+        for (; _size < newSize; ++_size)
+        {
+            _constructRow(_size, std::tuple<Ts...>());
+        }
+    }
+
+    /**
+     * @brief Appends a row constructed from one argument per field.
+     * @tparam Args the types of the arguments.
+     * @param args the arguments to construct the fields from, in field order.
+     */
+    template<typename... Args>
+    void emplace_back(Args &&... args)
+    {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "emplace_back takes one argument per field");
+        if (_size == _capacity)
+        {
+            // args may refer to rows of this vector, so the row is built before the storage moves:
+            std::tuple<Ts...> row(std::forward<Args>(args)...);
+            _growIfFull();
+            _constructRow(_size, std::move(row));
+        }
+        else
+        {
+            _constructRow(_size, std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        ++_size;
+    }
+
+    /**
+     * @brief Appends a row.
+     * @param values the values of the fields, in field order.
+     */
+    void push_back(const Ts &... values)
+    {
+        emplace_back(values...);
+    }
+
+    /**
+     * @brief Removes the last row.
+     */
+    void pop_back()
+    {
+        if (_size > 0)
+        {
+            _destroyRows(_size - 1, _size);
+            --_size;
+            _shrinkIfNeeded();
+        }
+    }
+
+    /**
+     * @brief Removes all rows and releases the heap block.
+     */
+    void clear() noexcept
+    {
+        _destroyRows(0, _size);
+        _size = 0;
+        if (!_isStackMode())
+        {
+            ::operator delete(_heap);
+            _heap = nullptr;
+            _capacity = StaticCapacity;
+        }
+    }
+
+    /**
+     * @brief Returns a pointer to the contiguous values of a field.
+     * @tparam I the index of the field.
+     * @return a pointer to the value of the field in the first row.
+     */
+    template<std::size_t I>
+    field_type<I> *field() noexcept
+    {
+        return _isStackMode() ? _inlineData<I>() : _heapData<I>(_heap, _capacity);
+    }
+
+    /**
+     * @brief Returns a pointer to the contiguous values of a field.
+     * @tparam I the index of the field.
+     * @return a pointer to the value of the field in the first row.
+     */
+    template<std::size_t I>
+    const field_type<I> *field() const noexcept
+    {
+        return const_cast<VLBasicSoAVector *>(this)->template field<I>();
+    }
+
+    /**
+     * @brief Returns a span over the values of a field in all rows.
+     * @tparam I the index of the field.
+     * @return a span over the field.
+     */
+    template<std::size_t I>
+    VLFieldSpan<field_type<I>> span() noexcept
+    {
+        return VLFieldSpan<field_type<I>>(field<I>(), _size);
+    }
+
+    /**
+     * @brief Returns a read-only span over the values of a field in all rows.
+     * @tparam I the index of the field.
+     * @return a span over the field.
+     */
+    template<std::size_t I>
+    VLFieldSpan<const field_type<I>> span() const noexcept
+    {
+        return VLFieldSpan<const field_type<I>>(field<I>(), _size);
+    }
+
+    /**
+     * @brief Returns references to the fields of the row at a given index.
+     * @param index the index of the row.
+     * @return a tuple of references to the fields of the row.
+     */
+    reference operator[](std::size_t index) noexcept
+    {
+        return _row<reference>(index, _FieldIndices());
+    }
+
+    /**
+     * @brief Returns references to the fields of the row at a given index.
+     * @param index the index of the row.
+     * @return a tuple of const references to the fields of the row.
+     */
+    const_reference operator[](std::size_t index) const noexcept
+    {
+        return const_cast<VLBasicSoAVector *>(this)->template _row<const_reference>(index, _FieldIndices());
+    }
+
+    /**
+     * @brief Returns references to the fields of the row at a given index.
+     * Throws an exception if the index was not found.
+     * @param index the index of the row.
+     * @return a tuple of references to the fields of the row.
+     */
+    reference at(std::size_t index)
+    {
+        if (index >= _size)
+        {
+            throw std::out_of_range(AT_EXCEPTION_MSG);
+        }
+        return (*this)[index];
+    }
+
+    /**
+     * @brief Returns references to the fields of the row at a given index.
+     * Throws an exception if the index was not found.
+     * @param index the index of the row.
+     * @return a tuple of const references to the fields of the row.
+     */
+    const_reference at(std::size_t index) const
+    {
+        if (index >= _size)
+        {
+            throw std::out_of_range(AT_EXCEPTION_MSG);
+        }
+        return (*this)[index];
+    }
+
+    /********************************************************************
+    *                       Begin and end iterators                     *
+    ********************************************************************/
+
+    iterator begin() noexcept
+    {
+        return iterator(this, 0);
+    }
+
+    iterator end() noexcept
+    {
+        return iterator(this, _size);
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(this, 0);
+    }
+
+    const_iterator end() const noexcept
+    {
+        return const_iterator(this, _size);
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+private:
+    /**
+     * @brief Builds a tuple of references to the fields of a row.
+     */
+    template<typename Reference, std::size_t... I>
+    Reference _row(std::size_t index, std::index_sequence<I...>) noexcept
+    {
+        return Reference(field<I>()[index]...);
+    }
+};
+
+/**
+ * @brief A structure-of-arrays vector with the default static capacity and growth policy.
+ * @tparam Ts the types of the fields of a row.
+ */
+template<typename... Ts>
+using VLSoAVector = VLBasicSoAVector<DEF_STATIC_CAPACITY, VLDefaultGrowthPolicy, Ts...>;
+
+#endif //CPP_FINAL_PROJECT_VLSOAVECTOR_HPP
@@ -8,63 +8,449 @@
 #include <iterator>
 #include <memory>
 #include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <stdexcept>
+#include <utility>
+#include "VLVectorSimd.hpp"
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define VLVECTOR_HAS_PMR
+#endif
+#endif
+
+#ifdef VLVECTOR_ENABLE_STATS
+#include "VLVectorStats.hpp"
+#endif
+
+#ifdef VLVECTOR_ENABLE_PROFILER
+#include "VLVectorProfiler.hpp"
+#endif
 
 #define AT_EXCEPTION_MSG "In function \"at\": Index was not found"
+#define LENGTH_EXCEPTION_MSG "VLVector capacity exceeds max_size()"
 #define DEF_STATIC_CAPACITY 16
 
+#define VLVECTOR_STRINGIFY_(x) #x
+#define VLVECTOR_STRINGIFY(x) VLVECTOR_STRINGIFY_(x)
+
+/**
+ * @brief Tags a vector with the file and line it is tagged at, so the size profiler collects its
+ * sizes per call site. Does nothing unless VLVECTOR_ENABLE_PROFILER is defined.
+ */
+#define VLVECTOR_PROFILE_HERE(vec) (vec).set_profile_tag(__FILE__ ":" VLVECTOR_STRINGIFY(__LINE__))
+
+/**
+ * @brief Tells whether objects of type T may be relocated by copying their bytes to a new
+ * address and not running the destructor on the old address.
+ * Trivially copyable types are relocatable by default, other types (e.g. types that only hold
+ * pointers to heap memory) may opt in by specializing this struct as std::true_type.
+ * @tparam T the type of values to relocate.
+ */
+template<typename T>
+struct VLTriviallyRelocatable : std::is_trivially_copyable<T>
+{
+};
+
+/**
+ * @brief A growth policy for VLVector.
+ * The heap capacity grows to GrowthNumerator / GrowthDenominator times the required size.
+ * A vector on the heap returns to the stack only once its size drops to
+ * ShrinkNumerator / ShrinkDenominator of the static capacity (and never if ReturnToStack is
+ * false), so a vector whose size oscillates around the static capacity does not move between
+ * the stack and the heap on every operation.
+ * A custom policy is any type providing the same two static methods.
+ */
+template<std::size_t GrowthNumerator = 3, std::size_t GrowthDenominator = 2,
+        std::size_t ShrinkNumerator = 1, std::size_t ShrinkDenominator = 2,
+        bool ReturnToStack = true>
+struct VLGrowthPolicy
+{
+    static_assert(GrowthNumerator > GrowthDenominator, "The growth factor must be greater than 1");
+    static_assert(ShrinkNumerator <= ShrinkDenominator, "The shrink threshold must not exceed 1");
+
+    /**
+     * @brief Returns the heap capacity to allocate when the vector needs to hold a given size.
+     * @param requiredSize the amount of elements the vector needs to hold.
+     * @return the new capacity, which is at least requiredSize.
+     */
+    static std::size_t grow(std::size_t requiredSize)
+    {
+        return std::max(requiredSize, requiredSize * GrowthNumerator / GrowthDenominator);
+    }
+
+    /**
+     * @brief Checks if a vector on the heap should return to the stack.
+     * @param size the size of the vector.
+     * @param staticCapacity the static capacity of the vector.
+     * @return true iff the vector should move its elements back to the stack.
+     */
+    static bool shouldReturnToStack(std::size_t size, std::size_t staticCapacity)
+    {
+        return ReturnToStack && size * ShrinkDenominator <= staticCapacity * ShrinkNumerator;
+    }
+};
+
+/**
+ * @brief The growth policy VLVector uses by default: grows by 1.5 and returns to the stack
+ * once the size drops to half of the static capacity.
+ */
+typedef VLGrowthPolicy<> VLDefaultGrowthPolicy;
+
+/**
+ * @brief The statistics hooks VLVector calls when VLVECTOR_ENABLE_STATS is not defined.
+ * Every hook is empty, so the statistics cost nothing.
+ */
+struct VLNoStats
+{
+    static void construct() noexcept
+    {
+    }
+
+    static void spill() noexcept
+    {
+    }
+
+    static void reallocation() noexcept
+    {
+    }
+
+    static void returnToStack() noexcept
+    {
+    }
+
+    static void copied(std::size_t) noexcept
+    {
+    }
+
+    static void moved(std::size_t) noexcept
+    {
+    }
+
+    static void size(std::size_t) noexcept
+    {
+    }
+};
+
+/**
+ * @brief Tells whether an allocator can resize a block in place or remap it, through a method
+ * T *reallocate(T *storage, std::size_t oldCount, std::size_t newCount) that keeps the bytes of
+ * the block and returns nullptr when it cannot (e.g. VLMmapAllocator).
+ * @tparam Allocator the allocator type.
+ */
+template<typename Allocator, typename = void>
+struct VLAllocatorCanReallocate : std::false_type
+{
+};
+
+template<typename Allocator>
+struct VLAllocatorCanReallocate<Allocator, decltype((void) std::declval<Allocator &>().reallocate(
+        std::declval<typename Allocator::value_type *>(), std::size_t(), std::size_t()))>
+        : std::true_type
+{
+};
+
+/**
+ * @brief Holds an allocator, taking no space when the allocator is an empty class.
+ * @tparam Allocator the allocator type.
+ */
+template<typename Allocator,
+        bool = std::is_empty<Allocator>::value && !std::is_final<Allocator>::value>
+class VLAllocatorHolder : private Allocator
+{
+public:
+    /**
+     * @brief Constructs the holder.
+     * @param alloc the allocator to hold.
+     */
+    explicit VLAllocatorHolder(const Allocator &alloc) : Allocator(alloc)
+    {
+    }
+
+    /**
+     * @brief Returns the held allocator.
+     * @return the held allocator.
+     */
+    Allocator &getAllocator() noexcept
+    {
+        return *this;
+    }
+
+    /**
+     * @brief Returns the held allocator.
+     * @return the held allocator.
+     */
+    const Allocator &getAllocator() const noexcept
+    {
+        return *this;
+    }
+};
+
+/**
+ * @brief Holds a stateful (or final) allocator as a member.
+ * @tparam Allocator the allocator type.
+ */
+template<typename Allocator>
+class VLAllocatorHolder<Allocator, false>
+{
+private:
+    Allocator _allocator;
+
+public:
+    /**
+     * @brief Constructs the holder.
+     * @param alloc the allocator to hold.
+     */
+    explicit VLAllocatorHolder(const Allocator &alloc) : _allocator(alloc)
+    {
+    }
+
+    /**
+     * @brief Returns the held allocator.
+     * @return the held allocator.
+     */
+    Allocator &getAllocator() noexcept
+    {
+        return _allocator;
+    }
+
+    /**
+     * @brief Returns the held allocator.
+     * @return the held allocator.
+     */
+    const Allocator &getAllocator() const noexcept
+    {
+        return _allocator;
+    }
+};
+
 /**
  * @brief Represents a Virtual Length Vector object.
+ * Elements are only constructed while they are in use, so T does not have to be
+ * default constructible.
  * @tparam T the type of values stored in the vector.
  * @tparam StaticCapacity the amount of space the vector will occupy on the stack.
+ * @tparam GrowthPolicy decides how the heap capacity grows and when to return to the stack.
+ * @tparam Allocator the allocator used for the heap storage and for constructing elements.
+ * @tparam SizeType the unsigned type used to store the size and the capacity. A smaller type
+ * (e.g. uint32_t) makes the vector object smaller but limits max_size().
  */
-template<typename T, size_t StaticCapacity = DEF_STATIC_CAPACITY>
+template<typename T, size_t StaticCapacity = DEF_STATIC_CAPACITY,
+        typename GrowthPolicy = VLDefaultGrowthPolicy, typename Allocator = std::allocator<T>,
+        typename SizeType = std::size_t>
 class VLVector
 {
 private:
+    typedef std::allocator_traits<Allocator> _AllocTraits;
+
+#if __cplusplus >= 201703L
+    typedef typename _AllocTraits::is_always_equal _AllocAlwaysEqual;
+#else
+    typedef std::is_empty<Allocator> _AllocAlwaysEqual;
+#endif
+
+    static_assert(std::is_unsigned<SizeType>::value, "SizeType must be an unsigned type");
+    static_assert(StaticCapacity <= std::numeric_limits<SizeType>::max(),
+                  "StaticCapacity must fit in SizeType");
+
+    static_assert(std::is_same<typename Allocator::value_type, T>::value,
+                  "The allocator must allocate values of type T");
+    static_assert(std::is_same<typename _AllocTraits::pointer, T *>::value,
+                  "The allocator must use raw pointers");
+
+#ifdef VLVECTOR_CHECKED_ITERATORS
+    typedef std::true_type _CheckedIterators;
+#else
+    typedef std::false_type _CheckedIterators;
+#endif
+
+    /**
+     * @brief The statistics hooks of the vector, which count spills, reallocations, returns to
+     * the stack, copied and moved elements and the peak size of this instantiation when
+     * VLVECTOR_ENABLE_STATS is defined.
+     */
+#ifdef VLVECTOR_ENABLE_STATS
+    typedef VLVectorStats<VLVector> _Stats;
+#else
+    typedef VLNoStats _Stats;
+#endif
+
+    /**
+     * @brief Enables a method template only for iterator types.
+     */
+    template<typename Iterator>
+    using _RequireInputIterator = typename std::enable_if<std::is_convertible<
+            typename std::iterator_traits<Iterator>::iterator_category,
+            std::input_iterator_tag>::value>::type;
+
     /********************************************************************
     *                             Class members                         *
     ********************************************************************/
-    bool _stackMode;
-    std::size_t _size;
-    std::size_t _capacity;
-    T _stackVec[StaticCapacity];
-    T *_heapVec;
+
+    /**
+     * @brief The element storage. The inline elements and the heap pointer share the same bytes,
+     * since only one of them is in use at a time. An empty allocator takes no space.
+     */
+    struct _Storage : VLAllocatorHolder<Allocator>
+    {
+        union
+        {
+            // Raw storage for the inline elements - slots are only constructed while they are in use:
+            alignas(T) unsigned char stackVec[sizeof(T) * StaticCapacity];
+            T *heapVec;
+        };
+
+        explicit _Storage(const Allocator &alloc) : VLAllocatorHolder<Allocator>(alloc), heapVec(nullptr)
+        {
+        }
+    };
+
+    // The vector is in stack mode iff its capacity does not exceed the static capacity -
+    // a heap capacity is always greater than the static capacity:
+    SizeType _size;
+    SizeType _capacity;
+    _Storage _storage;
+
+#ifdef VLVECTOR_ENABLE_PROFILER
+    // The call-site tag and peak size of the vector, collected by the size profiler:
+    VLProfileRecord _profile;
+#endif
+
+    /**
+     * @brief Checks if the elements are stored on the stack.
+     * @return true iff the vector is in stack mode.
+     */
+    bool _isStackMode() const noexcept
+    {
+        return _capacity <= StaticCapacity;
+    }
+
+    /**
+     * @brief Records a size the vector reached in the statistics and in the size profile.
+     * @param size the size of the vector.
+     */
+    void _recordSize(std::size_t size) noexcept
+    {
+        _Stats::size(size);
+#ifdef VLVECTOR_ENABLE_PROFILER
+        _profile.recordSize(size);
+#else
+        (void) size;
+#endif
+    }
+
+    /**
+     * @brief Gives a new vector the call-site tag of the vector it is copied from.
+     * @param other the vector to take the tag from.
+     */
+    void _inheritProfileTag(const VLVector &other) noexcept
+    {
+#ifdef VLVECTOR_ENABLE_PROFILER
+        _profile.setTag(other._profile.tag());
+#else
+        (void) other;
+#endif
+    }
+
+    /**
+     * @brief Gives a new vector the profile record of the vector it is moved from: its tag, its
+     * peak size and whether it is sampled. The moved-from vector no longer submits its sizes,
+     * so a vector moved from one object to another is still recorded once.
+     * @param other the vector to take the record from.
+     */
+    void _takeProfile(VLVector &other) noexcept
+    {
+#ifdef VLVECTOR_ENABLE_PROFILER
+        _profile.takeFrom(other._profile);
+#else
+        (void) other;
+#endif
+    }
+
+    /**
+     * @brief Returns the allocator of the vector.
+     * @return the allocator of the vector.
+     */
+    Allocator &_getAllocator() noexcept
+    {
+        return _storage.getAllocator();
+    }
+
+    /**
+     * @brief Returns the allocator of the vector.
+     * @return the allocator of the vector.
+     */
+    const Allocator &_getAllocator() const noexcept
+    {
+        return _storage.getAllocator();
+    }
 
     /********************************************************************
      *                             Iterator                             *
      ********************************************************************/
 
     /**
-     * @brief An iterator for the vector.
+     * @brief A bounds checked iterator for the vector, used instead of plain pointers when
+     * VLVECTOR_CHECKED_ITERATORS is defined.
+     * Iterators compare by position only, dereferencing or moving an iterator outside the
+     * elements of its vector fails an assertion.
      */
     template<typename Val>
     class VLVectorIterator
     {
     private:
-        unsigned int _index;
-        std::size_t _size;
-        Val *_vec;
+        template<typename> friend class VLVectorIterator;
+
+        Val *_ptr;
+        Val *_first;
+        Val *_last;
 
     public:
 
         /**
          * @brief Iterator traits.
          */
-        typedef Val value_type;
+        typedef typename std::remove_const<Val>::type value_type;
         typedef Val *pointer;
         typedef Val &reference;
         typedef std::ptrdiff_t difference_type;
         typedef std::random_access_iterator_tag iterator_category;
+#if __cplusplus > 201703L
+        typedef std::contiguous_iterator_tag iterator_concept;
+#endif
+
+        /**
+         * @brief Constructs a singular iterator that does not point into any vector.
+         */
+        VLVectorIterator() : _ptr(nullptr), _first(nullptr), _last(nullptr)
+        {
+        }
 
         /**
          * @brief Constructor for iterator objects.
-         * Initialises the iterator to point at the first element in the vector.
-         * @param index the index this iterator points at.
-         * @param size the size of the vector this iterator will iterate over
-         * @param vec the vector this iterator will iterate over
+         * @param ptr the element this iterator points at.
+         * @param first the first element of the vector this iterator will iterate over.
+         * @param last the end of the vector this iterator will iterate over.
+         */
+        VLVectorIterator(Val *ptr, Val *first, Val *last) : _ptr(ptr), _first(first), _last(last)
+        {
+        }
+
+        /**
+         * @brief Converts a non-const iterator to a const iterator.
+         * @param other the iterator to convert.
          */
-        VLVectorIterator(unsigned int index, size_t size, Val *vec)
-                : _index(index), _size(size), _vec(vec)
+        template<typename Other,
+                typename = typename std::enable_if<std::is_convertible<Other *, Val *>::value>::type>
+        VLVectorIterator(const VLVectorIterator<Other> &other)
+                : _ptr(other._ptr), _first(other._first), _last(other._last)
         {
         }
 
@@ -74,7 +460,8 @@ private:
          */
         Val &operator*() const
         {
-            return _vec[_index];
+            assert(_ptr >= _first && _ptr < _last && "VLVector iterator is not dereferenceable");
+            return *_ptr;
         }
 
         /**
@@ -83,7 +470,7 @@ private:
          */
         Val *operator->() const
         {
-            return &_vec[_index];
+            return &operator*();
         }
 
         /**
@@ -92,11 +479,7 @@ private:
          */
         VLVectorIterator &operator++()
         {
-            if (_index < _size)
-            {
-                ++_index;
-            }
-            return *this;
+            return operator+=(1);
         }
 
         /**
@@ -106,10 +489,7 @@ private:
         VLVectorIterator operator++(int)
         {
             VLVectorIterator temp = *this;
-            if (_index < _size)
-            {
-                ++_index;
-            }
+            operator+=(1);
             return temp;
         }
 
@@ -119,11 +499,7 @@ private:
          */
         VLVectorIterator &operator--()
         {
-            if (_index > 0)
-            {
-                --_index;
-            }
-            return *this;
+            return operator-=(1);
         }
 
         /**
@@ -133,10 +509,7 @@ private:
         VLVectorIterator operator--(int)
         {
             VLVectorIterator temp = *this;
-            if (_index > 0)
-            {
-                --_index;
-            }
+            operator-=(1);
             return temp;
         }
 
@@ -152,6 +525,18 @@ private:
             return res.operator+=(distance);
         }
 
+        /**
+         * @brief Returns an iterator that points to the value that is stored in a given
+         * distance after an iterator.
+         * @param distance the distance between the iterator to the result.
+         * @param it the iterator.
+         * @return the result of the addition.
+         */
+        friend VLVectorIterator operator+(const difference_type distance, const VLVectorIterator &it)
+        {
+            return it + distance;
+        }
+
         /**
          * @brief Returns an iterator that points to the value that is stored in a given
          * distance before this iterator.
@@ -165,14 +550,14 @@ private:
         }
 
         /**
-         * @brief Returns an iterator that points to the value that is stored in a given
-         * distance before this iterator.
-         * @param distance the distance between this iterator to the result.
-         * @return the result of the subtraction.
+         * @brief Returns the distance between this iterator and another iterator.
+         * @param other the other iterator.
+         * @return the amount of elements between the iterators.
          */
         difference_type operator-(const VLVectorIterator &other) const
         {
-            return _index - other._index;
+            assert(_first == other._first && "VLVector iterators belong to different vectors");
+            return _ptr - other._ptr;
         }
 
         /**
@@ -183,10 +568,9 @@ private:
          */
         VLVectorIterator &operator+=(const difference_type distance)
         {
-            if (std::size_t(_index + distance) <= _size)
-            {
-                _index += distance;
-            }
+            assert(distance >= _first - _ptr && distance <= _last - _ptr &&
+                   "VLVector iterator moved out of range");
+            _ptr += distance;
             return *this;
         }
 
@@ -198,11 +582,7 @@ private:
          */
         VLVectorIterator &operator-=(const difference_type distance)
         {
-            if (_index - distance >= 0)
-            {
-                _index -= distance;
-            }
-            return *this;
+            return operator+=(-distance);
         }
 
         /**
@@ -210,51 +590,29 @@ private:
          * @param i the interval.
          * @return the value that is stored i steps from the position this iterator is at.
          */
-        Val &operator[](const difference_type i) const noexcept
+        Val &operator[](const difference_type i) const
         {
-            if (_index + i < _size)
-            {
-                return _vec[_index + i];
-            }
+            return *(*this + i);
         }
 
         /**
-         * @brief Checks if the iterator points to the same element that another iterator points to.
+         * @brief Checks if the iterator points to the same position as another iterator.
          * @param other the other iterator.
-         * @return true iff both iterators point to the same element.
+         * @return true iff both iterators point to the same position.
          */
         bool operator==(const VLVectorIterator &other) const
         {
-            //Edge case: both iterators are end():
-            if (_index == _size && other._index == other._size)
-            {
-                return true;
-            }
-
-            //Edge case: one of the iterators is end() but the other isn't:
-            if (_index != _size && other._index == other._size)
-            {
-                return false;
-            }
-
-            //Edge case: same as previous, the other way around:
-            if (_index == _size && other._index != other._size)
-            {
-                return false;
-            }
-
-            return _index == other._index && *(*this) == *other;
+            return _ptr == other._ptr;
         }
 
         /**
-         * @brief Checks if the iterator doesn't point to a the same element
-         * that another iterator points to.
+         * @brief Checks if the iterator doesn't point to the same position as another iterator.
          * @param other the other iterator.
-         * @return true iff the iterators don't point to the same element.
+         * @return true iff the iterators don't point to the same position.
          */
         bool operator!=(const VLVectorIterator &other) const
         {
-            return !operator==(other);
+            return _ptr != other._ptr;
         }
 
         /**
@@ -266,7 +624,7 @@ private:
          */
         bool operator<(const VLVectorIterator &other) const
         {
-            return _index < other._index;
+            return _ptr < other._ptr;
         }
 
         /**
@@ -278,7 +636,7 @@ private:
          */
         bool operator>(const VLVectorIterator &other) const
         {
-            return _index > other._index;
+            return _ptr > other._ptr;
         }
 
         /**
@@ -306,145 +664,1276 @@ private:
         }
     };
 
-    /********************************************************************
-    *                  Capacity increase-decrease methods               *
-    ********************************************************************/
-
     /**
-     * @brief Copies the elements of the vector from the stack to the heap.
-     * Sets the flag stackMode to false.
+     * @brief Returns an iterator to a given element of the vector.
+     * @param ptr pointer to an element of the vector or to its end.
+     * @return an iterator that points at the element.
      */
-    void _copyToHeap()
+    VLVectorIterator<T> _makeIterator(T *ptr, std::true_type)
     {
-        _stackMode = false;
-        _heapVec = new T[_capacity];
-        for (int i = 0; i < (int) StaticCapacity; ++i)
-        {
-            _heapVec[i] = _stackVec[i];
-        }
+        return VLVectorIterator<T>(ptr, data(), data() + _size);
     }
 
     /**
-     * @brief Copies the elements of the vector from the heap to the stack.
-     * Sets the flag stackMode to true.
+     * @brief Returns a const iterator to a given element of the vector.
+     * @param ptr pointer to an element of the vector or to its end.
+     * @return a const iterator that points at the element.
      */
-    void _copyToStack()
+    VLVectorIterator<const T> _makeIterator(const T *ptr, std::true_type) const
     {
-        _stackMode = true;
-        for (int i = 0; i < (int) _size; ++i)
-        {
-            _stackVec[i] = _heapVec[i];
-        }
-        delete[] _heapVec;
-        _heapVec = nullptr;
+        return VLVectorIterator<const T>(ptr, data(), data() + _size);
     }
 
     /**
-     * @brief Increases the size of the vector on heap.
-     * @param newCapacity the new capacity of the vector.
+     * @brief Returns a pointer to a given element, which is the unchecked iterator.
      */
-    void _increaseHeap(size_t newCapacity)
+    template<typename Pointer>
+    static Pointer _makeIterator(Pointer ptr, std::false_type)
     {
-        T *newHeap = new T[newCapacity];
-        for (int i = 0; i < (int) _size; ++i)
-        {
-            newHeap[i] = _heapVec[i];
-        }
-        _capacity = newCapacity;
-        delete[] _heapVec;
-        _heapVec = newHeap;
+        return ptr;
     }
 
-public:
+    /********************************************************************
+    *                     Element lifetime methods                      *
+    ********************************************************************/
 
     /**
-     * @brief Typedefs for const and non-const iterators for the vector.
+     * @brief Returns a pointer to the first inline slot.
+     * @return a pointer to the first inline slot.
      */
-    typedef VLVectorIterator<T> iterator;
-    typedef VLVectorIterator<const T> const_iterator;
+    T *_stackData() noexcept
+    {
+        return reinterpret_cast<T *>(_storage.stackVec);
+    }
 
-    /********************************************************************
-    *                       Rule of 5 methods                           *
-    ********************************************************************/
+    /**
+     * @brief Returns a pointer to the first inline slot.
+     * @return a pointer to the first inline slot.
+     */
+    const T *_stackData() const noexcept
+    {
+        return reinterpret_cast<const T *>(_storage.stackVec);
+    }
 
     /**
-     * @brief Copy constructor.
-     * @param other the vector to copy from.
+     * @brief Allocates uninitialised heap storage for a given amount of elements.
+     * @param count the amount of elements the storage should fit.
+     * @return a pointer to the allocated storage.
      */
-    VLVector(const VLVector &other)
-            : _stackMode(other._stackMode), _size(other._size), _capacity(other._capacity),
-              _heapVec(nullptr)
+    T *_allocate(std::size_t count)
     {
-        if (_stackMode)
-        {
-            std::copy(other._stackVec, other._stackVec + StaticCapacity, _stackVec);
-        }
-        else
+        if (count > max_size())
         {
-            _heapVec = new T[_capacity];
-            std::copy(other._heapVec, other._heapVec + _size, _heapVec);
+            throw std::length_error(LENGTH_EXCEPTION_MSG);
         }
+        return _AllocTraits::allocate(_getAllocator(), count);
     }
 
     /**
-     * @brief Move constructor.
-     * @param other the vector to move from.
+     * @brief Releases heap storage that was allocated by _allocate.
+     * @param storage the storage to release.
+     * @param count the amount of elements the storage was allocated for.
      */
-    VLVector(VLVector && other) noexcept
-            : _stackMode(other._stackMode), _size(other._size), _capacity(other._capacity)
+    void _deallocate(T *storage, std::size_t count) noexcept
     {
-        std::copy(other._stackVec, other._stackVec + StaticCapacity, _stackVec);
-        _heapVec = other._heapVec;
-        other._heapVec = nullptr;
-        other._size = 0;
-        other._capacity = 0;
+        _AllocTraits::deallocate(_getAllocator(), storage, count);
     }
 
     /**
-     * @brief Destructor.
+     * @brief Constructs an element in an uninitialised slot.
+     * @param slot the slot to construct the element in.
+     * @param args the arguments to pass to the constructor of T.
      */
-    ~VLVector()
+    template<typename... Args>
+    void _construct(T *slot, Args &&... args)
     {
-        delete[] _heapVec;
+        _AllocTraits::construct(_getAllocator(), slot, std::forward<Args>(args)...);
     }
 
     /**
-     * @brief Implements the "swap" part of the "Copy and Swap" idiom.
-     * @param first the vector to assign to.
-     * @param second the vector to assign from.
+     * @brief Destroys the elements in a given range, leaving their slots uninitialised.
+     * @param first pointer to the first element to destroy.
+     * @param last pointer past the last element to destroy.
      */
-    friend void swap(VLVector &first, VLVector &second) noexcept
+    void _destroy(T *first, T *last) noexcept
     {
-        using std::swap;
-        swap(first._stackMode, second._stackMode);
-        swap(first._size, second._size);
-        swap(first._capacity, second._capacity);
-        swap(first._stackVec, second._stackVec);
-        swap(first._heapVec, second._heapVec);
+        for (; first != last; ++first)
+        {
+            _AllocTraits::destroy(_getAllocator(), first);
+        }
     }
 
     /**
-     * @brief Assignment operator, implementing the "Copy and Swap" idiom.
-     * Implements both regular and move assignment operator since other is received by value,
-     * thus received via copy constructor for l-values and via move constructor for r-values.
-     * @param other the other vector to assign from.
-     * @return this vector after assignment.
+     * @brief Copy constructs the elements of a given range into uninitialised slots.
+     * If a constructor throws, the elements that were already constructed are destroyed.
+     * @param first pointer to the first element to copy.
+     * @param last pointer past the last element to copy.
+     * @param dest pointer to the first uninitialised slot.
      */
-    VLVector &operator=(VLVector other)
+    void _uninitializedCopy(const T *first, const T *last, T *dest)
     {
-        swap(*this, other);
-        return *this;
+        _Stats::copied(last - first);
+        _uninitializedCopy(first, last, dest, std::is_trivially_copyable<T>());
     }
 
-    /********************************************************************
-    *                       Given API methods                           *
-    ********************************************************************/
-
     /**
-     * @brief Default constructor. Initialises an empty VLVector.
+     * @brief Copies trivially copyable elements with a single memcpy.
      */
-    VLVector() : _stackMode(true), _size(0), _capacity(StaticCapacity), _heapVec(nullptr)
+    static void _uninitializedCopy(const T *first, const T *last, T *dest, std::true_type) noexcept
     {
+        if (first != last)
+        {
+            std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first),
+                        (last - first) * sizeof(T));
+        }
+    }
+
+    /**
+     * @brief Copy constructs elements one by one.
+     */
+    void _uninitializedCopy(const T *first, const T *last, T *dest, std::false_type)
+    {
+        T *current = dest;
+        try
+        {
+            for (; first != last; ++first, ++current)
+            {
+                _construct(current, *first);
+            }
+        }
+        catch (...)
+        {
+            _destroy(dest, current);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Copy constructs a given amount of elements read from an iterator into
+     * uninitialised slots.
+     * If a constructor throws, the elements that were already constructed are destroyed.
+     * @tparam InputIterator the type of iterator to T values.
+     * @param first iterator to the first element to copy.
+     * @param count the amount of elements to copy.
+     * @param dest pointer to the first uninitialised slot.
+     * @return an iterator past the last element that was copied.
+     */
+    template<typename InputIterator>
+    InputIterator _uninitializedCopyN(InputIterator first, std::size_t count, T *dest)
+    {
+        T *current = dest;
+        try
+        {
+            for (; count > 0; --count, ++first, ++current)
+            {
+                _construct(current, *first);
+            }
+        }
+        catch (...)
+        {
+            _destroy(dest, current);
+            throw;
+        }
+        return first;
+    }
+
+    /**
+     * @brief Copies a given amount of elements from a pointer, with a single memcpy when the
+     * elements are trivially copyable.
+     */
+    const T *_uninitializedCopyN(const T *first, std::size_t count, T *dest)
+    {
+        _uninitializedCopy(first, first + count, dest);
+        return first + count;
+    }
+
+    /**
+     * @brief Constructs the elements of a given range into uninitialised slots using
+     * move_if_noexcept, leaving the source range intact if a constructor throws.
+     * @param first pointer to the first element to move.
+     * @param last pointer past the last element to move.
+     * @param dest pointer to the first uninitialised slot.
+     */
+    void _uninitializedMoveIfNoexcept(T *first, T *last, T *dest)
+    {
+        T *current = dest;
+        try
+        {
+            for (; first != last; ++first, ++current)
+            {
+                _construct(current, std::move_if_noexcept(*first));
+            }
+        }
+        catch (...)
+        {
+            _destroy(dest, current);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Relocates the elements of a given range into uninitialised slots,
+     * leaving the source slots uninitialised.
+     * Elements are moved if their move constructor does not throw and copied otherwise, so if
+     * a constructor throws the source range is left intact.
+     * @param first pointer to the first element to relocate.
+     * @param last pointer past the last element to relocate.
+     * @param dest pointer to the first uninitialised slot.
+     */
+    void _relocate(T *first, T *last, T *dest)
+    {
+        _Stats::moved(last - first);
+        _relocate(first, last, dest, VLTriviallyRelocatable<T>());
+    }
+
+    /**
+     * @brief Relocates trivially relocatable elements with a single memcpy.
+     */
+    static void _relocate(T *first, T *last, T *dest, std::true_type) noexcept
+    {
+        if (first != last)
+        {
+            std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first),
+                        (last - first) * sizeof(T));
+        }
+    }
+
+    /**
+     * @brief Relocates elements one by one using move_if_noexcept.
+     */
+    void _relocate(T *first, T *last, T *dest, std::false_type)
+    {
+        _uninitializedMoveIfNoexcept(first, last, dest);
+        _destroy(first, last);
+    }
+
+    /**
+     * @brief Relocates the elements of the vector into new uninitialised storage, leaving a gap
+     * of uninitialised slots at a given index. If a constructor throws, the vector is left intact.
+     * @param dest pointer to the new storage.
+     * @param index the index of the gap.
+     * @param gap the amount of uninitialised slots to leave.
+     */
+    void _relocateAround(T *dest, std::size_t index, std::size_t gap)
+    {
+        _Stats::moved(_size);
+        _relocateAround(dest, index, gap, VLTriviallyRelocatable<T>());
+    }
+
+    /**
+     * @brief Relocates trivially relocatable elements around the gap with two memcpy calls.
+     */
+    void _relocateAround(T *dest, std::size_t index, std::size_t gap, std::true_type) noexcept
+    {
+        T *vec = data();
+        _relocate(vec, vec + index, dest, std::true_type());
+        _relocate(vec + index, vec + _size, dest + index + gap, std::true_type());
+    }
+
+    /**
+     * @brief Relocates elements around the gap one by one, destroying the sources only after all
+     * elements were constructed.
+     */
+    void _relocateAround(T *dest, std::size_t index, std::size_t gap, std::false_type)
+    {
+        T *vec = data();
+        _uninitializedMoveIfNoexcept(vec, vec + index, dest);
+        try
+        {
+            _uninitializedMoveIfNoexcept(vec + index, vec + _size, dest + index + gap);
+        }
+        catch (...)
+        {
+            _destroy(dest, dest + index);
+            throw;
+        }
+        _destroy(vec, vec + _size);
+    }
+
+    /********************************************************************
+    *                  Capacity increase-decrease methods               *
+    ********************************************************************/
+
+    /**
+     * @brief Relocates the elements of the vector from the stack to the heap.
+     * The new capacity exceeds the static capacity, which puts the vector in heap mode.
+     * @param newCapacity the capacity of the vector on the heap.
+     */
+    void _copyToHeap(std::size_t newCapacity)
+    {
+        T *newHeap = _allocate(newCapacity);
+        try
+        {
+            _relocate(_stackData(), _stackData() + _size, newHeap);
+        }
+        catch (...)
+        {
+            _deallocate(newHeap, newCapacity);
+            throw;
+        }
+        _storage.heapVec = newHeap;
+        _capacity = newCapacity;
+        _Stats::spill();
+    }
+
+    /**
+     * @brief Relocates the elements of the vector from the heap to the stack.
+     * Sets the capacity to the static capacity, which puts the vector in stack mode.
+     */
+    void _copyToStack()
+    {
+        // The inline elements overwrite the heap pointer, so it is kept aside:
+        T *heap = _storage.heapVec;
+        try
+        {
+            _relocate(heap, heap + _size, _stackData());
+        }
+        catch (...)
+        {
+            _storage.heapVec = heap;
+            throw;
+        }
+        _deallocate(heap, _capacity);
+        _capacity = StaticCapacity;
+        _Stats::returnToStack();
+    }
+
+    /**
+     * @brief Reallocates the vector on heap with a new capacity.
+     * @param newCapacity the new capacity of the vector, which must fit all its elements.
+     */
+    void _increaseHeap(std::size_t newCapacity)
+    {
+        if (_reallocateHeap(newCapacity, std::integral_constant<bool,
+                VLAllocatorCanReallocate<Allocator>::value && VLTriviallyRelocatable<T>::value>()))
+        {
+            return;
+        }
+        T *newHeap = _allocate(newCapacity);
+        try
+        {
+            _relocate(_storage.heapVec, _storage.heapVec + _size, newHeap);
+        }
+        catch (...)
+        {
+            _deallocate(newHeap, newCapacity);
+            throw;
+        }
+        _deallocate(_storage.heapVec, _capacity);
+        _capacity = newCapacity;
+        _storage.heapVec = newHeap;
+        _Stats::reallocation();
+    }
+
+    /**
+     * @brief Lets the allocator resize the heap storage without copying the elements, which is
+     * only valid since the elements are trivially relocatable.
+     * @param newCapacity the new capacity of the vector, which must fit all its elements.
+     * @return true iff the allocator resized the storage.
+     */
+    bool _reallocateHeap(std::size_t newCapacity, std::true_type)
+    {
+        if (newCapacity > max_size())
+        {
+            throw std::length_error(LENGTH_EXCEPTION_MSG);
+        }
+        T *newHeap = _getAllocator().reallocate(_storage.heapVec, _capacity, newCapacity);
+        if (newHeap == nullptr)
+        {
+            return false;
+        }
+        _capacity = newCapacity;
+        _storage.heapVec = newHeap;
+        _Stats::reallocation();
+        return true;
+    }
+
+    /**
+     * @brief The allocator cannot resize storage, or the elements must be moved one by one.
+     */
+    bool _reallocateHeap(std::size_t, std::false_type) noexcept
+    {
+        return false;
+    }
+
+    /**
+     * @brief Changes the capacity of the vector, moving it between the stack and the heap
+     * if needed. A capacity that fits in the static capacity moves the vector to the stack.
+     * @param newCapacity the new capacity of the vector, which must fit all its elements.
+     */
+    void _setCapacity(std::size_t newCapacity)
+    {
+        if (_isStackMode())
+        {
+            if (newCapacity > StaticCapacity)
+            {
+                _copyToHeap(newCapacity);
+            }
+        }
+        else if (newCapacity <= StaticCapacity)
+        {
+            _copyToStack();
+        }
+        else if (newCapacity != _capacity)
+        {
+            _increaseHeap(newCapacity);
+        }
+    }
+
+    /**
+     * @brief Returns the capacity to grow to: the capacity the growth policy picks, clamped to
+     * max_size(), and at least a given size.
+     * @param newSize the size the vector should be able to hold.
+     * @return the new capacity.
+     */
+    std::size_t _grownCapacity(std::size_t newSize) const noexcept
+    {
+        return std::max(newSize, std::min(GrowthPolicy::grow(_size + 1), max_size()));
+    }
+
+    /**
+     * @brief Makes room for one more element, moving the vector to the heap
+     * or increasing its heap capacity if needed.
+     */
+    void _growIfFull()
+    {
+        if (_size < _capacity)
+        {
+            return;
+        }
+        std::size_t newCapacity = _grownCapacity(_size + 1);
+
+        // We are in stack mode - values are stored on the stack,
+        // and the static capacity is exhausted:
+        if (_isStackMode())
+        {
+            _copyToHeap(newCapacity);
+        }
+        else
+        {
+            // We are in heap mode - values are stored on the heap,
+            // and the capacity needs to be increased:
+            _increaseHeap(newCapacity);
+        }
+    }
+
+    /**
+     * @brief Moves the vector back to the stack if following a removal
+     * the growth policy decides it should return there.
+     */
+    void _shrinkIfNeeded()
+    {
+        if (!_isStackMode() && GrowthPolicy::shouldReturnToStack(_size, StaticCapacity))
+        {
+            _copyToStack();
+        }
+    }
+
+    /**
+     * @brief Makes sure the vector can hold a given size, growing by the growth policy so that
+     * repeated growth by small steps reallocates only a logarithmic amount of times.
+     * @param newSize the size the vector should be able to hold.
+     */
+    void _reserveForSize(std::size_t newSize)
+    {
+        if (newSize > _capacity)
+        {
+            _setCapacity(_grownCapacity(newSize));
+        }
+    }
+
+    /**
+     * @brief Destroys the elements after a given size.
+     * @param newSize the new size of the vector, which must not exceed its current size.
+     */
+    void _truncate(std::size_t newSize)
+    {
+        _destroy(data() + newSize, data() + _size);
+        _size = newSize;
+        _shrinkIfNeeded();
+    }
+
+    /**
+     * @brief Appends copies of a given value until the vector reaches a given size.
+     * The vector must already have the capacity for that size.
+     * @param newSize the new size of the vector.
+     * @param val the value to copy.
+     */
+    void _fill(std::size_t newSize, const T &val)
+    {
+        T *vec = data();
+        T *current = vec + _size;
+        try
+        {
+            for (; current != vec + newSize; ++current)
+            {
+                _construct(current, val);
+            }
+        }
+        catch (...)
+        {
+            _destroy(vec + _size, current);
+            throw;
+        }
+        _size = newSize;
+        _recordSize(_size);
+    }
+
+    /**
+     * @brief Move constructs the elements of a given range into uninitialised slots.
+     * If a constructor throws, the elements that were already constructed are destroyed.
+     * @param first pointer to the first element to move.
+     * @param last pointer past the last element to move.
+     * @param dest pointer to the first uninitialised slot.
+     */
+    void _uninitializedMove(T *first, T *last, T *dest)
+    {
+        _Stats::moved(last - first);
+        T *current = dest;
+        try
+        {
+            for (; first != last; ++first, ++current)
+            {
+                _construct(current, std::move(*first));
+            }
+        }
+        catch (...)
+        {
+            _destroy(dest, current);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Takes the elements of another vector, leaving it empty.
+     * The heap storage of the other vector is taken as is if both vectors use equal allocators,
+     * otherwise the elements are moved one by one.
+     * This vector must be empty and in stack mode.
+     * @param other the vector to take the elements from.
+     */
+    void _takeFrom(VLVector &other)
+    {
+        if (!other._isStackMode() && _getAllocator() == other._getAllocator())
+        {
+            _storage.heapVec = other._storage.heapVec;
+            _capacity = other._capacity;
+            _size = other._size;
+            _recordSize(_size);
+            other._capacity = StaticCapacity;
+            other._size = 0;
+            return;
+        }
+        _setCapacity(other._size);
+        _takeElements(other, VLTriviallyRelocatable<T>());
+        _recordSize(_size);
+        other.clear();
+    }
+
+    /**
+     * @brief Relocates the elements of another vector into the storage of this vector with a
+     * single memcpy, leaving the other vector with no elements.
+     * @param other the vector to take the elements from.
+     */
+    void _takeElements(VLVector &other, std::true_type) noexcept
+    {
+        _relocate(other.data(), other.data() + other._size, data());
+        _size = other._size;
+        other._size = 0;
+    }
+
+    /**
+     * @brief Move constructs the elements of another vector into the storage of this vector,
+     * leaving the moved-from elements in the other vector.
+     * @param other the vector to take the elements from.
+     */
+    void _takeElements(VLVector &other, std::false_type)
+    {
+        _uninitializedMove(other.data(), other.data() + other._size, data());
+        _size = other._size;
+    }
+
+    /**
+     * @brief Swaps the elements of two vectors in stack mode by swapping the bytes of the live
+     * slots of trivially relocatable elements.
+     * @param other the vector to swap with.
+     */
+    void _swapInline(VLVector &other, std::true_type) noexcept
+    {
+        const std::size_t bytes = std::max<std::size_t>(_size, other._size) * sizeof(T);
+        std::swap_ranges(_storage.stackVec, _storage.stackVec + bytes, other._storage.stackVec);
+        std::swap(_size, other._size);
+    }
+
+    /**
+     * @brief Swaps the elements of two vectors in stack mode: the common prefix is swapped
+     * element by element and the rest of the longer vector is relocated to the shorter one.
+     * @param other the vector to swap with.
+     */
+    void _swapInline(VLVector &other, std::false_type)
+    {
+        VLVector &longer = _size >= other._size ? *this : other;
+        VLVector &shorter = _size >= other._size ? other : *this;
+        const std::size_t common = shorter._size;
+        std::swap_ranges(longer.data(), longer.data() + common, shorter.data());
+        shorter._relocate(longer.data() + common, longer.data() + longer._size,
+                          shorter.data() + common);
+        std::swap(_size, other._size);
+    }
+
+    /**
+     * @brief Swaps the elements of this vector, which is in heap mode, with the elements of a
+     * vector in stack mode: the heap storage is handed over and the inline elements are
+     * relocated into this vector.
+     * @param other the vector in stack mode to swap with.
+     */
+    void _swapHeapWithInline(VLVector &other)
+    {
+        // The inline elements overwrite the heap pointer, so it is kept aside:
+        T *heap = _storage.heapVec;
+        const SizeType capacity = _capacity;
+        try
+        {
+            _relocate(other.data(), other.data() + other._size, _stackData());
+        }
+        catch (...)
+        {
+            _storage.heapVec = heap;
+            throw;
+        }
+        _capacity = StaticCapacity;
+        other._storage.heapVec = heap;
+        other._capacity = capacity;
+        std::swap(_size, other._size);
+    }
+
+    /**
+     * @brief Swaps the allocators of two vectors when the allocator propagates on swap.
+     * @param other the vector to swap allocators with.
+     */
+    void _swapAllocators(VLVector &other, std::true_type)
+    {
+        using std::swap;
+        swap(_getAllocator(), other._getAllocator());
+    }
+
+    /**
+     * @brief Keeps the allocators when the allocator does not propagate on swap.
+     */
+    void _swapAllocators(VLVector &, std::false_type)
+    {
+    }
+
+    /********************************************************************
+    *                          Range methods                            *
+    ********************************************************************/
+
+    /**
+     * @brief A forward iterator that yields the same value a given amount of times,
+     * used to insert and assign copies of a single value through the range methods.
+     */
+    class _ValueRepeater
+    {
+    private:
+        const T *_value;
+        std::size_t _index;
+
+    public:
+        typedef T value_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::forward_iterator_tag iterator_category;
+
+        explicit _ValueRepeater(const T &value) : _value(&value), _index(0)
+        {
+        }
+
+        const T &operator*() const
+        {
+            return *_value;
+        }
+
+        _ValueRepeater &operator++()
+        {
+            ++_index;
+            return *this;
+        }
+
+        _ValueRepeater operator++(int)
+        {
+            _ValueRepeater temp = *this;
+            ++_index;
+            return temp;
+        }
+
+        bool operator==(const _ValueRepeater &other) const
+        {
+            return _index == other._index;
+        }
+
+        bool operator!=(const _ValueRepeater &other) const
+        {
+            return _index != other._index;
+        }
+    };
+
+    /**
+     * @brief Replaces the heap storage of the vector (or moves it off the stack) with new
+     * storage that already holds its relocated elements.
+     * @param newHeap the new heap storage.
+     * @param newCapacity the capacity of the new heap storage.
+     */
+    void _adoptHeap(T *newHeap, std::size_t newCapacity) noexcept
+    {
+        if (_isStackMode())
+        {
+            _Stats::spill();
+        }
+        else
+        {
+            _deallocate(_storage.heapVec, _capacity);
+            _Stats::reallocation();
+        }
+        _storage.heapVec = newHeap;
+        _capacity = newCapacity;
+    }
+
+    /**
+     * @brief Inserts a given amount of elements read from a forward iterator at a given index.
+     * The vector reallocates at most once and the tail is shifted a single time.
+     * @tparam ForwardIterator the type of iterator to T values.
+     * @param index the index to insert the elements at.
+     * @param first iterator to the first element to insert.
+     * @param count the amount of elements to insert.
+     */
+    template<typename ForwardIterator>
+    void _insertN(std::size_t index, ForwardIterator first, std::size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (_size + count <= _capacity)
+        {
+            _insertInPlace(index, first, count, VLTriviallyRelocatable<T>());
+            return;
+        }
+
+        // The new elements are constructed in the new storage first, and the existing
+        // elements are relocated around them:
+        std::size_t newCapacity = _grownCapacity(_size + count);
+        T *newHeap = _allocate(newCapacity);
+        try
+        {
+            _uninitializedCopyN(first, count, newHeap + index);
+            try
+            {
+                _relocateAround(newHeap, index, count);
+            }
+            catch (...)
+            {
+                _destroy(newHeap + index, newHeap + index + count);
+                throw;
+            }
+        }
+        catch (...)
+        {
+            _deallocate(newHeap, newCapacity);
+            throw;
+        }
+        _adoptHeap(newHeap, newCapacity);
+        _size += count;
+        _recordSize(_size);
+    }
+
+    /**
+     * @brief Inserts elements into the existing storage of trivially relocatable elements:
+     * the tail is shifted with a single memmove and the new elements are constructed in the gap.
+     */
+    template<typename ForwardIterator>
+    void _insertInPlace(std::size_t index, ForwardIterator first, std::size_t count,
+                        std::true_type)
+    {
+        T *position = data() + index;
+        const std::size_t tailBytes = (_size - index) * sizeof(T);
+        std::memmove(static_cast<void *>(position + count), static_cast<const void *>(position),
+                     tailBytes);
+        try
+        {
+            _uninitializedCopyN(first, count, position);
+        }
+        catch (...)
+        {
+            std::memmove(static_cast<void *>(position), static_cast<const void *>(position + count),
+                         tailBytes);
+            throw;
+        }
+        _size += count;
+        _recordSize(_size);
+    }
+
+    /**
+     * @brief Inserts elements into the existing storage: the elements that move past the old end
+     * are move constructed, the rest of the tail is moved backwards once and the new elements are
+     * assigned over the moved-from values.
+     */
+    template<typename ForwardIterator>
+    void _insertInPlace(std::size_t index, ForwardIterator first, std::size_t count,
+                        std::false_type)
+    {
+        T *position = data() + index;
+        T *oldEnd = data() + _size;
+        const std::size_t elemsAfter = _size - index;
+        if (elemsAfter > count)
+        {
+            _uninitializedMove(oldEnd - count, oldEnd, oldEnd);
+            _size += count;
+            _recordSize(_size);
+            std::move_backward(position, oldEnd - count, oldEnd);
+            for (T *it = position; it != position + count; ++it, ++first)
+            {
+                *it = *first;
+            }
+            return;
+        }
+
+        // The new elements reach past the old end, so the ones that land there are constructed:
+        ForwardIterator mid = first;
+        std::advance(mid, elemsAfter);
+        _uninitializedCopyN(mid, count - elemsAfter, oldEnd);
+        _size += count - elemsAfter;
+        try
+        {
+            _uninitializedMove(position, oldEnd, position + count);
+        }
+        catch (...)
+        {
+            _destroy(oldEnd, oldEnd + count - elemsAfter);
+            _size -= count - elemsAfter;
+            throw;
+        }
+        _size += elemsAfter;
+        _recordSize(_size);
+        std::copy(first, mid, position);
+    }
+
+    /**
+     * @brief Inserts the elements of a forward iterator range at a given index.
+     */
+    template<typename ForwardIterator>
+    void _insertRange(std::size_t index, ForwardIterator first, ForwardIterator last,
+                      std::forward_iterator_tag)
+    {
+        _insertN(index, first, std::distance(first, last));
+    }
+
+    /**
+     * @brief Inserts the elements of a single pass iterator range at a given index.
+     * Elements are appended directly, or collected first if they go before existing elements.
+     */
+    template<typename InputIterator>
+    void _insertRange(std::size_t index, InputIterator first, InputIterator last,
+                      std::input_iterator_tag)
+    {
+        if (index == _size)
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+            return;
+        }
+        VLVector values(first, last, _getAllocator());
+        _insertN(index, std::make_move_iterator(values.data()), values.size());
+    }
+
+    /**
+     * @brief Removes a given amount of trivially relocatable elements at a given index:
+     * the elements are destroyed and the tail is shifted with a single memmove.
+     */
+    void _eraseN(std::size_t index, std::size_t count, std::true_type)
+    {
+        T *position = data() + index;
+        _destroy(position, position + count);
+        std::memmove(static_cast<void *>(position), static_cast<const void *>(position + count),
+                     (_size - index - count) * sizeof(T));
+        _size -= count;
+        _shrinkIfNeeded();
+    }
+
+    /**
+     * @brief Removes a given amount of elements at a given index: the tail is moved over them
+     * once and the moved-from values at the end are destroyed.
+     */
+    void _eraseN(std::size_t index, std::size_t count, std::false_type)
+    {
+        T *vec = data();
+        std::move(vec + index + count, vec + _size, vec + index);
+        _truncate(_size - count);
+    }
+
+    /**
+     * @brief Replaces the elements of the vector with a given amount of elements read from a
+     * forward iterator, assigning over existing elements and reallocating at most once.
+     * @tparam ForwardIterator the type of iterator to T values.
+     * @param first iterator to the first element to assign.
+     * @param count the amount of elements to assign.
+     */
+    template<typename ForwardIterator>
+    void _assignN(ForwardIterator first, std::size_t count)
+    {
+        if (count > _capacity)
+        {
+            _destroy(data(), data() + _size);
+            _size = 0;
+            _setCapacity(count);
+            _uninitializedCopyN(first, count, data());
+            _size = count;
+            _recordSize(_size);
+            return;
+        }
+        T *vec = data();
+        ForwardIterator mid = first;
+        std::advance(mid, std::min<std::size_t>(count, _size));
+        std::copy(first, mid, vec);
+        first = mid;
+        if (count > _size)
+        {
+            _uninitializedCopyN(first, count - _size, vec + _size);
+            _size = count;
+            _recordSize(_size);
+        }
+        else
+        {
+            _truncate(count);
+        }
+    }
+
+    /**
+     * @brief Replaces the elements of the vector with a forward iterator range.
+     */
+    template<typename ForwardIterator>
+    void _assignRange(ForwardIterator first, ForwardIterator last, std::forward_iterator_tag)
+    {
+        _assignN(first, std::distance(first, last));
+    }
+
+    /**
+     * @brief Replaces the elements of the vector with a single pass iterator range.
+     */
+    template<typename InputIterator>
+    void _assignRange(InputIterator first, InputIterator last, std::input_iterator_tag)
+    {
+        _destroy(data(), data() + _size);
+        _size = 0;
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+        _shrinkIfNeeded();
+    }
+
+    /**
+     * @brief Replaces the allocator of this vector with the allocator of another vector.
+     * Used when the allocator propagates, this vector must not own heap storage of an allocator
+     * that differs from the allocator of the other vector.
+     * @param other the vector to take the allocator from.
+     */
+    void _adoptAllocator(const VLVector &other, std::true_type)
+    {
+        _getAllocator() = other._getAllocator();
+    }
+
+    /**
+     * @brief Keeps the allocator of this vector when the allocator does not propagate.
+     */
+    void _adoptAllocator(const VLVector &, std::false_type)
+    {
+    }
+
+    /**
+     * @brief Takes the allocator of a vector this vector is copy assigned from, when the
+     * allocator propagates on copy assignment. Storage of a different allocator is released first.
+     * @param other the vector being copied.
+     */
+    void _copyAssignAllocator(const VLVector &other, std::true_type)
+    {
+        if (!(_getAllocator() == other._getAllocator()))
+        {
+            clear();
+        }
+        _adoptAllocator(other, std::true_type());
+    }
+
+    /**
+     * @brief Keeps the allocator of this vector when the allocator does not propagate on copy
+     * assignment.
+     */
+    void _copyAssignAllocator(const VLVector &, std::false_type)
+    {
+    }
+
+    /**
+     * @brief Move assigns another vector when its storage may be taken as is: the allocator
+     * propagates on move assignment or the allocators are equal.
+     * @param other the vector to move from.
+     */
+    void _moveAssign(VLVector &other, std::true_type)
+            noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        clear();
+        _adoptAllocator(other, typename _AllocTraits::propagate_on_container_move_assignment());
+        _takeFrom(other);
+    }
+
+    /**
+     * @brief Move assigns another vector when the allocator does not propagate on move
+     * assignment: the heap storage is taken if the allocators are equal, otherwise the elements
+     * are moved over the existing elements of this vector, reusing its storage.
+     * @param other the vector to move from.
+     */
+    void _moveAssign(VLVector &other, std::false_type)
+    {
+        if (_getAllocator() == other._getAllocator())
+        {
+            _moveAssign(other, std::true_type());
+            return;
+        }
+        _assignN(std::make_move_iterator(other.data()), other._size);
+        other.clear();
+    }
+
+public:
+
+    /**
+     * @brief Typedefs for const and non-const iterators for the vector.
+     * Iterators are plain pointers, so loops over the vector and standard algorithms compile
+     * the same as over an array. Defining VLVECTOR_CHECKED_ITERATORS switches to bounds checked
+     * iterators.
+     */
+#ifdef VLVECTOR_CHECKED_ITERATORS
+    typedef VLVectorIterator<T> iterator;
+    typedef VLVectorIterator<const T> const_iterator;
+#else
+    typedef T *iterator;
+    typedef const T *const_iterator;
+#endif
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    /**
+     * @brief The element type of the vector.
+     */
+    typedef T value_type;
+
+    /**
+     * @brief The allocator type of the vector.
+     */
+    typedef Allocator allocator_type;
+
+    /********************************************************************
+    *                       Rule of 5 methods                           *
+    ********************************************************************/
+
+    /**
+     * @brief Copy constructor.
+     * The allocator is obtained by select_on_container_copy_construction.
+     * @param other the vector to copy from.
+     */
+    VLVector(const VLVector &other)
+            : VLVector(other, _AllocTraits::select_on_container_copy_construction(other._getAllocator()))
+    {
+    }
+
+    /**
+     * @brief Copy constructor with a given allocator.
+     * @param other the vector to copy from.
+     * @param alloc the allocator of the new vector.
+     */
+    VLVector(const VLVector &other, const Allocator &alloc) : VLVector(alloc)
+    {
+        _inheritProfileTag(other);
+
+        // Only the live elements are copied, onto the stack if they fit there and otherwise
+        // into heap storage of exactly their size:
+        _setCapacity(other._size);
+        _uninitializedCopy(other.data(), other.data() + other._size, data());
+        _size = other._size;
+        _recordSize(_size);
+    }
+
+    /**
+     * @brief Move constructor.
+     * In heap mode the heap storage is taken as is, in stack mode the elements are moved.
+     * @param other the vector to move from.
+     */
+    VLVector(VLVector &&other) noexcept(std::is_nothrow_move_constructible<T>::value)
+            : _size(0), _capacity(StaticCapacity), _storage(std::move(other._getAllocator()))
+    {
+        _Stats::construct();
+        _takeProfile(other);
+        _takeFrom(other);
+    }
+
+    /**
+     * @brief Move constructor with a given allocator.
+     * The heap storage of other is only taken if its allocator equals the given allocator.
+     * @param other the vector to move from.
+     * @param alloc the allocator of the new vector.
+     */
+    VLVector(VLVector &&other, const Allocator &alloc) : VLVector(alloc)
+    {
+        _takeProfile(other);
+        _takeFrom(other);
+    }
+
+    /**
+     * @brief Destructor.
+     */
+    ~VLVector()
+    {
+        _destroy(data(), data() + _size);
+        if (!_isStackMode())
+        {
+            _deallocate(_storage.heapVec, _capacity);
+        }
+#ifdef VLVECTOR_ENABLE_PROFILER
+        _profile.submit(sizeof(T), StaticCapacity, sizeof(VLVector), _size);
+#endif
+    }
+
+    /**
+     * @brief Swaps the contents of two vectors.
+     * Only live elements are touched: heap storage is exchanged as is, and inline elements are
+     * swapped or relocated. The allocators are swapped only if they propagate on swap, otherwise
+     * each vector keeps its allocator and elements that live in storage of a different allocator
+     * are moved.
+     * @param first the vector to assign to.
+     * @param second the vector to assign from.
+     */
+    friend void swap(VLVector &first, VLVector &second)
+            noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        typedef typename _AllocTraits::propagate_on_container_swap propagate;
+        if (first._isStackMode() && second._isStackMode())
+        {
+            first._swapInline(second, VLTriviallyRelocatable<T>());
+        }
+        else if (!propagate::value && !(first._getAllocator() == second._getAllocator()))
+        {
+            // Heap storage must stay with the allocator that allocated it:
+            VLVector temp(std::move(first));
+            first._takeFrom(second);
+            second._takeFrom(temp);
+            return;
+        }
+        else if (!first._isStackMode() && !second._isStackMode())
+        {
+            // Both vectors are on the heap - exchanging the storage is enough:
+            std::swap(first._size, second._size);
+            std::swap(first._capacity, second._capacity);
+            std::swap(first._storage.heapVec, second._storage.heapVec);
+        }
+        else if (first._isStackMode())
+        {
+            second._swapHeapWithInline(first);
+        }
+        else
+        {
+            first._swapHeapWithInline(second);
+        }
+        first._swapAllocators(second, propagate());
+    }
+
+    /**
+     * @brief Copy assignment operator.
+     * The existing storage is reused: elements are assigned over the live elements, and only
+     * the difference in size is constructed or destroyed. New storage is allocated only when
+     * other does not fit in the capacity of this vector.
+     * Gives the basic exception guarantee, assign_strong gives the strong guarantee.
+     * @param other the other vector to assign from.
+     * @return this vector after assignment.
+     */
+    VLVector &operator=(const VLVector &other)
+    {
+        if (this != &other)
+        {
+            _copyAssignAllocator(other, typename _AllocTraits::propagate_on_container_copy_assignment());
+            _assignN(other.data(), other._size);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment operator.
+     * In heap mode the heap storage of other is taken as is, in stack mode its elements are
+     * moved. If the allocator does not propagate and the allocators differ, the elements are
+     * moved over the existing elements of this vector instead.
+     * @param other the other vector to assign from.
+     * @return this vector after assignment.
+     */
+    VLVector &operator=(VLVector &&other)
+            noexcept(std::is_nothrow_move_constructible<T>::value &&
+                     (_AllocTraits::propagate_on_container_move_assignment::value ||
+                      _AllocAlwaysEqual::value))
+    {
+        if (this != &other)
+        {
+            _moveAssign(other, std::integral_constant<bool,
+                    _AllocTraits::propagate_on_container_move_assignment::value ||
+                    _AllocAlwaysEqual::value>());
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Assigns the values of an initializer list to the vector, reusing its storage.
+     * @param values the values to assign.
+     * @return this vector after assignment.
+     */
+    VLVector &operator=(std::initializer_list<T> values)
+    {
+        assign(values.begin(), values.end());
+        return *this;
+    }
+
+    /**
+     * @brief Copy assignment with the strong exception guarantee: if copying an element throws,
+     * this vector is left unchanged.
+     * The copy is built in new storage first, like the "Copy and Swap" idiom, so unlike the copy
+     * assignment operator it does not reuse the existing storage. The guarantee holds if moving
+     * T does not throw or T is trivially relocatable.
+     * @param other the other vector to assign from.
+     */
+    void assign_strong(const VLVector &other)
+    {
+        const bool propagate = _AllocTraits::propagate_on_container_copy_assignment::value;
+        VLVector copy(other, propagate ? other._getAllocator() : _getAllocator());
+        clear();
+        _adoptAllocator(copy, typename _AllocTraits::propagate_on_container_copy_assignment());
+        _takeFrom(copy);
+    }
+
+    /********************************************************************
+    *                       Given API methods                           *
+    ********************************************************************/
+
+    /**
+     * @brief Default constructor. Initialises an empty VLVector.
+     */
+    VLVector() : _size(0), _capacity(StaticCapacity), _storage(Allocator())
+    {
+        _Stats::construct();
+    }
+
+    /**
+     * @brief Constructs an empty VLVector that uses a given allocator for its heap storage.
+     * @param alloc the allocator to use.
+     */
+    explicit VLVector(const Allocator &alloc)
+            : _size(0), _capacity(StaticCapacity), _storage(alloc)
+    {
+        _Stats::construct();
     }
 
     /**
@@ -453,15 +1942,60 @@ public:
      * @tparam InputIterator the type of iterator to T values.
      * @param first iterator to the first T value in the group.
      * @param last iterator to the last T value in the group.
+     * @param alloc the allocator to use.
      */
-    template<class InputIterator>
-    VLVector(InputIterator first, InputIterator last)
-            : _stackMode(true), _size(0), _capacity(StaticCapacity), _heapVec(nullptr)
+    template<class InputIterator, typename = _RequireInputIterator<InputIterator>>
+    VLVector(InputIterator first, InputIterator last, const Allocator &alloc = Allocator())
+            : VLVector(alloc)
     {
-        for (auto it = first; it != last; ++it)
-        {
-            push_back(*it);
-        }
+        // Forward iterator ranges are measured first so the storage is allocated once:
+        _insertRange(0, first, last,
+                     typename std::iterator_traits<InputIterator>::iterator_category());
+    }
+
+    /**
+     * @brief Constructs a VLVector object holding the values of an initializer list.
+     * @param values the values to store in the vector.
+     * @param alloc the allocator to use.
+     */
+    VLVector(std::initializer_list<T> values, const Allocator &alloc = Allocator())
+            : VLVector(values.begin(), values.end(), alloc)
+    {
+    }
+
+    /**
+     * @brief Tags the vector with the call site it belongs to, so the size profiler collects its
+     * sizes separately from other vectors. Copies and moves of the vector keep the tag.
+     * Does nothing unless VLVECTOR_ENABLE_PROFILER is defined.
+     * @param tag the tag, which must outlive the vector (e.g. a string literal).
+     */
+    void set_profile_tag(const char *tag) noexcept
+    {
+#ifdef VLVECTOR_ENABLE_PROFILER
+        _profile.setTag(tag);
+#else
+        (void) tag;
+#endif
+    }
+
+    /**
+     * @brief Returns a copy of the allocator of the vector.
+     * @return the allocator of the vector.
+     */
+    allocator_type get_allocator() const
+    {
+        return _getAllocator();
+    }
+
+    /**
+     * @brief Returns the largest amount of elements the vector can hold, limited by SizeType
+     * and by the allocator.
+     * @return the maximal size of the vector.
+     */
+    std::size_t max_size() const noexcept
+    {
+        return std::min<std::size_t>(std::numeric_limits<SizeType>::max(),
+                                     _AllocTraits::max_size(_getAllocator()));
     }
 
     /**
@@ -474,25 +2008,115 @@ public:
     }
 
     /**
-     * @brief Returns the capacity of the vector according to the formula given in the exam.
-     * @return the capacity of the vector.
+     * @brief Returns the amount of elements the vector can hold before it has to reallocate.
+     * @return the capacity of the vector.
+     */
+    std::size_t capacity() const
+    {
+        return _capacity;
+    }
+
+    /**
+     * @brief Checks if the vector is empty.
+     * @return true iff the vector is empty.
+     */
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    /**
+     * @brief Makes sure the vector can hold a given amount of elements without reallocating.
+     * @param newCapacity the amount of elements the vector should be able to hold.
+     */
+    void reserve(std::size_t newCapacity)
+    {
+        if (newCapacity > _capacity)
+        {
+            _setCapacity(newCapacity);
+        }
+    }
+
+    /**
+     * @brief Releases unused capacity. A vector whose elements fit in the static capacity
+     * returns to the stack, otherwise its heap capacity is reduced to its size.
+     */
+    void shrink_to_fit()
+    {
+        _setCapacity(std::max<std::size_t>(_size, StaticCapacity));
+    }
+
+    /**
+     * @brief Changes the size of the vector. Added elements are value initialised.
+     * @param newSize the new size of the vector.
+     */
+    void resize(std::size_t newSize)
+    {
+        if (newSize <= _size)
+        {
+            _truncate(newSize);
+            return;
+        }
+        _reserveForSize(newSize);
+        T *vec = data();
+        T *current = vec + _size;
+        try
+        {
+            for (; current != vec + newSize; ++current)
+            {
+                _construct(current);
+            }
+        }
+        catch (...)
+        {
+            _destroy(vec + _size, current);
+            throw;
+        }
+        _size = newSize;
+        _recordSize(_size);
+    }
+
+    /**
+     * @brief Changes the size of the vector. Added elements are copies of a given value.
+     * @param newSize the new size of the vector.
+     * @param val the value to copy into the added elements.
      */
-    std::size_t capacity() const
+    void resize(std::size_t newSize, const T &val)
     {
-        if (_size + 1 <= StaticCapacity)
+        if (newSize <= _size)
+        {
+            _truncate(newSize);
+            return;
+        }
+        if (newSize > _capacity)
+        {
+            // val may be an element of this vector, so it is copied before the storage moves:
+            T copy(val);
+            _reserveForSize(newSize);
+            _fill(newSize, copy);
+        }
+        else
         {
-            return StaticCapacity;
+            _fill(newSize, val);
         }
-        return (size_t) (3 * (_size + 1) / 2);
     }
 
     /**
-     * @brief Checks if the vector is empty.
-     * @return true iff the vector is empty.
+     * @brief Appends a given amount of elements without initialising them, for the caller to
+     * fill in, e.g. by reading them from a file. Unlike resize, the new elements are not
+     * written twice. Only trivially copyable elements may be left uninitialised.
+     * @param count the amount of elements to append.
+     * @return a pointer to the first appended element.
      */
-    bool empty() const
+    T *append_uninitialized(std::size_t count)
     {
-        return _size == 0;
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable elements may be left uninitialised");
+        _reserveForSize(_size + count);
+        T *appended = data() + _size;
+        _size += count;
+        _recordSize(_size);
+        return appended;
     }
 
     /**
@@ -526,52 +2150,78 @@ public:
     }
 
     /**
-     * @brief Adds a given value to the end of the vector.
-     * @param val the value to add, given as an l-value.
+     * @brief Constructs a value in place at the end of the vector.
+     * @tparam Args the types of the arguments to pass to the constructor of T.
+     * @param args the arguments to pass to the constructor of T.
+     * @return a reference to the added value.
      */
-    void push_back(const T &val)
+    template<typename... Args>
+    T &emplace_back(Args &&... args)
     {
-        std::size_t newCapacity = capacity();
-        // We are in stack mode - values are stored on the stack,
-        // and the capacity that was calculated before exceeds the static capacity:
-        if (_stackMode && newCapacity > StaticCapacity)
+        if (_size == _capacity)
         {
-            _capacity = newCapacity;
-            _copyToHeap();
+            // args may refer to elements of this vector, so the value is built before the storage moves:
+            T value(std::forward<Args>(args)...);
+            _growIfFull();
+            _construct(data() + _size, std::move(value));
         }
-        else if (_size + 1 > _capacity)
+        else
         {
-            // We are in heap mode - values are stored on the heap,
-            // and the capacity needs to be increased:
-            _increaseHeap(newCapacity);
+            _construct(data() + _size, std::forward<Args>(args)...);
         }
-        data()[_size] = val;
-        ++_size;
+        _recordSize(_size + 1);
+        return data()[_size++];
     }
 
     /**
-     * @brief Adds a given value to the end of the vector.
-     * @param val the value to add, given as an r-value.
+     * @brief Constructs a value in place in the vector at the position before
+     * the given position.
+     * @tparam Args the types of the arguments to pass to the constructor of T.
+     * @param position the position to add the value before it.
+     * @param args the arguments to pass to the constructor of T.
+     * @return an iterator that points to the added value.
      */
-    void push_back(const T && val)
+    template<typename... Args>
+    iterator emplace(const const_iterator position, Args &&... args)
     {
-        std::size_t newCapacity = capacity();
-
-        // We are in stack mode - values are stored on the stack,
-        // and the capacity that was calculated before exceeds the static capacity:
-        if (_stackMode && newCapacity > StaticCapacity)
+        const std::size_t index = position - cbegin();
+        if (index == _size)
         {
-            _capacity = newCapacity;
-            _copyToHeap();
-        }
-        else if (_size + 1 > _capacity)
-        {
-            // We are in heap mode - values are stored on the heap,
-            // and the capacity needs to be increased:
-            _increaseHeap(newCapacity);
+            emplace_back(std::forward<Args>(args)...);
+            return begin() + index;
         }
-        data()[_size] = val;
+
+        // args may refer to elements of this vector, so the value is built before the elements move:
+        T value(std::forward<Args>(args)...);
+        _growIfFull();
+
+        // Move the values of the vector that should appear
+        // after the new value one step to the right:
+        T *vec = data();
+        _construct(vec + _size, std::move(vec[_size - 1]));
+        std::move_backward(vec + index, vec + _size - 1, vec + _size);
+        vec[index] = std::move(value);
         ++_size;
+        _recordSize(_size);
+        return begin() + index;
+    }
+
+    /**
+     * @brief Adds a given value to the end of the vector.
+     * @param val the value to add, given as an l-value.
+     */
+    void push_back(const T &val)
+    {
+        emplace_back(val);
+    }
+
+    /**
+     * @brief Adds a given value to the end of the vector.
+     * @param val the value to add, given as an r-value. It is moved into the vector.
+     */
+    void push_back(T &&val)
+    {
+        emplace_back(std::move(val));
     }
 
     /**
@@ -581,73 +2231,21 @@ public:
      * @param val the value to add, given as an l-value.
      * @return an iterator that points to the added value.
      */
-    iterator insert(const iterator position, const T &val)
+    iterator insert(const const_iterator position, const T &val)
     {
-        std::size_t newCapacity = capacity();
-
-        // We are in stack mode - values are stored on the stack,
-        // and the capacity that was calculated before exceeds the static capacity:
-        if (_stackMode && newCapacity > StaticCapacity)
-        {
-            _capacity = newCapacity;
-            _copyToHeap();
-        }
-        else if (_size + 1 > _capacity)
-        {
-            // We are in heap mode - values are stored on the heap,
-            // and the capacity needs to be increased:
-            _increaseHeap(newCapacity);
-        }
-        // Move the values of the vector that should appear
-        // after the new value one step to the right:
-        for (auto it = end(); it != position; --it)
-        {
-            *it = *(it - 1);
-        }
-        *position = val;
-        ++_size;
-        return position;
+        return emplace(position, val);
     }
 
     /**
      * @brief Adds a given value to the vector at the position before
      * the given position.
      * @param position the position to add the value before it.
-     * @param val the value to add, given as an r-value.
+     * @param val the value to add, given as an r-value. It is moved into the vector.
      * @return an iterator that points to the added value.
      */
-    iterator insert(const iterator position, const T && val)
+    iterator insert(const const_iterator position, T &&val)
     {
-        auto last = end();
-        if (position == last)
-        {
-            push_back(val);
-            return position;
-        }
-        std::size_t newCapacity = capacity();
-
-        // We are in stack mode - values are stored on the stack,
-        // and the capacity that was calculated before exceeds the static capacity:
-        if (_stackMode && newCapacity > StaticCapacity)
-        {
-            _capacity = newCapacity;
-            _copyToHeap();
-        }
-        else if (_size + 1 > _capacity)
-        {
-            // We are in heap mode - values are stored on the heap,
-            // and the capacity needs to be increased:
-            _increaseHeap(newCapacity);
-        }
-        // Move the values of the vector that should appear
-        // after the new value one step to the right:
-        for (auto it = last; it != position; --it)
-        {
-            *it = *(it - 1);
-        }
-        *position = val;
-        ++_size;
-        return position;
+        return emplace(position, std::move(val));
     }
 
     /**
@@ -658,15 +2256,11 @@ public:
         if (_size > 0)
         {
             --_size;
-            data()[_size] = T();
+            _destroy(data() + _size, data() + _size + 1);
 
             // If we are in heap mode and following the pop action
-            // the capacity decreased to static capacity:
-            if (!_stackMode && capacity() <= StaticCapacity)
-            {
-                _capacity = StaticCapacity;
-                _copyToStack();
-            }
+            // the size dropped enough to return to the stack:
+            _shrinkIfNeeded();
         }
     }
 
@@ -675,28 +2269,154 @@ public:
      * @param position an iterator that points to the value that is to be removed.
      * @return an iterator to the value that appeared after the removed value.
      */
-    iterator erase(iterator position)
+    iterator erase(const const_iterator position)
     {
-        auto last = end();
-        if (position + 1 == last)
-        {
-            pop_back();
-            return position;
-        }
-        //Move the values of the vector that were after the erased value one step to the left:
-        for (auto it = position; it != last; ++it)
-        {
-            *it = *(it + 1);
-        }
-        --_size;
-        // If we are in heap mode and following the erase action
-        // the capacity decreased to static capacity:
-        if (!_stackMode && capacity() <= StaticCapacity)
+        return erase(position, position + 1);
+    }
+
+    /**
+     * @brief Removes from the vector the values in a given range.
+     * The tail is shifted once, regardless of the amount of removed values.
+     * @param first an iterator that points to the first value to remove.
+     * @param last an iterator that points past the last value to remove.
+     * @return an iterator to the value that appeared after the removed values.
+     */
+    iterator erase(const const_iterator first, const const_iterator last)
+    {
+        const std::size_t index = first - cbegin();
+        const std::size_t count = last - first;
+        if (count > 0)
         {
-            _capacity = StaticCapacity;
-            _copyToStack();
+            //Move the values of the vector that were after the erased values to the left:
+            _eraseN(index, count, VLTriviallyRelocatable<T>());
         }
-        return position;
+        return begin() + index;
+    }
+
+    /**
+     * @brief Removes from the vector the value that the given iterator points to by moving the
+     * last value into its place. Unlike erase it takes constant time, but it does not keep the
+     * order of the values.
+     * @param position an iterator that points to the value that is to be removed.
+     * @return an iterator to the value that took the place of the removed value.
+     */
+    iterator swap_erase(const const_iterator position)
+    {
+        return erase_unordered(position, position + 1);
+    }
+
+    /**
+     * @brief Removes from the vector the values in a given range by moving the last values of
+     * the vector into their place. At most as many values as were removed are moved, regardless
+     * of the amount of values after the range, but the order of the values is not kept.
+     * @param first an iterator that points to the first value to remove.
+     * @param last an iterator that points past the last value to remove.
+     * @return an iterator to the value that took the place of the first removed value.
+     */
+    iterator erase_unordered(const const_iterator first, const const_iterator last)
+    {
+        const std::size_t index = first - cbegin();
+        const std::size_t count = last - first;
+        const std::size_t moved = std::min(count, _size - index - count);
+        T *vec = data();
+        std::move(vec + _size - moved, vec + _size, vec + index);
+        _truncate(_size - count);
+        return begin() + index;
+    }
+
+    /**
+     * @brief Adds the values of a given range to the vector at the position before
+     * the given position. Forward iterator ranges are inserted with at most one reallocation.
+     * @tparam InputIterator the type of iterator to T values.
+     * @param position the position to add the values before it.
+     * @param first iterator to the first value to add.
+     * @param last iterator past the last value to add.
+     * @return an iterator that points to the first added value.
+     */
+    template<class InputIterator, typename = _RequireInputIterator<InputIterator>>
+    iterator insert(const const_iterator position, InputIterator first, InputIterator last)
+    {
+        const std::size_t index = position - cbegin();
+        _insertRange(index, first, last,
+                     typename std::iterator_traits<InputIterator>::iterator_category());
+        return begin() + index;
+    }
+
+    /**
+     * @brief Adds copies of a given value to the vector at the position before
+     * the given position.
+     * @param position the position to add the values before it.
+     * @param count the amount of copies to add.
+     * @param val the value to copy.
+     * @return an iterator that points to the first added value.
+     */
+    iterator insert(const const_iterator position, std::size_t count, const T &val)
+    {
+        const std::size_t index = position - cbegin();
+
+        // val may be an element of this vector, so it is copied before the elements move:
+        T copy(val);
+        _insertN(index, _ValueRepeater(copy), count);
+        return begin() + index;
+    }
+
+    /**
+     * @brief Adds the values of an initializer list to the vector at the position before
+     * the given position.
+     * @param position the position to add the values before it.
+     * @param values the values to add.
+     * @return an iterator that points to the first added value.
+     */
+    iterator insert(const const_iterator position, std::initializer_list<T> values)
+    {
+        return insert(position, values.begin(), values.end());
+    }
+
+    /**
+     * @brief Adds the values of a given range to the end of the vector.
+     * @tparam Range a type that std::begin and std::end accept.
+     * @param range the values to add.
+     */
+    template<class Range>
+    void append_range(Range &&range)
+    {
+        using std::begin;
+        using std::end;
+        insert(cend(), begin(range), end(range));
+    }
+
+    /**
+     * @brief Replaces the values of the vector with the values of a given range.
+     * Existing values are assigned over and the storage is reallocated at most once.
+     * @tparam InputIterator the type of iterator to T values.
+     * @param first iterator to the first value.
+     * @param last iterator past the last value.
+     */
+    template<class InputIterator, typename = _RequireInputIterator<InputIterator>>
+    void assign(InputIterator first, InputIterator last)
+    {
+        _assignRange(first, last, typename std::iterator_traits<InputIterator>::iterator_category());
+    }
+
+    /**
+     * @brief Replaces the values of the vector with copies of a given value.
+     * @param count the amount of copies.
+     * @param val the value to copy.
+     */
+    void assign(std::size_t count, const T &val)
+    {
+        // val may be an element of this vector, so it is copied before the elements change:
+        T copy(val);
+        _assignN(_ValueRepeater(copy), count);
+    }
+
+    /**
+     * @brief Replaces the values of the vector with the values of an initializer list.
+     * @param values the values to store in the vector.
+     */
+    void assign(std::initializer_list<T> values)
+    {
+        assign(values.begin(), values.end());
     }
 
     /**
@@ -704,17 +2424,15 @@ public:
      */
     void clear()
     {
-        // If we need to remove elements from the heap:
-        if (!_stackMode)
+        _destroy(data(), data() + _size);
+        _size = 0;
+
+        // If we need to release the heap storage:
+        if (!_isStackMode())
         {
-            delete[] _heapVec;
-            _heapVec = nullptr;
+            _deallocate(_storage.heapVec, _capacity);
             _capacity = StaticCapacity;
-            _stackMode = true;
         }
-
-        std::fill(_stackVec, _stackVec + _capacity, T());
-        _size = 0;
     }
 
     /**
@@ -723,11 +2441,11 @@ public:
      */
     T *data()
     {
-        if (_stackMode)
+        if (_isStackMode())
         {
-            return _stackVec;
+            return _stackData();
         }
-        return _heapVec;
+        return _storage.heapVec;
     }
 
     /**
@@ -736,11 +2454,11 @@ public:
      */
     const T *data() const
     {
-        if (_stackMode)
+        if (_isStackMode())
         {
-            return _stackVec;
+            return _stackData();
         }
-        return _heapVec;
+        return _storage.heapVec;
     }
 
     /**
@@ -772,23 +2490,8 @@ public:
      */
     bool operator==(const VLVector &other) const
     {
-        //Check if this vector's size matches the other vector's size:
-        if (_size != other._size)
-        {
-            return false;
-        }
-
-        // Check that each element in this vector compares equal
-        // with the element in the other vector at the same position:
-        for (int i = 0; i < (int) _size; ++i)
-        {
-            if ((*this)[i] != other[i])
-            {
-                return false;
-            }
-        }
-
-        return true;
+        // Trivially comparable elements are compared with a single memcmp:
+        return _size == other._size && VLSimd::equal(data(), other.data(), _size);
     }
 
     /**
@@ -801,6 +2504,89 @@ public:
         return !operator==(other);
     }
 
+    /**
+     * @brief Checks if this object is lexicographically less than another VLVector object.
+     * Trivially comparable elements are compared by finding the first differing byte.
+     * @param other the other VLVector object.
+     * @return true iff this object is less than the other object.
+     */
+    bool operator<(const VLVector &other) const
+    {
+        return VLSimd::less(data(), _size, other.data(), other._size);
+    }
+
+    /**
+     * @brief Checks if this object is lexicographically greater than another VLVector object.
+     * @param other the other VLVector object.
+     * @return true iff this object is greater than the other object.
+     */
+    bool operator>(const VLVector &other) const
+    {
+        return other < *this;
+    }
+
+    /**
+     * @brief Checks if this object is lexicographically less than or equal to another object.
+     * @param other the other VLVector object.
+     * @return true iff this object is not greater than the other object.
+     */
+    bool operator<=(const VLVector &other) const
+    {
+        return !(other < *this);
+    }
+
+    /**
+     * @brief Checks if this object is lexicographically greater than or equal to another object.
+     * @param other the other VLVector object.
+     * @return true iff this object is not less than the other object.
+     */
+    bool operator>=(const VLVector &other) const
+    {
+        return !(*this < other);
+    }
+
+    /**
+     * @brief Finds the first element that equals a given value.
+     * Trivially comparable elements of 1, 2, 4 or 8 bytes are searched with SSE2 or AVX2
+     * when the translation unit is compiled for them.
+     * @param val the value to find.
+     * @return an iterator to the first equal element, or end() if there is none.
+     */
+    iterator find(const T &val)
+    {
+        return begin() + (VLSimd::find<T>(data(), data() + _size, val) - data());
+    }
+
+    /**
+     * @brief Finds the first element that equals a given value.
+     * @param val the value to find.
+     * @return an iterator to the first equal element, or end() if there is none.
+     */
+    const_iterator find(const T &val) const
+    {
+        return begin() + (VLSimd::find<T>(data(), data() + _size, val) - data());
+    }
+
+    /**
+     * @brief Checks if the vector holds a given value.
+     * @param val the value to look for.
+     * @return true iff an element equals the value.
+     */
+    bool contains(const T &val) const
+    {
+        return VLSimd::find<T>(data(), data() + _size, val) != data() + _size;
+    }
+
+    /**
+     * @brief Counts the elements that equal a given value.
+     * @param val the value to count.
+     * @return the amount of equal elements.
+     */
+    std::size_t count(const T &val) const
+    {
+        return VLSimd::count<T>(data(), data() + _size, val);
+    }
+
     /********************************************************************
     *                       Begin and end iterators                     *
     ********************************************************************/
@@ -811,7 +2597,7 @@ public:
      */
     iterator begin()
     {
-        return iterator(0, _size, data());
+        return _makeIterator(data(), _CheckedIterators());
     }
 
     /**
@@ -820,7 +2606,7 @@ public:
      */
     iterator end()
     {
-        return iterator(_size, _size, data());
+        return _makeIterator(data() + _size, _CheckedIterators());
     }
 
     /**
@@ -829,7 +2615,7 @@ public:
      */
     const_iterator begin() const
     {
-        return const_iterator(0, _size, data());
+        return _makeIterator(data(), _CheckedIterators());
     }
 
     /**
@@ -838,7 +2624,7 @@ public:
      */
     const_iterator end() const
     {
-        return const_iterator(_size, _size, data());
+        return _makeIterator(data() + _size, _CheckedIterators());
     }
 
     /**
@@ -847,7 +2633,7 @@ public:
      */
     const_iterator cbegin() const
     {
-        return const_iterator(0, _size, data());
+        return _makeIterator(data(), _CheckedIterators());
     }
 
     /**
@@ -856,9 +2642,142 @@ public:
      */
     const_iterator cend() const
     {
-        return const_iterator(_size, _size, data());
+        return _makeIterator(data() + _size, _CheckedIterators());
+    }
+
+    /**
+     * @brief Returns a reverse iterator to the last element of the vector.
+     * @return a reverse iterator to the beginning of the reversed vector.
+     */
+    reverse_iterator rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    /**
+     * @brief Returns a reverse iterator to the position before the first element of the vector.
+     * @return a reverse iterator to the end of the reversed vector.
+     */
+    reverse_iterator rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    /**
+     * @brief Returns a const reverse iterator to the last element of the vector.
+     * @return a reverse iterator to the beginning of the reversed vector.
+     */
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /**
+     * @brief Returns a const reverse iterator to the position before the first element.
+     * @return a reverse iterator to the end of the reversed vector.
+     */
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    /**
+     * @brief Returns a const reverse iterator to the last element of the vector.
+     * @return a reverse iterator to the beginning of the reversed vector.
+     */
+    const_reverse_iterator crbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    /**
+     * @brief Returns a const reverse iterator to the position before the first element.
+     * @return a reverse iterator to the end of the reversed vector.
+     */
+    const_reverse_iterator crend() const
+    {
+        return const_reverse_iterator(begin());
     }
 };
 
+/**
+ * @brief Removes the values of a vector that satisfy a predicate, keeping the order of the other
+ * values. The kept values are compacted in a single pass, and the vector decides only once, at
+ * the end, whether to return to the stack.
+ * @param vec the vector to remove the values from.
+ * @param predicate returns true for the values to remove.
+ * @return the amount of values that were removed.
+ */
+template<typename T, size_t StaticCapacity, typename GrowthPolicy, typename Allocator,
+        typename SizeType, typename Predicate>
+std::size_t erase_if(VLVector<T, StaticCapacity, GrowthPolicy, Allocator, SizeType> &vec,
+                     Predicate predicate)
+{
+    T *first = vec.data();
+    T *last = first + vec.size();
+    T *newEnd = std::remove_if(first, last, predicate);
+    vec.erase(vec.cbegin() + (newEnd - first), vec.cend());
+    return last - newEnd;
+}
+
+/**
+ * @brief Removes the values of a sorted vector that equal the value before them, leaving one
+ * value of every run of equal values. Like erase_if, it is a single pass with one shrink decision.
+ * @param vec the sorted vector to remove the values from.
+ * @param equal tells whether two values are duplicates.
+ * @return the amount of values that were removed.
+ */
+template<typename T, size_t StaticCapacity, typename GrowthPolicy, typename Allocator,
+        typename SizeType, typename BinaryPredicate>
+std::size_t remove_duplicates(VLVector<T, StaticCapacity, GrowthPolicy, Allocator, SizeType> &vec,
+                              BinaryPredicate equal)
+{
+    T *first = vec.data();
+    T *last = first + vec.size();
+    T *newEnd = std::unique(first, last, equal);
+    vec.erase(vec.cbegin() + (newEnd - first), vec.cend());
+    return last - newEnd;
+}
+
+/**
+ * @brief Removes the values of a sorted vector that equal the value before them.
+ * @param vec the sorted vector to remove the values from.
+ * @return the amount of values that were removed.
+ */
+template<typename T, size_t StaticCapacity, typename GrowthPolicy, typename Allocator, typename SizeType>
+std::size_t remove_duplicates(VLVector<T, StaticCapacity, GrowthPolicy, Allocator, SizeType> &vec)
+{
+    return remove_duplicates(vec, std::equal_to<T>());
+}
+
+namespace std
+{
+    /**
+     * @brief Hashes a VLVector, so it may be used as a key of unordered containers.
+     * Trivially comparable elements are hashed as bytes, other elements by combining their hashes.
+     */
+    template<typename T, size_t StaticCapacity, typename GrowthPolicy, typename Allocator,
+            typename SizeType>
+    struct hash<VLVector<T, StaticCapacity, GrowthPolicy, Allocator, SizeType>>
+    {
+        size_t operator()(const VLVector<T, StaticCapacity, GrowthPolicy, Allocator, SizeType> &vec) const
+        {
+            return VLSimd::hash(vec.data(), vec.size());
+        }
+    };
+}
+
+#ifdef VLVECTOR_HAS_PMR
+namespace pmr
+{
+    /**
+     * @brief A VLVector that spills to a std::pmr::memory_resource, e.g. a monotonic arena.
+     */
+    template<typename T, size_t StaticCapacity = DEF_STATIC_CAPACITY,
+            typename GrowthPolicy = VLDefaultGrowthPolicy, typename SizeType = std::size_t>
+    using VLVector = ::VLVector<T, StaticCapacity, GrowthPolicy, std::pmr::polymorphic_allocator<T>,
+            SizeType>;
+}
+#endif
 
 #endif //CPP_FINAL_PROJECT_VLVECTOR_HPP
@@ -0,0 +1,335 @@
+//
+// Opt-in size profiler for VLVector, enabled by defining VLVECTOR_ENABLE_PROFILER before
+// including VLVector.hpp. A sample of the vectors records its peak and final sizes under a
+// call-site tag, and the histograms are written to a file that tools/VLCapacityAdvisor.cpp
+// reads to recommend a StaticCapacity per tag.
+//
+// Setting the VLVECTOR_PROFILE_OUT environment variable writes the profile to that path at exit,
+// and VLVECTOR_PROFILE_SAMPLE sets the sample rate (one in N vectors).
+//
+
+#ifndef CPP_FINAL_PROJECT_VLVECTORPROFILER_HPP
+#define CPP_FINAL_PROJECT_VLVECTORPROFILER_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#define VLVECTOR_PROFILE_VERSION 1
+#define VLVECTOR_UNTAGGED "untagged"
+
+/**
+ * @brief Collects the size histograms of the sampled vectors of the process.
+ */
+class VLSizeProfiler
+{
+private:
+    /**
+     * @brief Identifies the vectors whose sizes are collected in the same histograms.
+     */
+    struct _Key
+    {
+        std::string tag;
+        std::size_t elementSize;
+        std::size_t staticCapacity;
+        std::size_t objectSize;
+
+        bool operator<(const _Key &other) const
+        {
+            return std::tie(tag, elementSize, staticCapacity, objectSize) <
+                   std::tie(other.tag, other.elementSize, other.staticCapacity, other.objectSize);
+        }
+    };
+
+    /**
+     * @brief The amount of vectors that reached each peak size and each final size.
+     */
+    struct _Histograms
+    {
+        std::map<std::size_t, std::size_t> peak;
+        std::map<std::size_t, std::size_t> final;
+    };
+
+    std::map<_Key, _Histograms> _profiles;
+    std::atomic<std::size_t> _sampleRate{1};
+    std::string _atExitPath;
+    mutable std::mutex _mutex;
+
+    /**
+     * @brief Constructs the profiler, applying the VLVECTOR_PROFILE_SAMPLE and
+     * VLVECTOR_PROFILE_OUT environment variables.
+     */
+    VLSizeProfiler()
+    {
+        const char *sampleRate = std::getenv("VLVECTOR_PROFILE_SAMPLE");
+        if (sampleRate != nullptr)
+        {
+            setSampleRate(std::strtoul(sampleRate, nullptr, 10));
+        }
+        const char *path = std::getenv("VLVECTOR_PROFILE_OUT");
+        if (path != nullptr)
+        {
+            _atExitPath = path;
+            std::atexit(_dumpAtExit);
+        }
+    }
+
+    /**
+     * @brief Writes the profile to the path given to dumpAtExit.
+     */
+    static void _dumpAtExit()
+    {
+        VLSizeProfiler &profiler = instance();
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(profiler._mutex);
+            path = profiler._atExitPath;
+        }
+        if (!profiler.dump(path.c_str()))
+        {
+            std::fprintf(stderr, "VLVector profiler: could not write %s\n", path.c_str());
+        }
+    }
+
+    /**
+     * @brief Replaces the characters that separate the fields of the profile file.
+     * @param tag the tag to write.
+     * @return the tag without tabs and line breaks.
+     */
+    static std::string _sanitize(const char *tag)
+    {
+        std::string result(tag);
+        for (char &c : result)
+        {
+            if (c == '\t' || c == '\n' || c == '\r')
+            {
+                c = ' ';
+            }
+        }
+        return result;
+    }
+
+public:
+    VLSizeProfiler(const VLSizeProfiler &) = delete;
+
+    VLSizeProfiler &operator=(const VLSizeProfiler &) = delete;
+
+    /**
+     * @brief Returns the profiler.
+     * The profiler is never destroyed, so vectors with static storage duration may still
+     * record their sizes while the program exits.
+     * @return the profiler.
+     */
+    static VLSizeProfiler &instance()
+    {
+        static VLSizeProfiler *profiler = new VLSizeProfiler();
+        return *profiler;
+    }
+
+    /**
+     * @brief Sets how many of the vectors are sampled.
+     * @param rate one in rate vectors is sampled, 0 stops sampling.
+     */
+    void setSampleRate(std::size_t rate) noexcept
+    {
+        _sampleRate.store(rate, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Decides whether a new vector is sampled.
+     * @return true iff the sizes of the new vector should be recorded.
+     */
+    bool shouldSample() noexcept
+    {
+        const std::size_t rate = _sampleRate.load(std::memory_order_relaxed);
+        if (rate <= 1)
+        {
+            return rate == 1;
+        }
+        static thread_local std::size_t constructed = 0;
+        return ++constructed % rate == 0;
+    }
+
+    /**
+     * @brief Records the sizes of a sampled vector.
+     * @param tag the call-site tag of the vector.
+     * @param elementSize the size of an element.
+     * @param staticCapacity the static capacity of the vector.
+     * @param objectSize the size of the vector object.
+     * @param peakSize the largest size the vector reached.
+     * @param finalSize the size of the vector when it was destroyed.
+     */
+    void record(const char *tag, std::size_t elementSize, std::size_t staticCapacity,
+                std::size_t objectSize, std::size_t peakSize, std::size_t finalSize)
+    {
+        _Key key = {_sanitize(tag), elementSize, staticCapacity, objectSize};
+        std::lock_guard<std::mutex> lock(_mutex);
+        _Histograms &histograms = _profiles[key];
+        ++histograms.peak[peakSize];
+        ++histograms.final[finalSize];
+    }
+
+    /**
+     * @brief Writes the histograms, one line per tag, kind and size:
+     * tag, element size, static capacity, object size, kind ("peak" or "final"), size and count,
+     * separated by tabs.
+     * @param out the stream to write to.
+     */
+    void dump(std::FILE *out) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::fprintf(out, "# VLVector size profile %d\n", VLVECTOR_PROFILE_VERSION);
+        std::fprintf(out, "# tag\telement_size\tstatic_capacity\tobject_size\tkind\tsize\tcount\n");
+        for (const auto &profile : _profiles)
+        {
+            const _Key &key = profile.first;
+            for (const auto &bin : profile.second.peak)
+            {
+                std::fprintf(out, "%s\t%zu\t%zu\t%zu\tpeak\t%zu\t%zu\n", key.tag.c_str(),
+                             key.elementSize, key.staticCapacity, key.objectSize, bin.first,
+                             bin.second);
+            }
+            for (const auto &bin : profile.second.final)
+            {
+                std::fprintf(out, "%s\t%zu\t%zu\t%zu\tfinal\t%zu\t%zu\n", key.tag.c_str(),
+                             key.elementSize, key.staticCapacity, key.objectSize, bin.first,
+                             bin.second);
+            }
+        }
+    }
+
+    /**
+     * @brief Writes the histograms to a file.
+     * @param path the path of the file.
+     * @return true iff the file was written.
+     */
+    bool dump(const char *path) const
+    {
+        std::FILE *out = std::fopen(path, "w");
+        if (out == nullptr)
+        {
+            return false;
+        }
+        dump(out);
+        return std::fclose(out) == 0;
+    }
+
+    /**
+     * @brief Makes the program write the histograms to a file when it exits.
+     * @param path the path of the file.
+     */
+    void dumpAtExit(const char *path)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_atExitPath.empty())
+        {
+            std::atexit(_dumpAtExit);
+        }
+        _atExitPath = path;
+    }
+
+    /**
+     * @brief Removes all recorded sizes.
+     */
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _profiles.clear();
+    }
+};
+
+/**
+ * @brief The profile of a single vector: its tag, its peak size and whether it is sampled.
+ */
+class VLProfileRecord
+{
+private:
+    const char *_tag;
+    std::size_t _peakSize;
+    bool _sampled;
+
+public:
+    /**
+     * @brief Constructs the record of a new vector, deciding whether it is sampled.
+     */
+    VLProfileRecord() noexcept
+            : _tag(VLVECTOR_UNTAGGED), _peakSize(0), _sampled(VLSizeProfiler::instance().shouldSample())
+    {
+    }
+
+    /**
+     * @brief Sets the call-site tag of the vector.
+     * @param tag the tag, which must outlive the vector (e.g. a string literal).
+     */
+    void setTag(const char *tag) noexcept
+    {
+        _tag = tag;
+    }
+
+    /**
+     * @brief Returns the call-site tag of the vector.
+     * @return the tag of the vector.
+     */
+    const char *tag() const noexcept
+    {
+        return _tag;
+    }
+
+    /**
+     * @brief Takes over the record of a vector that is moved into a new vector, so that the
+     * sizes of the moved elements are submitted once, by the vector that ends up holding them.
+     * The other record is left unsampled, and submits nothing.
+     * @param other the record of the vector that is moved from.
+     */
+    void takeFrom(VLProfileRecord &other) noexcept
+    {
+        _tag = other._tag;
+        _peakSize = other._peakSize;
+        _sampled = other._sampled;
+        other._peakSize = 0;
+        other._sampled = false;
+    }
+
+    /**
+     * @brief Raises the peak size to a given size if it is larger.
+     * @param size the size the vector reached.
+     */
+    void recordSize(std::size_t size) noexcept
+    {
+        if (size > _peakSize)
+        {
+            _peakSize = size;
+        }
+    }
+
+    /**
+     * @brief Submits the sizes of a destroyed vector to the profiler if it is sampled.
+     * @param elementSize the size of an element.
+     * @param staticCapacity the static capacity of the vector.
+     * @param objectSize the size of the vector object.
+     * @param finalSize the size of the vector when it was destroyed.
+     */
+    void submit(std::size_t elementSize, std::size_t staticCapacity, std::size_t objectSize,
+                std::size_t finalSize) const noexcept
+    {
+        if (!_sampled)
+        {
+            return;
+        }
+        try
+        {
+            VLSizeProfiler::instance().record(_tag, elementSize, staticCapacity, objectSize,
+                                              _peakSize, finalSize);
+        }
+        catch (...)
+        {
+            // Vectors are destroyed without throwing, a size that could not be recorded is dropped.
+        }
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLVECTORPROFILER_HPP
@@ -0,0 +1,541 @@
+//
+// Comparison, search and hashing of element ranges for VLVector.
+// Element types whose equality is equivalent to comparing their bytes are compared with memcmp
+// and searched with SSE2 or AVX2, depending on the instruction sets the translation unit is
+// compiled for (e.g. -msse2, -mavx2 or -march=native). Other element types, and builds without
+// these instruction sets, use scalar loops.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLVECTORSIMD_HPP
+#define CPP_FINAL_PROJECT_VLVECTORSIMD_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VLVECTOR_SIMD_WIDTH 32
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define VLVECTOR_SIMD_WIDTH 16
+#endif
+
+#if defined(__SSE4_1__) && !defined(__AVX2__)
+#include <smmintrin.h>
+#endif
+
+#define VLVECTOR_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+/**
+ * @brief Tells whether two objects of type T compare equal iff their bytes are equal, so ranges
+ * of T may be compared with memcmp and searched byte-wise.
+ * Integral, enumeration and pointer types qualify by default. Other types without padding and
+ * without floating point members (e.g. a struct of two ints with member-wise equality) may opt
+ * in by specializing this struct as std::true_type.
+ * @tparam T the type of values to compare.
+ */
+template<typename T>
+struct VLTriviallyComparable
+        : std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value ||
+                                       std::is_pointer<T>::value>
+{
+};
+
+#ifdef VLVECTOR_SIMD_WIDTH
+
+/**
+ * @brief Compares a vector register of elements of a given size with a broadcast value.
+ * @tparam Size the size of an element in bytes.
+ */
+template<std::size_t Size>
+struct VLSimdLanes;
+
+#if VLVECTOR_SIMD_WIDTH == 32
+typedef __m256i VLSimdRegister;
+
+/**
+ * @brief Loads a register from unaligned memory.
+ */
+inline VLSimdRegister vlSimdLoad(const unsigned char *bytes)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bytes));
+}
+
+/**
+ * @brief Returns a mask with a bit set for every byte that is set in a comparison result.
+ */
+inline std::uint32_t vlSimdMask(VLSimdRegister comparison)
+{
+    return (std::uint32_t) _mm256_movemask_epi8(comparison);
+}
+
+template<>
+struct VLSimdLanes<1>
+{
+    static VLSimdRegister broadcast(std::uint8_t value)
+    {
+        return _mm256_set1_epi8((char) value);
+    }
+
+    static std::uint32_t equalMask(const unsigned char *bytes, VLSimdRegister value)
+    {
+        return vlSimdMask(_mm256_cmpeq_epi8(vlSimdLoad(bytes), value));
+    }
+};
+
+template<>
+struct VLSimdLanes<2>
+{
+    static VLSimdRegister broadcast(std::uint16_t value)
+    {
+        return _mm256_set1_epi16((short) value);
+    }
+
+    static std::uint32_t equalMask(const unsigned char *bytes, VLSimdRegister value)
+    {
+        return vlSimdMask(_mm256_cmpeq_epi16(vlSimdLoad(bytes), value));
+    }
+};
+
+template<>
+struct VLSimdLanes<4>
+{
+    static VLSimdRegister broadcast(std::uint32_t value)
+    {
+        return _mm256_set1_epi32((int) value);
+    }
+
+    static std::uint32_t equalMask(const unsigned char *bytes, VLSimdRegister value)
+    {
+        return vlSimdMask(_mm256_cmpeq_epi32(vlSimdLoad(bytes), value));
+    }
+};
+
+template<>
+struct VLSimdLanes<8>
+{
+    static VLSimdRegister broadcast(std::uint64_t value)
+    {
+        return _mm256_set1_epi64x((long long) value);
+    }
+
+    static std::uint32_t equalMask(const unsigned char *bytes, VLSimdRegister value)
+    {
+        return vlSimdMask(_mm256_cmpeq_epi64(vlSimdLoad(bytes), value));
+    }
+};
+
+#else
+typedef __m128i VLSimdRegister;
+
+/**
+ * @brief Loads a register from unaligned memory.
+ */
+inline VLSimdRegister vlSimdLoad(const unsigned char *bytes)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes));
+}
+
+/**
+ * @brief Returns a mask with a bit set for every byte that is set in a comparison result.
+ */
+inline std::uint32_t vlSimdMask(VLSimdRegister comparison)
+{
+    return (std::uint32_t) _mm_movemask_epi8(comparison);
+}
+
+template<>
+struct VLSimdLanes<1>
+{
+    static VLSimdRegister broadcast(std::uint8_t value)
+    {
+        return _mm_set1_epi8((char) value);
+    }
+
+    static std::uint32_t equalMask(const unsigned char *bytes, VLSimdRegister value)
+    {
+        return vlSimdMask(_mm_cmpeq_epi8(vlSimdLoad(bytes), value));
+    }
+};
+
+template<>
+struct VLSimdLanes<2>
+{
+    static VLSimdRegister broadcast(std::uint16_t value)
+    {
+        return _mm_set1_epi16((short) value);
+    }
+
+    static std::uint32_t equalMask(const unsigned char *bytes, VLSimdRegister value)
+    {
+        return vlSimdMask(_mm_cmpeq_epi16(vlSimdLoad(bytes), value));
+    }
+};
+
+template<>
+struct VLSimdLanes<4>
+{
+    static VLSimdRegister broadcast(std::uint32_t value)
+    {
+        return _mm_set1_epi32((int) value);
+    }
+
+    static std::uint32_t equalMask(const unsigned char *bytes, VLSimdRegister value)
+    {
+        return vlSimdMask(_mm_cmpeq_epi32(vlSimdLoad(bytes), value));
+    }
+};
+
+template<>
+struct VLSimdLanes<8>
+{
+    static VLSimdRegister broadcast(std::uint64_t value)
+    {
+        return _mm_set1_epi64x((long long) value);
+    }
+
+    static std::uint32_t equalMask(const unsigned char *bytes, VLSimdRegister value)
+    {
+#ifdef __SSE4_1__
+        return vlSimdMask(_mm_cmpeq_epi64(vlSimdLoad(bytes), value));
+#else
+        // SSE2 compares 32 bit halves, an element is equal only if both its halves are:
+        std::uint32_t mask = vlSimdMask(_mm_cmpeq_epi32(vlSimdLoad(bytes), value));
+        return ((mask & 0xFFu) == 0xFFu ? 0xFFu : 0u) | ((mask & 0xFF00u) == 0xFF00u ? 0xFF00u : 0u);
+#endif
+    }
+};
+
+#endif
+
+/**
+ * @brief The unsigned integer type with a given size.
+ */
+template<std::size_t Size>
+struct VLSimdUnsigned;
+
+template<>
+struct VLSimdUnsigned<1>
+{
+    typedef std::uint8_t type;
+};
+
+template<>
+struct VLSimdUnsigned<2>
+{
+    typedef std::uint16_t type;
+};
+
+template<>
+struct VLSimdUnsigned<4>
+{
+    typedef std::uint32_t type;
+};
+
+template<>
+struct VLSimdUnsigned<8>
+{
+    typedef std::uint64_t type;
+};
+
+#endif
+
+/**
+ * @brief Comparison, search and hashing of contiguous element ranges, with vectorized paths for
+ * trivially comparable elements and scalar fallbacks for all other element types.
+ */
+struct VLSimd
+{
+private:
+    /**
+     * @brief Tells whether ranges of T are searched with vector registers.
+     */
+    template<typename T>
+    using _Searchable = std::integral_constant<bool,
+#ifdef VLVECTOR_SIMD_WIDTH
+            VLTriviallyComparable<T>::value &&
+            (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+#else
+            false
+#endif
+    >;
+
+    /**
+     * @brief Returns the index of the first differing byte of two byte ranges.
+     * @param first the first range.
+     * @param second the second range.
+     * @param bytes the size of both ranges.
+     * @return the index of the first differing byte, or bytes if the ranges are equal.
+     */
+    static std::size_t _mismatch(const unsigned char *first, const unsigned char *second,
+                                 std::size_t bytes) noexcept
+    {
+        std::size_t index = 0;
+#ifdef VLVECTOR_SIMD_WIDTH
+        for (; index + VLVECTOR_SIMD_WIDTH <= bytes; index += VLVECTOR_SIMD_WIDTH)
+        {
+            std::uint32_t equal = VLSimdLanes<1>::equalMask(first + index, vlSimdLoad(second + index));
+            std::uint32_t differ = ~equal & (std::uint32_t) ((1ULL << VLVECTOR_SIMD_WIDTH) - 1);
+            if (differ != 0)
+            {
+                return index + __builtin_ctz(differ);
+            }
+        }
+#endif
+        for (; index < bytes && first[index] == second[index]; ++index)
+        {
+        }
+        return index;
+    }
+
+    /**
+     * @brief Lexicographically compares trivially comparable elements by finding the first
+     * differing byte and comparing the element that holds it.
+     */
+    template<typename T>
+    static bool _less(const T *first, std::size_t firstSize, const T *second, std::size_t secondSize,
+                      std::true_type)
+    {
+        const std::size_t common = std::min(firstSize, secondSize);
+        const std::size_t byte = _mismatch(reinterpret_cast<const unsigned char *>(first),
+                                           reinterpret_cast<const unsigned char *>(second),
+                                           common * sizeof(T));
+        const std::size_t index = byte / sizeof(T);
+        return index < common ? first[index] < second[index] : firstSize < secondSize;
+    }
+
+    /**
+     * @brief Lexicographically compares elements one by one.
+     */
+    template<typename T>
+    static bool _less(const T *first, std::size_t firstSize, const T *second, std::size_t secondSize,
+                      std::false_type)
+    {
+        return std::lexicographical_compare(first, first + firstSize, second, second + secondSize);
+    }
+
+#ifdef VLVECTOR_SIMD_WIDTH
+
+    /**
+     * @brief Broadcasts a value to every lane of a vector register.
+     */
+    template<typename T>
+    static VLSimdRegister _broadcast(const T &value) noexcept
+    {
+        typename VLSimdUnsigned<sizeof(T)>::type bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        return VLSimdLanes<sizeof(T)>::broadcast(bits);
+    }
+
+    /**
+     * @brief Finds a value with vector register comparisons.
+     */
+    template<typename T>
+    static const T *_find(const T *first, const T *last, const T &value, std::true_type) noexcept
+    {
+        const VLSimdRegister broadcast = _broadcast(value);
+        const std::size_t perRegister = VLVECTOR_SIMD_WIDTH / sizeof(T);
+        for (; last - first >= (std::ptrdiff_t) perRegister; first += perRegister)
+        {
+            std::uint32_t mask = VLSimdLanes<sizeof(T)>::equalMask(
+                    reinterpret_cast<const unsigned char *>(first), broadcast);
+            if (mask != 0)
+            {
+                return first + __builtin_ctz(mask) / sizeof(T);
+            }
+        }
+        return std::find(first, last, value);
+    }
+
+    /**
+     * @brief Counts a value with vector register comparisons.
+     */
+    template<typename T>
+    static std::size_t _count(const T *first, const T *last, const T &value, std::true_type) noexcept
+    {
+        const VLSimdRegister broadcast = _broadcast(value);
+        const std::size_t perRegister = VLVECTOR_SIMD_WIDTH / sizeof(T);
+        std::size_t matchingBytes = 0;
+        for (; last - first >= (std::ptrdiff_t) perRegister; first += perRegister)
+        {
+            matchingBytes += __builtin_popcount(VLSimdLanes<sizeof(T)>::equalMask(
+                    reinterpret_cast<const unsigned char *>(first), broadcast));
+        }
+        return matchingBytes / sizeof(T) + std::count(first, last, value);
+    }
+
+#endif
+
+    /**
+     * @brief Finds a value by comparing elements one by one.
+     */
+    template<typename T>
+    static const T *_find(const T *first, const T *last, const T &value, std::false_type)
+    {
+        return std::find(first, last, value);
+    }
+
+    /**
+     * @brief Counts a value by comparing elements one by one.
+     */
+    template<typename T>
+    static std::size_t _count(const T *first, const T *last, const T &value, std::false_type)
+    {
+        return std::count(first, last, value);
+    }
+
+    /**
+     * @brief Mixes the bits of a hash value.
+     */
+    static std::uint64_t _mix(std::uint64_t value) noexcept
+    {
+        value ^= value >> 33;
+        value *= 0xFF51AFD7ED558CCDULL;
+        value ^= value >> 33;
+        value *= 0xC4CEB9FE1A85EC53ULL;
+        return value ^ (value >> 33);
+    }
+
+    /**
+     * @brief Reads 8 bytes from unaligned memory.
+     */
+    static std::uint64_t _load64(const unsigned char *bytes) noexcept
+    {
+        std::uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Hashes the bytes of trivially comparable elements.
+     */
+    template<typename T>
+    static std::size_t _hash(const T *first, std::size_t count, std::true_type) noexcept
+    {
+        return hashBytes(first, count * sizeof(T));
+    }
+
+    /**
+     * @brief Combines the std::hash values of the elements.
+     */
+    template<typename T>
+    static std::size_t _hash(const T *first, std::size_t count, std::false_type)
+    {
+        std::uint64_t hash = count;
+        for (const T *it = first; it != first + count; ++it)
+        {
+            hash = (hash ^ std::hash<T>()(*it)) * VLVECTOR_HASH_MULTIPLIER;
+        }
+        return (std::size_t) _mix(hash);
+    }
+
+public:
+    /**
+     * @brief Checks if two ranges of a given size hold equal elements.
+     * @param first the first range.
+     * @param second the second range.
+     * @param count the amount of elements in each range.
+     * @return true iff the ranges are equal.
+     */
+    template<typename T>
+    static bool equal(const T *first, const T *second, std::size_t count)
+    {
+        if (VLTriviallyComparable<T>::value)
+        {
+            return count == 0 || std::memcmp(first, second, count * sizeof(T)) == 0;
+        }
+        return std::equal(first, first + count, second);
+    }
+
+    /**
+     * @brief Checks if a range is lexicographically less than another range.
+     * @param first the first range.
+     * @param firstSize the amount of elements in the first range.
+     * @param second the second range.
+     * @param secondSize the amount of elements in the second range.
+     * @return true iff the first range is less than the second range.
+     */
+    template<typename T>
+    static bool less(const T *first, std::size_t firstSize, const T *second, std::size_t secondSize)
+    {
+        return _less(first, firstSize, second, secondSize, VLTriviallyComparable<T>());
+    }
+
+    /**
+     * @brief Finds the first element of a range that equals a given value.
+     * @param first pointer to the first element of the range.
+     * @param last pointer past the last element of the range.
+     * @param value the value to find.
+     * @return a pointer to the first equal element, or last if there is none.
+     */
+    template<typename T>
+    static const T *find(const T *first, const T *last, const T &value)
+    {
+        return _find(first, last, value, _Searchable<T>());
+    }
+
+    /**
+     * @brief Counts the elements of a range that equal a given value.
+     * @param first pointer to the first element of the range.
+     * @param last pointer past the last element of the range.
+     * @param value the value to count.
+     * @return the amount of equal elements.
+     */
+    template<typename T>
+    static std::size_t count(const T *first, const T *last, const T &value)
+    {
+        return _count(first, last, value, _Searchable<T>());
+    }
+
+    /**
+     * @brief Hashes a range of elements. Ranges that compare equal have equal hashes.
+     * @param first pointer to the first element of the range.
+     * @param count the amount of elements in the range.
+     * @return the hash of the range.
+     */
+    template<typename T>
+    static std::size_t hash(const T *first, std::size_t count)
+    {
+        return _hash(first, count, VLTriviallyComparable<T>());
+    }
+
+    /**
+     * @brief Hashes a range of bytes, 32 bytes at a time in four independent lanes so the
+     * multiplications of consecutive words overlap.
+     * @param data the bytes to hash.
+     * @param bytes the amount of bytes.
+     * @return the hash of the bytes.
+     */
+    static std::size_t hashBytes(const void *data, std::size_t bytes) noexcept
+    {
+        const unsigned char *current = static_cast<const unsigned char *>(data);
+        const unsigned char *end = current + bytes;
+        std::uint64_t lanes[4] = {VLVECTOR_HASH_MULTIPLIER, bytes, ~(std::uint64_t) bytes,
+                                  VLVECTOR_HASH_MULTIPLIER ^ bytes};
+        for (; end - current >= 32; current += 32)
+        {
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                lanes[lane] = (lanes[lane] ^ _load64(current + 8 * lane)) * VLVECTOR_HASH_MULTIPLIER;
+                lanes[lane] ^= lanes[lane] >> 29;
+            }
+        }
+        for (int lane = 0; end - current >= 8; current += 8, ++lane)
+        {
+            lanes[lane] = (lanes[lane] ^ _load64(current)) * VLVECTOR_HASH_MULTIPLIER;
+        }
+        std::uint64_t tail = 0;
+        if (current != end)
+        {
+            std::memcpy(&tail, current, end - current);
+        }
+        std::uint64_t hash = _mix(lanes[0] ^ tail) ^ _mix(lanes[1]) * 3 ^ _mix(lanes[2]) * 5 ^
+                             _mix(lanes[3]) * 7;
+        return (std::size_t) _mix(hash);
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLVECTORSIMD_HPP
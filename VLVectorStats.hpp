@@ -0,0 +1,300 @@
+//
+// Opt-in statistics for VLVector, enabled by defining VLVECTOR_ENABLE_STATS before including
+// VLVector.hpp. Every VLVector instantiation gets its own counters, which are registered in a
+// process-wide registry that prints a report on demand or at exit.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLVECTORSTATS_HPP
+#define CPP_FINAL_PROJECT_VLVECTORSTATS_HPP
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+
+#if defined(__GNUG__) && defined(__has_include)
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#define VLVECTOR_STATS_DEMANGLE
+#endif
+#endif
+
+/**
+ * @brief The statistics counters of a single VLVector instantiation.
+ * Counters are atomic, so vectors of the same type may be used from several threads.
+ */
+struct VLStatCounters
+{
+    /**
+     * @brief The amount of vectors constructed.
+     */
+    std::atomic<std::size_t> instances{0};
+
+    /**
+     * @brief The amount of times a vector moved its elements from the stack to the heap.
+     */
+    std::atomic<std::size_t> spills{0};
+
+    /**
+     * @brief The amount of times a vector on the heap moved to a new heap storage.
+     */
+    std::atomic<std::size_t> reallocations{0};
+
+    /**
+     * @brief The amount of times a vector moved its elements from the heap back to the stack.
+     */
+    std::atomic<std::size_t> returnsToStack{0};
+
+    /**
+     * @brief The amount of elements copy constructed from another vector.
+     */
+    std::atomic<std::size_t> elementsCopied{0};
+
+    /**
+     * @brief The amount of elements relocated between storages or move constructed from
+     * another vector.
+     */
+    std::atomic<std::size_t> elementsMoved{0};
+
+    /**
+     * @brief The largest size any vector reached.
+     */
+    std::atomic<std::size_t> peakSize{0};
+
+    /**
+     * @brief Raises the peak size to a given size if it is larger.
+     * @param size the size a vector reached.
+     */
+    void recordSize(std::size_t size) noexcept
+    {
+        std::size_t peak = peakSize.load(std::memory_order_relaxed);
+        while (size > peak && !peakSize.compare_exchange_weak(peak, size, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    /**
+     * @brief Sets all counters to zero.
+     */
+    void reset() noexcept
+    {
+        instances = 0;
+        spills = 0;
+        reallocations = 0;
+        returnsToStack = 0;
+        elementsCopied = 0;
+        elementsMoved = 0;
+        peakSize = 0;
+    }
+};
+
+/**
+ * @brief The process-wide registry of the counters of all VLVector instantiations in use.
+ */
+class VLStatsRegistry
+{
+private:
+    /**
+     * @brief The counters of an instantiation, with the name of its type.
+     */
+    struct _Entry
+    {
+        std::string name;
+        VLStatCounters counters;
+
+        explicit _Entry(std::string typeName) : name(std::move(typeName))
+        {
+        }
+    };
+
+    // A deque never moves its elements, so counters may be referenced while others are added:
+    std::deque<_Entry> _entries;
+    mutable std::mutex _mutex;
+
+    VLStatsRegistry() = default;
+
+    /**
+     * @brief Prints the report of the registry to stderr, registered by reportAtExit.
+     */
+    static void _reportToStderr()
+    {
+        instance().report(stderr);
+    }
+
+public:
+    VLStatsRegistry(const VLStatsRegistry &) = delete;
+
+    VLStatsRegistry &operator=(const VLStatsRegistry &) = delete;
+
+    /**
+     * @brief Returns the registry.
+     * The registry is never destroyed, so vectors with static storage duration may still
+     * update their counters while the program exits.
+     * @return the registry.
+     */
+    static VLStatsRegistry &instance()
+    {
+        static VLStatsRegistry *registry = new VLStatsRegistry();
+        return *registry;
+    }
+
+    /**
+     * @brief Adds the counters of an instantiation to the registry.
+     * @param name the name of the instantiation.
+     * @return the counters of the instantiation, which live as long as the program.
+     */
+    VLStatCounters &add(std::string name)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.emplace_back(std::move(name));
+        return _entries.back().counters;
+    }
+
+    /**
+     * @brief Prints the counters of every instantiation.
+     * @param out the stream to print to.
+     */
+    void report(std::FILE *out) const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        std::fprintf(out, "VLVector statistics (%zu instantiations)\n", _entries.size());
+        for (const _Entry &entry : _entries)
+        {
+            const VLStatCounters &counters = entry.counters;
+            std::fprintf(out, "%s\n", entry.name.c_str());
+            std::fprintf(out, "  instances %zu, spills %zu, reallocations %zu, returns to stack %zu\n",
+                         counters.instances.load(), counters.spills.load(),
+                         counters.reallocations.load(), counters.returnsToStack.load());
+            std::fprintf(out, "  elements copied %zu, elements moved %zu, peak size %zu\n",
+                         counters.elementsCopied.load(), counters.elementsMoved.load(),
+                         counters.peakSize.load());
+        }
+    }
+
+    /**
+     * @brief Sets the counters of every instantiation to zero.
+     */
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (_Entry &entry : _entries)
+        {
+            entry.counters.reset();
+        }
+    }
+
+    /**
+     * @brief Makes the program print the report to stderr when it exits.
+     * Calling this method more than once prints a single report.
+     */
+    void reportAtExit()
+    {
+        static const bool registered = std::atexit(_reportToStderr) == 0;
+        (void) registered;
+    }
+};
+
+/**
+ * @brief The statistics hooks of a VLVector instantiation, called by the vector when
+ * VLVECTOR_ENABLE_STATS is defined.
+ * @tparam Vector the VLVector instantiation.
+ */
+template<typename Vector>
+class VLVectorStats
+{
+private:
+    /**
+     * @brief Returns the readable name of the instantiation.
+     * @return the name of the instantiation.
+     */
+    static std::string _typeName()
+    {
+        const char *name = typeid(Vector).name();
+#ifdef VLVECTOR_STATS_DEMANGLE
+        int status = 0;
+        char *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status == 0 && demangled != nullptr)
+        {
+            std::string result(demangled);
+            std::free(demangled);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+public:
+    /**
+     * @brief Returns the counters of the instantiation, registering them on first use.
+     * @return the counters of the instantiation.
+     */
+    static VLStatCounters &counters()
+    {
+        static VLStatCounters &instantiationCounters = VLStatsRegistry::instance().add(_typeName());
+        return instantiationCounters;
+    }
+
+    /**
+     * @brief Counts a constructed vector.
+     */
+    static void construct() noexcept
+    {
+        counters().instances.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts a move from the stack to the heap.
+     */
+    static void spill() noexcept
+    {
+        counters().spills.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts a move to a new heap storage.
+     */
+    static void reallocation() noexcept
+    {
+        counters().reallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts a move from the heap back to the stack.
+     */
+    static void returnToStack() noexcept
+    {
+        counters().returnsToStack.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts copy constructed elements.
+     * @param count the amount of elements.
+     */
+    static void copied(std::size_t count) noexcept
+    {
+        counters().elementsCopied.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts relocated or move constructed elements.
+     * @param count the amount of elements.
+     */
+    static void moved(std::size_t count) noexcept
+    {
+        counters().elementsMoved.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Records the size a vector reached.
+     * @param size the size of the vector.
+     */
+    static void size(std::size_t size) noexcept
+    {
+        counters().recordSize(size);
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLVECTORSTATS_HPP
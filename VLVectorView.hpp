@@ -0,0 +1,475 @@
+//
+// Binary serialization of VLVectors of trivially copyable elements, and a non-owning read-only
+// view over contiguous elements in external memory (e.g. a mapped file or a receive buffer).
+// A serialized vector is a VLSerialHeader followed by the bytes of its live elements, so it is
+// written with one write of data() and read back in place by a view without copying.
+// The format uses the byte order of the writer; a reader of the other byte order rejects it.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLVECTORVIEW_HPP
+#define CPP_FINAL_PROJECT_VLVECTORVIEW_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include "VLVector.hpp"
+
+#define VLSERIAL_MAGIC 0x31564C56u
+#define VLSERIAL_VERSION 1
+// The most bytes of elements read from a stream before the vector grows for the next ones:
+#define VLSERIAL_READ_CHUNK_BYTES (1 << 16)
+#define FORMAT_EXCEPTION_MSG "Buffer does not hold a serialized VLVector of this element type"
+#define ALIGNMENT_EXCEPTION_MSG "Buffer is not aligned for the element type"
+#define WRITE_EXCEPTION_MSG "Could not write the serialized VLVector"
+#define READ_EXCEPTION_MSG "Could not read the serialized VLVector"
+#define BUFFER_EXCEPTION_MSG "Buffer is too small for the serialized VLVector"
+
+/**
+ * @brief The header of a serialized vector. The elements follow it, at an offset aligned to
+ * 32 bytes from the start of the header.
+ */
+struct VLSerialHeader
+{
+    // "VLV1" in the byte order of the writer:
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint16_t headerSize;
+    std::uint32_t elementSize;
+    std::uint32_t elementAlignment;
+    std::uint64_t size;
+    std::uint64_t reserved;
+
+    /**
+     * @brief Constructs the header of a vector of a given element type.
+     * @tparam T the type of the elements.
+     * @param size the amount of elements.
+     * @return the header.
+     */
+    template<typename T>
+    static VLSerialHeader of(std::size_t size) noexcept
+    {
+        VLSerialHeader header;
+        header.magic = VLSERIAL_MAGIC;
+        header.version = VLSERIAL_VERSION;
+        header.headerSize = sizeof(VLSerialHeader);
+        header.elementSize = sizeof(T);
+        header.elementAlignment = alignof(T);
+        header.size = size;
+        header.reserved = 0;
+        return header;
+    }
+
+    /**
+     * @brief Checks that the header describes elements of a given type, in this version and
+     * byte order.
+     * @tparam T the type of the elements.
+     * @return true iff the elements may be read as values of type T.
+     */
+    template<typename T>
+    bool matches() const noexcept
+    {
+        return magic == VLSERIAL_MAGIC && version == VLSERIAL_VERSION &&
+               headerSize == sizeof(VLSerialHeader) && elementSize == sizeof(T) &&
+               elementAlignment == alignof(T);
+    }
+};
+
+static_assert(sizeof(VLSerialHeader) == 32, "VLSerialHeader must not be padded");
+
+/**
+ * @brief A non-owning read-only view of contiguous elements, offering the read API of VLVector.
+ * The view does not copy the elements, so the memory it views must outlive it.
+ * @tparam T the type of the elements.
+ */
+template<typename T>
+class VLVectorView
+{
+private:
+    const T *_data;
+    std::size_t _size;
+
+public:
+    typedef T value_type;
+    typedef const T &reference;
+    typedef const T &const_reference;
+    typedef const T *iterator;
+    typedef const T *const_iterator;
+    typedef std::reverse_iterator<const T *> reverse_iterator;
+    typedef std::reverse_iterator<const T *> const_reverse_iterator;
+
+    /**
+     * @brief Constructs an empty view.
+     */
+    VLVectorView() noexcept : _data(nullptr), _size(0)
+    {
+    }
+
+    /**
+     * @brief Constructs a view of a given range of elements.
+     * @param data pointer to the first element.
+     * @param size the amount of elements.
+     */
+    VLVectorView(const T *data, std::size_t size) noexcept : _data(data), _size(size)
+    {
+    }
+
+    /**
+     * @brief Constructs a view of the elements of a vector, valid until the vector changes.
+     * @param vec the vector.
+     */
+    template<size_t StaticCapacity, typename GrowthPolicy, typename Allocator, typename SizeType>
+    VLVectorView(const VLVector<T, StaticCapacity, GrowthPolicy, Allocator, SizeType> &vec) noexcept
+            : _data(vec.data()), _size(vec.size())
+    {
+    }
+
+    /**
+     * @brief Constructs a view of a vector serialized in a buffer, without copying the elements.
+     * Throws std::invalid_argument if the buffer does not hold a vector of this element type
+     * or is not aligned for it, and std::length_error if it is shorter than the vector.
+     * @param buffer the buffer, e.g. a mapped file.
+     * @param bytes the size of the buffer.
+     * @return a view of the elements in the buffer.
+     */
+    static VLVectorView fromSerialized(const void *buffer, std::size_t bytes)
+    {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable elements may be viewed in a buffer");
+        VLSerialHeader header;
+        if (bytes < sizeof(header))
+        {
+            throw std::invalid_argument(FORMAT_EXCEPTION_MSG);
+        }
+        std::memcpy(&header, buffer, sizeof(header));
+        if (!header.matches<T>())
+        {
+            throw std::invalid_argument(FORMAT_EXCEPTION_MSG);
+        }
+        if (header.size > (bytes - sizeof(header)) / sizeof(T))
+        {
+            throw std::length_error(BUFFER_EXCEPTION_MSG);
+        }
+        const unsigned char *elements = static_cast<const unsigned char *>(buffer) + sizeof(header);
+        if (reinterpret_cast<std::uintptr_t>(elements) % alignof(T) != 0)
+        {
+            throw std::invalid_argument(ALIGNMENT_EXCEPTION_MSG);
+        }
+        return VLVectorView(reinterpret_cast<const T *>(elements), (std::size_t) header.size);
+    }
+
+    /**
+     * @brief Returns the number of elements in the view.
+     * @return the number of elements.
+     */
+    std::size_t size() const noexcept
+    {
+        return _size;
+    }
+
+    /**
+     * @brief Checks if the view is empty.
+     * @return true iff the view has no elements.
+     */
+    bool empty() const noexcept
+    {
+        return _size == 0;
+    }
+
+    /**
+     * @brief Returns a pointer to the first element.
+     * @return a pointer to the first element.
+     */
+    const T *data() const noexcept
+    {
+        return _data;
+    }
+
+    /**
+     * @brief Gets an index and returns the value associated to it.
+     * @param index the given index.
+     * @return the value associated to the index.
+     */
+    const T &operator[](std::size_t index) const noexcept
+    {
+        return _data[index];
+    }
+
+    /**
+     * @brief Gets an index and returns the value associated to it.
+     * Throws an exception if the index was not found.
+     * @param index the index of the value in the view.
+     * @return the value that is associated to the index.
+     */
+    const T &at(std::size_t index) const
+    {
+        if (index >= _size)
+        {
+            throw std::out_of_range(AT_EXCEPTION_MSG);
+        }
+        return _data[index];
+    }
+
+    /**
+     * @brief Finds the first element that equals a given value.
+     * @param val the value to find.
+     * @return an iterator to the first equal element, or end() if there is none.
+     */
+    const_iterator find(const T &val) const
+    {
+        return VLSimd::find<T>(_data, _data + _size, val);
+    }
+
+    /**
+     * @brief Checks if the view holds a given value.
+     * @param val the value to look for.
+     * @return true iff an element equals the value.
+     */
+    bool contains(const T &val) const
+    {
+        return find(val) != end();
+    }
+
+    /**
+     * @brief Counts the elements that equal a given value.
+     * @param val the value to count.
+     * @return the amount of equal elements.
+     */
+    std::size_t count(const T &val) const
+    {
+        return VLSimd::count<T>(_data, _data + _size, val);
+    }
+
+    /**
+     * @brief Checks if two views hold equal elements.
+     * @param other the other view.
+     * @return true iff the views are equal.
+     */
+    bool operator==(const VLVectorView &other) const
+    {
+        return _size == other._size && VLSimd::equal(_data, other._data, _size);
+    }
+
+    bool operator!=(const VLVectorView &other) const
+    {
+        return !operator==(other);
+    }
+
+    /**
+     * @brief Checks if this view is lexicographically less than another view.
+     * @param other the other view.
+     * @return true iff this view is less than the other view.
+     */
+    bool operator<(const VLVectorView &other) const
+    {
+        return VLSimd::less(_data, _size, other._data, other._size);
+    }
+
+    bool operator>(const VLVectorView &other) const
+    {
+        return other < *this;
+    }
+
+    bool operator<=(const VLVectorView &other) const
+    {
+        return !(other < *this);
+    }
+
+    bool operator>=(const VLVectorView &other) const
+    {
+        return !(*this < other);
+    }
+
+    /********************************************************************
+    *                       Begin and end iterators                     *
+    ********************************************************************/
+
+    const_iterator begin() const noexcept
+    {
+        return _data;
+    }
+
+    const_iterator end() const noexcept
+    {
+        return _data + _size;
+    }
+
+    const_iterator cbegin() const noexcept
+    {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept
+    {
+        return end();
+    }
+
+    const_reverse_iterator rbegin() const noexcept
+    {
+        return const_reverse_iterator(end());
+    }
+
+    const_reverse_iterator rend() const noexcept
+    {
+        return const_reverse_iterator(begin());
+    }
+};
+
+/**
+ * @brief Serializes VLVectors of trivially copyable elements as a header followed by the bytes
+ * of the live elements.
+ */
+struct VLVectorSerializer
+{
+    /**
+     * @brief Returns the amount of bytes a vector takes when serialized.
+     * @param vec the vector.
+     * @return the serialized size in bytes.
+     */
+    template<typename Vector>
+    static std::size_t serializedSize(const Vector &vec) noexcept
+    {
+        return sizeof(VLSerialHeader) + vec.size() * sizeof(typename Vector::value_type);
+    }
+
+    /**
+     * @brief Writes a vector to a stream: the header, then all elements in a single write.
+     * Throws std::runtime_error if the stream fails.
+     * @param vec the vector.
+     * @param out the stream, which should be opened in binary mode.
+     */
+    template<typename Vector>
+    static void write(const Vector &vec, std::ostream &out)
+    {
+        typedef typename Vector::value_type T;
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable elements may be serialized");
+        const VLSerialHeader header = VLSerialHeader::of<T>(vec.size());
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(vec.data()),
+                  (std::streamsize) (vec.size() * sizeof(T)));
+        if (!out)
+        {
+            throw std::runtime_error(WRITE_EXCEPTION_MSG);
+        }
+    }
+
+    /**
+     * @brief Writes a vector to a buffer.
+     * Throws std::length_error if the buffer is smaller than serializedSize(vec).
+     * @param vec the vector.
+     * @param buffer the buffer.
+     * @param bytes the size of the buffer.
+     * @return the amount of bytes written.
+     */
+    template<typename Vector>
+    static std::size_t write(const Vector &vec, void *buffer, std::size_t bytes)
+    {
+        typedef typename Vector::value_type T;
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable elements may be serialized");
+        const std::size_t needed = serializedSize(vec);
+        if (bytes < needed)
+        {
+            throw std::length_error(BUFFER_EXCEPTION_MSG);
+        }
+        const VLSerialHeader header = VLSerialHeader::of<T>(vec.size());
+        std::memcpy(buffer, &header, sizeof(header));
+        if (!vec.empty())
+        {
+            std::memcpy(static_cast<unsigned char *>(buffer) + sizeof(header), vec.data(),
+                        vec.size() * sizeof(T));
+        }
+        return needed;
+    }
+
+    /**
+     * @brief Reads a vector from a stream, replacing the elements of a given vector.
+     * The elements are read straight into the storage of the vector in chunks of at most
+     * VLSERIAL_READ_CHUNK_BYTES, and the vector grows as they arrive, so a header that claims more
+     * elements than the stream holds cannot make it allocate more than the stream's length.
+     * Throws std::invalid_argument if the stream does not hold a vector of this element type,
+     * and std::runtime_error if the stream ends early, in which case the vector is left empty.
+     * @param in the stream, which should be opened in binary mode.
+     * @param vec the vector to read into.
+     */
+    template<typename Vector>
+    static void read(std::istream &in, Vector &vec)
+    {
+        typedef typename Vector::value_type T;
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable elements may be deserialized");
+        VLSerialHeader header;
+        if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        {
+            throw std::runtime_error(READ_EXCEPTION_MSG);
+        }
+        if (!header.matches<T>())
+        {
+            throw std::invalid_argument(FORMAT_EXCEPTION_MSG);
+        }
+        if (header.size > vec.max_size())
+        {
+            throw std::length_error(LENGTH_EXCEPTION_MSG);
+        }
+        // The elements are read straight into uninitialised storage, instead of value
+        // initialising them first and then overwriting them:
+        const std::size_t chunk = std::max<std::size_t>(1, VLSERIAL_READ_CHUNK_BYTES / sizeof(T));
+        vec.clear();
+        for (std::size_t remaining = (std::size_t) header.size; remaining > 0;)
+        {
+            const std::size_t count = std::min(remaining, chunk);
+            T *elements = vec.append_uninitialized(count);
+            if (!in.read(reinterpret_cast<char *>(elements), (std::streamsize) (count * sizeof(T))))
+            {
+                vec.clear();
+                throw std::runtime_error(READ_EXCEPTION_MSG);
+            }
+            remaining -= count;
+        }
+    }
+
+    /**
+     * @brief Reads a vector from a buffer, copying the elements into a given vector.
+     * Use VLVectorView::fromSerialized to read them in place instead.
+     * @param buffer the buffer.
+     * @param bytes the size of the buffer.
+     * @param vec the vector to read into.
+     */
+    template<typename Vector>
+    static void read(const void *buffer, std::size_t bytes, Vector &vec)
+    {
+        typedef typename Vector::value_type T;
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable elements may be deserialized");
+        VLSerialHeader header;
+        if (bytes < sizeof(header))
+        {
+            throw std::invalid_argument(FORMAT_EXCEPTION_MSG);
+        }
+        std::memcpy(&header, buffer, sizeof(header));
+        if (!header.matches<T>())
+        {
+            throw std::invalid_argument(FORMAT_EXCEPTION_MSG);
+        }
+        if (header.size > (bytes - sizeof(header)) / sizeof(T))
+        {
+            throw std::length_error(BUFFER_EXCEPTION_MSG);
+        }
+        // The buffer may be unaligned, so the elements are copied as bytes:
+        vec.clear();
+        vec.reserve((std::size_t) header.size);
+        T *elements = vec.append_uninitialized((std::size_t) header.size);
+        if (header.size != 0)
+        {
+            std::memcpy(elements, static_cast<const unsigned char *>(buffer) + sizeof(header),
+                        header.size * sizeof(T));
+        }
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_VLVECTORVIEW_HPP
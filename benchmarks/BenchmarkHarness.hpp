@@ -0,0 +1,169 @@
+//
+// A small self-contained benchmark harness: times a scenario, counts the heap allocations it
+// performs and reports the results as a table and optionally as JSON.
+// The translation unit that uses it must define gAllocations (usually by replacing the global
+// operator new) and gBytesCopied (usually from a copy counting element wrapper).
+//
+
+#ifndef CPP_FINAL_PROJECT_BENCHMARKHARNESS_HPP
+#define CPP_FINAL_PROJECT_BENCHMARKHARNESS_HPP
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+extern std::size_t gAllocations;
+extern std::size_t gBytesCopied;
+
+/**
+ * @brief Keeps the optimiser from discarding a value that a benchmark computed.
+ * @param value the value to keep.
+ */
+template<typename T>
+inline void doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief A single benchmark result.
+ */
+struct BenchmarkResult
+{
+    std::string container;
+    std::string element;
+    std::string operation;
+    std::size_t staticCapacity;
+    std::size_t size;
+    std::size_t objectSize;
+    double nsPerOp;
+    double allocationsPerOp;
+    double bytesCopiedPerOp;
+};
+
+/**
+ * @brief Measures the time and allocations of a scenario.
+ * A scenario provides a State type, a static setup(n) that builds the state outside of the
+ * measurement, a static run(state, n) that is measured and a static ops(n) that tells how many
+ * operations a single run performs.
+ */
+class BenchmarkRunner
+{
+private:
+    double _minTimeNs;
+
+public:
+    /**
+     * @brief Constructs a runner.
+     * @param minTimeMs the minimal total time to spend measuring each scenario.
+     */
+    explicit BenchmarkRunner(double minTimeMs) : _minTimeNs(minTimeMs * 1e6)
+    {
+    }
+
+    /**
+     * @brief Runs a scenario until the minimal time was spent on it.
+     * @param size the size to pass to the scenario.
+     * @param nsPerOp set to the average time per operation.
+     * @param allocationsPerOp set to the average amount of allocations per operation.
+     */
+    template<typename Scenario>
+    void measure(std::size_t size, double &nsPerOp, double &allocationsPerOp) const
+    {
+        double totalNs = 0;
+        std::size_t totalOps = 0;
+        std::size_t totalAllocations = 0;
+        for (int runs = 0; runs < 3 || totalNs < _minTimeNs; ++runs)
+        {
+            typename Scenario::State state = Scenario::setup(size);
+            std::size_t allocationsBefore = gAllocations;
+            auto start = std::chrono::steady_clock::now();
+            Scenario::run(state, size);
+            auto end = std::chrono::steady_clock::now();
+            totalAllocations += gAllocations - allocationsBefore;
+            totalNs += std::chrono::duration<double, std::nano>(end - start).count();
+            totalOps += Scenario::ops(size);
+        }
+        nsPerOp = totalNs / totalOps;
+        allocationsPerOp = (double) totalAllocations / totalOps;
+    }
+
+    /**
+     * @brief Runs a scenario once and returns the element bytes it copied or moved per operation.
+     * The scenario should store elements that count their copies into gBytesCopied.
+     * @param size the size to pass to the scenario.
+     * @return the average amount of element bytes copied or moved per operation.
+     */
+    template<typename Scenario>
+    double countBytesCopied(std::size_t size) const
+    {
+        typename Scenario::State state = Scenario::setup(size);
+        std::size_t bytesBefore = gBytesCopied;
+        Scenario::run(state, size);
+        return (double) (gBytesCopied - bytesBefore) / Scenario::ops(size);
+    }
+};
+
+/**
+ * @brief Collects benchmark results, prints them as they arrive and writes them as JSON.
+ */
+class BenchmarkReporter
+{
+private:
+    std::vector<BenchmarkResult> _results;
+
+public:
+    /**
+     * @brief Prints the header of the results table.
+     */
+    void printHeader() const
+    {
+        std::printf("%-22s %-12s %-14s %6s %7s %7s %12s %12s %14s\n", "container", "element",
+                    "operation", "static", "size", "sizeof", "ns/op", "allocs/op", "bytes/op");
+    }
+
+    /**
+     * @brief Adds a result and prints it.
+     * @param result the result to add.
+     */
+    void add(const BenchmarkResult &result)
+    {
+        std::printf("%-22s %-12s %-14s %6zu %7zu %7zu %12.2f %12.4f %14.1f\n",
+                    result.container.c_str(), result.element.c_str(), result.operation.c_str(),
+                    result.staticCapacity, result.size, result.objectSize, result.nsPerOp,
+                    result.allocationsPerOp, result.bytesCopiedPerOp);
+        std::fflush(stdout);
+        _results.push_back(result);
+    }
+
+    /**
+     * @brief Writes all results as a JSON array.
+     * @param path the file to write to.
+     * @return true iff the file was written.
+     */
+    bool writeJson(const char *path) const
+    {
+        std::FILE *file = std::fopen(path, "w");
+        if (file == nullptr)
+        {
+            return false;
+        }
+        std::fprintf(file, "[\n");
+        for (std::size_t i = 0; i < _results.size(); ++i)
+        {
+            const BenchmarkResult &r = _results[i];
+            std::fprintf(file, "  {\"container\": \"%s\", \"element\": \"%s\", \"operation\": \"%s\", "
+                               "\"static_capacity\": %zu, \"size\": %zu, \"sizeof\": %zu, "
+                               "\"ns_per_op\": %.3f, \"allocations_per_op\": %.5f, "
+                               "\"bytes_copied_per_op\": %.2f}%s\n",
+                         r.container.c_str(), r.element.c_str(), r.operation.c_str(),
+                         r.staticCapacity, r.size, r.objectSize, r.nsPerOp, r.allocationsPerOp,
+                         r.bytesCopiedPerOp, i + 1 < _results.size() ? "," : "");
+        }
+        std::fprintf(file, "]\n");
+        return std::fclose(file) == 0;
+    }
+};
+
+#endif //CPP_FINAL_PROJECT_BENCHMARKHARNESS_HPP
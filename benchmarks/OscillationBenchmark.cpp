@@ -0,0 +1,77 @@
+//
+// Measures a vector whose size oscillates around its static capacity.
+// With a policy that returns to the stack as soon as the size fits there again, every push and
+// pop crosses the stack/heap boundary and allocates. The default policy keeps the heap storage
+// until the size drops well below the static capacity, so the oscillation does not allocate.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "../VLVector.hpp"
+
+#define STATIC_CAPACITY 16
+#define ITERATIONS 1000000
+
+static std::size_t gAllocations = 0;
+
+void *operator new(std::size_t size)
+{
+    ++gAllocations;
+    void *storage = std::malloc(size == 0 ? 1 : size);
+    if (storage == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return storage;
+}
+
+void operator delete(void *storage) noexcept
+{
+    std::free(storage);
+}
+
+void operator delete(void *storage, std::size_t) noexcept
+{
+    std::free(storage);
+}
+
+/**
+ * @brief Fills a vector up to its static capacity and then pushes and pops one element
+ * past it, printing the allocations and the time per operation.
+ * @tparam Vector the vector type to measure.
+ * @param name the name to print for the vector type.
+ */
+template<typename Vector>
+void runOscillation(const char *name)
+{
+    Vector vec;
+    for (int i = 0; i < STATIC_CAPACITY; ++i)
+    {
+        vec.push_back(i);
+    }
+
+    std::size_t allocationsBefore = gAllocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+    {
+        vec.push_back(i);
+        vec.pop_back();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double operations = 2.0 * ITERATIONS;
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::printf("%-32s %10.2f ns/op %10.4f allocations/op\n", name, ns / operations,
+                (double) (gAllocations - allocationsBefore) / operations);
+}
+
+int main()
+{
+    // Returns to the stack as soon as the size fits there, like the original behaviour:
+    runOscillation<VLVector<int, STATIC_CAPACITY, VLGrowthPolicy<3, 2, 1, 1>>>("eager return to stack");
+    runOscillation<VLVector<int, STATIC_CAPACITY>>("default policy");
+    runOscillation<VLVector<int, STATIC_CAPACITY, VLGrowthPolicy<3, 2, 1, 2, false>>>("never return to stack");
+    return 0;
+}
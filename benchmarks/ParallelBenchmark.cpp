@@ -0,0 +1,126 @@
+//
+// Measures the scaling of the parallel algorithms of VLParallel.hpp across thread counts, on a
+// VLVector far larger than the parallel threshold. Each algorithm runs on pools of 1, 2, 4, ...
+// threads up to the hardware concurrency, and the speedup is relative to the single thread pool,
+// which runs the sequential algorithm.
+//
+// Usage: PARALLEL_BENCH [SIZE]
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <thread>
+#include "../VLVector.hpp"
+#include "../VLParallel.hpp"
+
+#define DEF_SIZE 10000000
+#define REPETITIONS 3
+
+typedef VLVector<double, 16> Vector;
+
+/**
+ * @brief Runs an algorithm a few times on fresh copies of the input and returns the best time.
+ * @param input the input vector, copied before every run.
+ * @param algorithm the algorithm, called with a copy of the input.
+ * @return the best time in milliseconds.
+ */
+template<typename Algorithm>
+double measure(const Vector &input, const Algorithm &algorithm)
+{
+    double best = 0;
+    for (int i = 0; i < REPETITIONS; ++i)
+    {
+        Vector vec(input);
+        auto start = std::chrono::steady_clock::now();
+        algorithm(vec);
+        auto end = std::chrono::steady_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        if (i == 0 || ms < best)
+        {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Measures an algorithm on pools of increasing size and prints the times and speedups.
+ * @param name the name of the algorithm.
+ * @param input the input vector.
+ * @param algorithm the algorithm, called with a vector and a pool.
+ */
+template<typename Algorithm>
+void runScaling(const char *name, const Vector &input, const Algorithm &algorithm)
+{
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    double single = 0;
+    for (std::size_t threads = 1;; threads *= 2)
+    {
+        if (threads > hardware)
+        {
+            threads = hardware;
+        }
+        VLWorkStealingPool pool(threads);
+        double ms = measure(input, [&algorithm, &pool](Vector &vec)
+        {
+            algorithm(vec, pool);
+        });
+        if (threads == 1)
+        {
+            single = ms;
+        }
+        std::printf("%-12s %4zu threads %10.2f ms %8.2fx\n", name, threads, ms, single / ms);
+        if (threads == hardware)
+        {
+            break;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    const std::size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : DEF_SIZE;
+    Vector input;
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> distribution(0, 1);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        input.push_back(distribution(random));
+    }
+
+    runScaling("for_each", input, [](Vector &vec, VLWorkStealingPool &pool)
+    {
+        VLParallel::for_each(vec, [](double &value)
+        {
+            value = value * value + 1;
+        }, pool);
+    });
+    runScaling("transform", input, [](Vector &vec, VLWorkStealingPool &pool)
+    {
+        Vector out;
+        VLParallel::transform(vec, out, [](double value)
+        {
+            return value * 2;
+        }, pool);
+    });
+    runScaling("reduce", input, [](Vector &vec, VLWorkStealingPool &pool)
+    {
+        volatile double sum = VLParallel::reduce(vec, 0.0, std::plus<double>(), pool);
+        (void) sum;
+    });
+    runScaling("sort", input, [](Vector &vec, VLWorkStealingPool &pool)
+    {
+        VLParallel::sort(vec, std::less<double>(), pool);
+    });
+    runScaling("compact", input, [](Vector &vec, VLWorkStealingPool &pool)
+    {
+        VLParallel::compact(vec, [](double value)
+        {
+            return value < 0.5;
+        }, pool);
+    });
+    return 0;
+}
@@ -0,0 +1,892 @@
+//
+// Benchmark suite comparing VLVector against std::vector and other small vector designs.
+// Covers push_back across the inline/heap boundary, insert and erase at the front, middle and
+// back, copy, move, swap, iteration and comparison for several element types and static
+// capacities, and reports ns/op, allocations/op and element bytes copied or moved per op.
+//
+// Usage: VLVECTOR_BENCH [--json FILE] [--min-time-ms MS] [--filter TEXT]
+//
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "BenchmarkHarness.hpp"
+#include "../VLVector.hpp"
+#include "../VLPoolAllocator.hpp"
+
+#if defined(__has_include)
+#if __has_include(<boost/container/small_vector.hpp>)
+// When the source of a move uses its inline buffer, boost::container::small_vector copies it with
+// a memmove whose length GCC cannot bound by the buffer size, and reports an overread for every
+// move of a small_vector. The length is the size of the source, which always fits the buffer:
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wstringop-overread"
+#include <boost/container/small_vector.hpp>
+#pragma GCC diagnostic pop
+#else
+#include <boost/container/small_vector.hpp>
+#endif
+#define BENCH_HAS_BOOST_SMALL_VECTOR
+#endif
+#endif
+
+#define DEF_MIN_TIME_MS 5.0
+#define OPS_PER_RUN 16
+
+std::size_t gAllocations = 0;
+std::size_t gBytesCopied = 0;
+
+/********************************************************************
+*                        Allocation counting                        *
+********************************************************************/
+
+// Every replaceable form of operator new and operator delete is routed through the two
+// functions below, so all storage comes from the malloc family and is released by free.
+// They are kept out of line: once GCC inlines free() into a caller that got its pointer from
+// operator new, it reports the pair as mismatched, even though both sides are replaced here.
+
+/**
+ * @brief Allocates storage for operator new and counts the allocation.
+ * @param size the amount of bytes to allocate.
+ * @param alignment the alignment of the storage.
+ * @return the storage, or nullptr if the allocation failed.
+ */
+__attribute__((noinline)) void *countedAllocate(std::size_t size, std::size_t alignment) noexcept
+{
+    ++gAllocations;
+    if (size == 0)
+    {
+        size = 1;
+    }
+    if (alignment <= alignof(std::max_align_t))
+    {
+        return std::malloc(size);
+    }
+    // aligned_alloc requires the size to be a multiple of the alignment:
+    return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+/**
+ * @brief Releases storage that was allocated by countedAllocate.
+ * @param storage the storage to release.
+ */
+__attribute__((noinline)) void countedRelease(void *storage) noexcept
+{
+    std::free(storage);
+}
+
+/**
+ * @brief Allocates storage for a throwing operator new.
+ */
+void *countedAllocateOrThrow(std::size_t size, std::size_t alignment)
+{
+    void *storage = countedAllocate(size, alignment);
+    if (storage == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return storage;
+}
+
+void *operator new(std::size_t size)
+{
+    return countedAllocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void *operator new[](std::size_t size)
+{
+    return countedAllocateOrThrow(size, alignof(std::max_align_t));
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size, alignof(std::max_align_t));
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    return countedAllocateOrThrow(size, (std::size_t) alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return countedAllocateOrThrow(size, (std::size_t) alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size, (std::size_t) alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return countedAllocate(size, (std::size_t) alignment);
+}
+
+void operator delete(void *storage) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete[](void *storage) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete(void *storage, std::size_t) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete[](void *storage, std::size_t) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete(void *storage, const std::nothrow_t &) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete[](void *storage, const std::nothrow_t &) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete(void *storage, std::align_val_t) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete[](void *storage, std::align_val_t) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete(void *storage, std::size_t, std::align_val_t) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete[](void *storage, std::size_t, std::align_val_t) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete(void *storage, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    countedRelease(storage);
+}
+
+void operator delete[](void *storage, std::align_val_t, const std::nothrow_t &) noexcept
+{
+    countedRelease(storage);
+}
+
+/********************************************************************
+*                           Element types                           *
+********************************************************************/
+
+/**
+ * @brief A 64 byte trivially copyable element.
+ */
+struct Pod64
+{
+    int values[16];
+
+    bool operator==(const Pod64 &other) const
+    {
+        return std::memcmp(values, other.values, sizeof(values)) == 0;
+    }
+
+    bool operator!=(const Pod64 &other) const
+    {
+        return !operator==(other);
+    }
+};
+
+/**
+ * @brief Wraps an element and counts the bytes of every copy and move of it into gBytesCopied.
+ */
+template<typename T>
+struct Tracked
+{
+    T value;
+
+    Tracked() : value()
+    {
+    }
+
+    explicit Tracked(const T &val) : value(val)
+    {
+    }
+
+    Tracked(const Tracked &other) : value(other.value)
+    {
+        gBytesCopied += sizeof(T);
+    }
+
+    Tracked(Tracked &&other) noexcept : value(std::move(other.value))
+    {
+        gBytesCopied += sizeof(T);
+    }
+
+    Tracked &operator=(const Tracked &other)
+    {
+        value = other.value;
+        gBytesCopied += sizeof(T);
+        return *this;
+    }
+
+    Tracked &operator=(Tracked &&other) noexcept
+    {
+        value = std::move(other.value);
+        gBytesCopied += sizeof(T);
+        return *this;
+    }
+
+    bool operator==(const Tracked &other) const
+    {
+        return value == other.value;
+    }
+
+    bool operator!=(const Tracked &other) const
+    {
+        return value != other.value;
+    }
+};
+
+/**
+ * @brief Creates element values and names element types.
+ */
+template<typename T>
+struct ElementTraits;
+
+template<>
+struct ElementTraits<int>
+{
+    static const char *name()
+    {
+        return "int";
+    }
+
+    static int make(std::size_t i)
+    {
+        return (int) i;
+    }
+
+    static std::size_t weight(int value)
+    {
+        return value;
+    }
+};
+
+template<>
+struct ElementTraits<Pod64>
+{
+    static const char *name()
+    {
+        return "pod64";
+    }
+
+    static Pod64 make(std::size_t i)
+    {
+        Pod64 pod;
+        for (int j = 0; j < 16; ++j)
+        {
+            pod.values[j] = (int) (i + j);
+        }
+        return pod;
+    }
+
+    static std::size_t weight(const Pod64 &value)
+    {
+        return value.values[0];
+    }
+};
+
+template<>
+struct ElementTraits<std::string>
+{
+    static const char *name()
+    {
+        return "string";
+    }
+
+    // Long enough to live on the heap, so copies allocate:
+    static std::string make(std::size_t i)
+    {
+        return std::string(32, (char) ('a' + i % 26));
+    }
+
+    static std::size_t weight(const std::string &value)
+    {
+        return value.size();
+    }
+};
+
+template<typename T>
+struct ElementTraits<Tracked<T>>
+{
+    static Tracked<T> make(std::size_t i)
+    {
+        return Tracked<T>(ElementTraits<T>::make(i));
+    }
+
+    static std::size_t weight(const Tracked<T> &value)
+    {
+        return ElementTraits<T>::weight(value.value);
+    }
+};
+
+/********************************************************************
+*                          Container types                          *
+********************************************************************/
+
+template<typename T, std::size_t StaticCapacity>
+struct VLVectorFamily
+{
+    typedef VLVector<T, StaticCapacity> type;
+
+    static const char *name()
+    {
+        return "VLVector";
+    }
+};
+
+template<typename T, std::size_t StaticCapacity>
+struct EagerVLVectorFamily
+{
+    // Returns to the stack as soon as the elements fit there, like the original VLVector:
+    typedef VLVector<T, StaticCapacity, VLGrowthPolicy<3, 2, 1, 1>> type;
+
+    static const char *name()
+    {
+        return "VLVector-eager";
+    }
+};
+
+template<typename T, std::size_t StaticCapacity>
+struct PooledVLVectorFamily
+{
+    // Recycles released heap buffers through the thread-local pool:
+    typedef VLPooledVector<T, StaticCapacity> type;
+
+    static const char *name()
+    {
+        return "VLVector-pooled";
+    }
+};
+
+template<typename T, std::size_t StaticCapacity>
+struct StdVectorFamily
+{
+    typedef std::vector<T> type;
+
+    static const char *name()
+    {
+        return "std::vector";
+    }
+};
+
+#ifdef BENCH_HAS_BOOST_SMALL_VECTOR
+template<typename T, std::size_t StaticCapacity>
+struct BoostSmallVectorFamily
+{
+    typedef boost::container::small_vector<T, StaticCapacity> type;
+
+    static const char *name()
+    {
+        return "boost::small_vector";
+    }
+};
+#endif
+
+/********************************************************************
+*                             Scenarios                             *
+********************************************************************/
+
+/**
+ * @brief Builds a vector holding a given amount of elements.
+ */
+template<typename Vec, typename T>
+Vec makeVector(std::size_t size)
+{
+    Vec vec;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        vec.push_back(ElementTraits<T>::make(i));
+    }
+    return vec;
+}
+
+template<typename Vec, typename T>
+struct PushBack
+{
+    struct State
+    {
+        Vec vec;
+        std::vector<T> values;
+    };
+
+    static const char *name()
+    {
+        return "push_back";
+    }
+
+    static State setup(std::size_t size)
+    {
+        State state;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            state.values.push_back(ElementTraits<T>::make(i));
+        }
+        return state;
+    }
+
+    static void run(State &state, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            state.vec.push_back(state.values[i]);
+        }
+        doNotOptimize(state.vec.data());
+    }
+
+    static std::size_t ops(std::size_t size)
+    {
+        return size;
+    }
+};
+
+/**
+ * @brief Where insert and erase scenarios operate.
+ */
+enum Position
+{
+    FRONT, MIDDLE, BACK
+};
+
+template<typename Vec>
+std::size_t positionIndex(const Vec &vec, Position position)
+{
+    return position == FRONT ? 0 : position == MIDDLE ? vec.size() / 2 : vec.size();
+}
+
+template<Position Where>
+struct PositionName;
+
+template<>
+struct PositionName<FRONT>
+{
+    static const char *insert()
+    {
+        return "insert_front";
+    }
+
+    static const char *erase()
+    {
+        return "erase_front";
+    }
+};
+
+template<>
+struct PositionName<MIDDLE>
+{
+    static const char *insert()
+    {
+        return "insert_middle";
+    }
+
+    static const char *erase()
+    {
+        return "erase_middle";
+    }
+};
+
+template<>
+struct PositionName<BACK>
+{
+    static const char *insert()
+    {
+        return "insert_back";
+    }
+
+    static const char *erase()
+    {
+        return "erase_back";
+    }
+};
+
+template<Position Where>
+struct Insert
+{
+    template<typename Vec, typename T>
+    struct Scenario
+    {
+        struct State
+        {
+            Vec vec;
+            T value;
+        };
+
+        static const char *name()
+        {
+            return PositionName<Where>::insert();
+        }
+
+        static State setup(std::size_t size)
+        {
+            return State{makeVector<Vec, T>(size), ElementTraits<T>::make(size)};
+        }
+
+        static void run(State &state, std::size_t)
+        {
+            for (int i = 0; i < OPS_PER_RUN; ++i)
+            {
+                state.vec.insert(state.vec.begin() + positionIndex(state.vec, Where), state.value);
+            }
+            doNotOptimize(state.vec.data());
+        }
+
+        static std::size_t ops(std::size_t)
+        {
+            return OPS_PER_RUN;
+        }
+    };
+};
+
+template<Position Where>
+struct Erase
+{
+    template<typename Vec, typename T>
+    struct Scenario
+    {
+        typedef Vec State;
+
+        static const char *name()
+        {
+            return PositionName<Where>::erase();
+        }
+
+        static State setup(std::size_t size)
+        {
+            return makeVector<Vec, T>(size + OPS_PER_RUN);
+        }
+
+        static void run(State &vec, std::size_t)
+        {
+            for (int i = 0; i < OPS_PER_RUN; ++i)
+            {
+                std::size_t index = positionIndex(vec, Where);
+                vec.erase(vec.begin() + (index == vec.size() ? index - 1 : index));
+            }
+            doNotOptimize(vec.data());
+        }
+
+        static std::size_t ops(std::size_t)
+        {
+            return OPS_PER_RUN;
+        }
+    };
+};
+
+template<typename Vec, typename T>
+struct Copy
+{
+    typedef Vec State;
+
+    static const char *name()
+    {
+        return "copy";
+    }
+
+    static State setup(std::size_t size)
+    {
+        return makeVector<Vec, T>(size);
+    }
+
+    static void run(State &vec, std::size_t)
+    {
+        for (int i = 0; i < OPS_PER_RUN; ++i)
+        {
+            Vec copy(vec);
+            doNotOptimize(copy.data());
+        }
+    }
+
+    static std::size_t ops(std::size_t)
+    {
+        return OPS_PER_RUN;
+    }
+};
+
+template<typename Vec, typename T>
+struct Move
+{
+    typedef Vec State;
+
+    static const char *name()
+    {
+        return "move";
+    }
+
+    static State setup(std::size_t size)
+    {
+        return makeVector<Vec, T>(size);
+    }
+
+    static void run(State &vec, std::size_t)
+    {
+        for (int i = 0; i < OPS_PER_RUN; ++i)
+        {
+            Vec moved(std::move(vec));
+            doNotOptimize(moved.data());
+            vec = std::move(moved);
+        }
+    }
+
+    static std::size_t ops(std::size_t)
+    {
+        return 2 * OPS_PER_RUN;
+    }
+};
+
+template<typename Vec, typename T>
+struct Swap
+{
+    typedef std::pair<Vec, Vec> State;
+
+    static const char *name()
+    {
+        return "swap";
+    }
+
+    static State setup(std::size_t size)
+    {
+        return State(makeVector<Vec, T>(size), makeVector<Vec, T>(size));
+    }
+
+    static void run(State &state, std::size_t)
+    {
+        using std::swap;
+        for (int i = 0; i < OPS_PER_RUN; ++i)
+        {
+            swap(state.first, state.second);
+            doNotOptimize(state.first.data());
+        }
+    }
+
+    static std::size_t ops(std::size_t)
+    {
+        return OPS_PER_RUN;
+    }
+};
+
+template<typename Vec, typename T>
+struct Iterate
+{
+    typedef Vec State;
+
+    static const char *name()
+    {
+        return "iterate";
+    }
+
+    static State setup(std::size_t size)
+    {
+        return makeVector<Vec, T>(size);
+    }
+
+    static void run(State &vec, std::size_t)
+    {
+        std::size_t sum = 0;
+        for (int i = 0; i < OPS_PER_RUN; ++i)
+        {
+            for (const T &value : vec)
+            {
+                sum += ElementTraits<T>::weight(value);
+            }
+            doNotOptimize(sum);
+        }
+    }
+
+    // Reported per element visited:
+    static std::size_t ops(std::size_t size)
+    {
+        return OPS_PER_RUN * (size == 0 ? 1 : size);
+    }
+};
+
+template<typename Vec, typename T>
+struct Compare
+{
+    typedef std::pair<Vec, Vec> State;
+
+    static const char *name()
+    {
+        return "compare";
+    }
+
+    static State setup(std::size_t size)
+    {
+        return State(makeVector<Vec, T>(size), makeVector<Vec, T>(size));
+    }
+
+    static void run(State &state, std::size_t)
+    {
+        for (int i = 0; i < OPS_PER_RUN; ++i)
+        {
+            bool equal = state.first == state.second;
+            doNotOptimize(equal);
+        }
+    }
+
+    static std::size_t ops(std::size_t)
+    {
+        return OPS_PER_RUN;
+    }
+};
+
+/********************************************************************
+*                               Driver                              *
+********************************************************************/
+
+/**
+ * @brief Command line options of the suite.
+ */
+struct Options
+{
+    const char *jsonPath;
+    double minTimeMs;
+    const char *filter;
+};
+
+/**
+ * @brief Runs a single scenario for a container family, element type and static capacity.
+ */
+template<template<typename, typename> class Scenario, template<typename, std::size_t> class Family,
+        typename T, std::size_t StaticCapacity>
+void runScenario(const BenchmarkRunner &runner, BenchmarkReporter &reporter,
+                 const Options &options, std::size_t size)
+{
+    typedef typename Family<T, StaticCapacity>::type Vec;
+    typedef typename Family<Tracked<T>, StaticCapacity>::type TrackedVec;
+
+    BenchmarkResult result;
+    result.container = Family<T, StaticCapacity>::name();
+    result.element = ElementTraits<T>::name();
+    result.operation = Scenario<Vec, T>::name();
+    std::string key = result.container + "/" + result.element + "/" + result.operation;
+    if (options.filter != nullptr && key.find(options.filter) == std::string::npos)
+    {
+        return;
+    }
+    result.staticCapacity = StaticCapacity;
+    result.size = size;
+    result.objectSize = sizeof(Vec);
+    runner.measure<Scenario<Vec, T>>(size, result.nsPerOp, result.allocationsPerOp);
+    result.bytesCopiedPerOp = runner.countBytesCopied<Scenario<TrackedVec, Tracked<T>>>(size);
+    reporter.add(result);
+}
+
+/**
+ * @brief Runs all scenarios for a container family, element type and static capacity, at sizes
+ * below, just above and far above the static capacity.
+ */
+template<template<typename, std::size_t> class Family, typename T, std::size_t StaticCapacity>
+void runFamily(const BenchmarkRunner &runner, BenchmarkReporter &reporter, const Options &options)
+{
+    const std::size_t sizes[] = {StaticCapacity / 2, StaticCapacity + 1, 32 * StaticCapacity};
+    for (std::size_t size : sizes)
+    {
+        runScenario<PushBack, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Insert<FRONT>::Scenario, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Insert<MIDDLE>::Scenario, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Insert<BACK>::Scenario, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Erase<FRONT>::Scenario, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Erase<MIDDLE>::Scenario, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Erase<BACK>::Scenario, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Copy, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Move, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Swap, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Iterate, Family, T, StaticCapacity>(runner, reporter, options, size);
+        runScenario<Compare, Family, T, StaticCapacity>(runner, reporter, options, size);
+    }
+}
+
+/**
+ * @brief Runs all container families for an element type and static capacity.
+ */
+template<typename T, std::size_t StaticCapacity>
+void runElement(const BenchmarkRunner &runner, BenchmarkReporter &reporter, const Options &options)
+{
+    runFamily<VLVectorFamily, T, StaticCapacity>(runner, reporter, options);
+    runFamily<EagerVLVectorFamily, T, StaticCapacity>(runner, reporter, options);
+    runFamily<PooledVLVectorFamily, T, StaticCapacity>(runner, reporter, options);
+    runFamily<StdVectorFamily, T, StaticCapacity>(runner, reporter, options);
+#ifdef BENCH_HAS_BOOST_SMALL_VECTOR
+    runFamily<BoostSmallVectorFamily, T, StaticCapacity>(runner, reporter, options);
+#endif
+}
+
+/**
+ * @brief Runs all element types for a static capacity.
+ */
+template<std::size_t StaticCapacity>
+void runCapacity(const BenchmarkRunner &runner, BenchmarkReporter &reporter, const Options &options)
+{
+    runElement<int, StaticCapacity>(runner, reporter, options);
+    runElement<Pod64, StaticCapacity>(runner, reporter, options);
+    runElement<std::string, StaticCapacity>(runner, reporter, options);
+}
+
+int main(int argc, char *argv[])
+{
+    Options options = {nullptr, DEF_MIN_TIME_MS, nullptr};
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--json") == 0)
+        {
+            options.jsonPath = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--min-time-ms") == 0)
+        {
+            options.minTimeMs = std::atof(argv[i + 1]);
+        }
+        else if (std::strcmp(argv[i], "--filter") == 0)
+        {
+            options.filter = argv[i + 1];
+        }
+        else
+        {
+            std::fprintf(stderr, "Usage: %s [--json FILE] [--min-time-ms MS] [--filter TEXT]\n",
+                         argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    BenchmarkRunner runner(options.minTimeMs);
+    BenchmarkReporter reporter;
+    reporter.printHeader();
+    runCapacity<4>(runner, reporter, options);
+    runCapacity<16>(runner, reporter, options);
+    runCapacity<64>(runner, reporter, options);
+
+    if (options.jsonPath != nullptr && !reporter.writeJson(options.jsonPath))
+    {
+        std::fprintf(stderr, "Could not write %s\n", options.jsonPath);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+//
+// Tests VLConcurrentVector: appends across segments from one and several threads, snapshots,
+// over-aligned values, and a segment allocation that fails while appending.
+//
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+#include "VLTest.hpp"
+#include "../VLConcurrentVector.hpp"
+
+// When set, aligned operator new fails, which is how the vector allocates segments of
+// over-aligned values:
+bool gFailAlignedNew = false;
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    if (gFailAlignedNew)
+    {
+        throw std::bad_alloc();
+    }
+    const std::size_t align = (std::size_t) alignment;
+    void *storage = std::aligned_alloc(align, (size + align - 1) / align * align);
+    if (storage == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return storage;
+}
+
+void operator delete(void *storage, std::align_val_t) noexcept
+{
+    std::free(storage);
+}
+
+void operator delete(void *storage, std::size_t, std::align_val_t) noexcept
+{
+    std::free(storage);
+}
+
+/**
+ * @brief A value aligned beyond what plain operator new guarantees.
+ */
+struct alignas(64) Wide
+{
+    int value;
+
+    explicit Wide(int val) : value(val)
+    {
+    }
+};
+
+void testSequential()
+{
+    VLConcurrentVector<int, 4> vec;
+    VL_CHECK(vec.snapshot().empty());
+    for (int i = 0; i < 1000; ++i)
+    {
+        VL_CHECK(vec.push_back(i) == i);
+    }
+    VL_CHECK(vec.size() == 1000);
+    VLConcurrentVector<int, 4>::Snapshot snapshot = vec.snapshot();
+    VL_CHECK(snapshot.size() == 1000);
+    int expected = 0;
+    for (int value : snapshot)
+    {
+        VL_CHECK(value == expected++);
+    }
+    VL_CHECK(snapshot.at(999) == 999);
+    VL_CHECK_THROWS(snapshot.at(1000), std::out_of_range);
+
+    // References stay valid while the vector grows:
+    const int &first = snapshot[0];
+    vec.emplace_back(1000);
+    VL_CHECK(first == 0 && vec.snapshot().size() == 1001);
+}
+
+void testThreads()
+{
+    const int threads = 4;
+    const int perThread = 20000;
+    VLConcurrentVector<long, 16> vec;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&vec, t]()
+        {
+            for (int i = 0; i < perThread; ++i)
+            {
+                vec.push_back((long) t * perThread + i);
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    VLConcurrentVector<long, 16>::Snapshot snapshot = vec.snapshot();
+    VL_CHECK(snapshot.size() == (std::size_t) threads * perThread);
+    std::vector<bool> seen(threads * perThread, false);
+    for (long value : snapshot)
+    {
+        VL_CHECK(value >= 0 && value < threads * perThread && !seen[value]);
+        seen[value] = true;
+    }
+}
+
+void testOverAligned()
+{
+    VLConcurrentVector<Wide, 4> vec;
+    bool aligned = true;
+    for (int i = 0; i < 200; ++i)
+    {
+        const Wide &wide = vec.emplace_back(i);
+        aligned = aligned && reinterpret_cast<std::uintptr_t>(&wide) % alignof(Wide) == 0;
+    }
+    VL_CHECK(aligned);
+    VL_CHECK(vec.snapshot().size() == 200);
+}
+
+void testFailedSegmentAllocation()
+{
+    VLConcurrentVector<Wide, 4> vec;
+    for (int i = 0; i < 4; ++i)
+    {
+        vec.emplace_back(i);
+    }
+    // The inline segment is full, so the next value needs a segment that cannot be allocated:
+    gFailAlignedNew = true;
+    VL_CHECK_THROWS(vec.emplace_back(4), std::bad_alloc);
+    gFailAlignedNew = false;
+    VL_CHECK(vec.size() == 4 && vec.snapshot().size() == 4);
+
+    for (int i = 4; i < 20; ++i)
+    {
+        vec.emplace_back(i);
+    }
+    VLConcurrentVector<Wide, 4>::Snapshot snapshot = vec.snapshot();
+    VL_CHECK(snapshot.size() == 20);
+    for (std::size_t i = 0; i < snapshot.size(); ++i)
+    {
+        VL_CHECK(snapshot[i].value == (int) i);
+    }
+}
+
+int main()
+{
+    testSequential();
+    testThreads();
+    testOverAligned();
+    testFailedSegmentAllocation();
+    return VL_TEST_RESULT();
+}
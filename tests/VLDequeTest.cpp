@@ -0,0 +1,338 @@
+//
+// Tests VLDeque: pushing and popping at both ends across the inline/heap boundary, a ring that
+// wraps around when it spills, iterators of either constness, copy and move with allocators
+// that do and don't propagate, and use as the container of std::queue and std::stack.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <queue>
+#include <stack>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "VLTest.hpp"
+#include "../VLDeque.hpp"
+
+typedef VLDeque<std::string, 4> Deque;
+
+/**
+ * @brief Returns the amount of bytes allocated by each allocator id and not released yet.
+ */
+inline std::map<int, long> &outstandingBytes()
+{
+    static std::map<int, long> bytes;
+    return bytes;
+}
+
+/**
+ * @brief A stateful allocator: allocators are equal iff their ids are equal, and every ring
+ * is charged to the id that allocated it, so releasing it through another allocator shows up
+ * in outstandingBytes().
+ * @tparam Propagate whether the allocator propagates on copy assignment, move assignment and swap.
+ */
+template<typename T, bool Propagate>
+struct TestAllocator
+{
+    typedef T value_type;
+    typedef std::integral_constant<bool, Propagate> propagate_on_container_copy_assignment;
+    typedef std::integral_constant<bool, Propagate> propagate_on_container_move_assignment;
+    typedef std::integral_constant<bool, Propagate> propagate_on_container_swap;
+    typedef std::false_type is_always_equal;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef TestAllocator<U, Propagate> other;
+    };
+
+    int id;
+
+    explicit TestAllocator(int allocatorId = 0) noexcept : id(allocatorId)
+    {
+    }
+
+    template<typename U>
+    TestAllocator(const TestAllocator<U, Propagate> &other) noexcept : id(other.id)
+    {
+    }
+
+    T *allocate(std::size_t count)
+    {
+        outstandingBytes()[id] += (long) (count * sizeof(T));
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T *ring, std::size_t count) noexcept
+    {
+        outstandingBytes()[id] -= (long) (count * sizeof(T));
+        std::allocator<T>().deallocate(ring, count);
+    }
+
+    bool operator==(const TestAllocator &other) const noexcept
+    {
+        return id == other.id;
+    }
+
+    bool operator!=(const TestAllocator &other) const noexcept
+    {
+        return id != other.id;
+    }
+};
+
+/**
+ * @brief Checks that every allocator released exactly the bytes it allocated.
+ */
+bool allocationsBalanced()
+{
+    for (const auto &bytes : outstandingBytes())
+    {
+        if (bytes.second != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Returns a deque of a given allocator that holds 0, 1, ..., size - 1.
+ */
+template<typename Alloc>
+VLDeque<int, 4, VLDefaultGrowthPolicy, Alloc> makeDeque(std::size_t size, int allocatorId)
+{
+    VLDeque<int, 4, VLDefaultGrowthPolicy, Alloc> deque{Alloc(allocatorId)};
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        deque.push_back((int) i);
+    }
+    return deque;
+}
+
+/**
+ * @brief Checks that a deque holds 0, 1, ..., size - 1.
+ */
+template<typename Deq>
+bool holds(const Deq &deque, std::size_t size)
+{
+    bool result = deque.size() == size;
+    for (std::size_t i = 0; result && i < size; ++i)
+    {
+        result = deque[i] == (int) i;
+    }
+    return result;
+}
+
+/**
+ * @brief Checks that a deque holds the same elements as a std::deque.
+ */
+bool equals(const Deque &deque, const std::deque<std::string> &expected)
+{
+    return deque.size() == expected.size() && std::equal(deque.begin(), deque.end(), expected.begin());
+}
+
+void testBothEnds()
+{
+    Deque deque;
+    std::deque<std::string> expected;
+    VL_CHECK(deque.empty() && deque.capacity() == 4);
+
+    // The front wraps around to the end of the inline ring before the deque spills:
+    deque.push_back("b");
+    deque.push_front("a");
+    deque.push_back("c");
+    deque.push_front("z");
+    expected = {"z", "a", "b", "c"};
+    VL_CHECK(deque.capacity() == 4 && equals(deque, expected));
+
+    for (int i = 0; i < 50; ++i)
+    {
+        deque.push_back(std::to_string(i));
+        expected.push_back(std::to_string(i));
+        deque.push_front(std::to_string(-i));
+        expected.push_front(std::to_string(-i));
+    }
+    VL_CHECK(deque.capacity() >= 104 && equals(deque, expected));
+    VL_CHECK(deque.front() == "-49" && deque.back() == "49");
+
+    const std::string &front = deque.front();
+    deque.push_back(front);
+    expected.push_back(expected.front());
+    VL_CHECK(equals(deque, expected));
+
+    while (deque.size() > 1)
+    {
+        deque.pop_front();
+        expected.pop_front();
+        if (deque.size() > 1)
+        {
+            deque.pop_back();
+            expected.pop_back();
+        }
+    }
+    VL_CHECK(deque.capacity() == 4 && equals(deque, expected));
+    deque.pop_back();
+    deque.pop_back();
+    VL_CHECK(deque.empty());
+
+    deque.emplace_back(3, 'x');
+    deque.emplace_front("w");
+    VL_CHECK(deque[0] == "w" && deque[1] == "xxx");
+    VL_CHECK(deque.at(1) == "xxx");
+    VL_CHECK_THROWS(deque.at(2), std::out_of_range);
+    deque.clear();
+    VL_CHECK(deque.empty());
+}
+
+void testCapacity()
+{
+    Deque deque{"a", "b", "c"};
+    deque.reserve(40);
+    VL_CHECK(deque.capacity() >= 40);
+    VL_CHECK(equals(deque, {"a", "b", "c"}));
+    deque.shrink_to_fit();
+    VL_CHECK(deque.capacity() == 4);
+    VL_CHECK(equals(deque, {"a", "b", "c"}));
+}
+
+void testIterators()
+{
+    VLDeque<int, 8> deque;
+    for (int i = 0; i < 8; ++i)
+    {
+        deque.push_front(i * 7 % 8);
+    }
+    std::sort(deque.begin(), deque.end());
+    bool sorted = true;
+    for (int i = 0; i < 8; ++i)
+    {
+        sorted = sorted && deque[i] == i;
+    }
+    VL_CHECK(sorted);
+
+    const VLDeque<int, 8> &constDeque = deque;
+    VL_CHECK(constDeque.end() - constDeque.begin() == 8);
+    VL_CHECK(*(deque.begin() + 3) == 3 && deque.begin()[5] == 5);
+    VL_CHECK(*deque.rbegin() == 7 && *(constDeque.rend() - 1) == 0);
+    VLDeque<int, 8>::const_iterator it = deque.begin();
+    VL_CHECK(it == deque.cbegin() && it < deque.cend());
+
+    // Iterators and const iterators compare and subtract in either order:
+    VL_CHECK(deque.begin() != deque.cend() && deque.cend() != deque.begin());
+    VL_CHECK(deque.end() - deque.cbegin() == 8 && deque.cbegin() - deque.end() == -8);
+    VL_CHECK(deque.begin() + 8 == deque.cend() && deque.cbegin() < deque.end());
+    VL_CHECK(deque.end() >= deque.cend() && deque.cbegin() <= deque.begin() && deque.end() > it);
+    VLDeque<int, 8> empty;
+    VL_CHECK(empty.begin() == empty.cend());
+    *deque.begin() = 10;
+    VL_CHECK(deque.front() == 10);
+}
+
+void testCopyAndMove()
+{
+    for (std::size_t size : {3, 30})
+    {
+        Deque deque;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            deque.push_front(std::to_string(i));
+        }
+        Deque copy(deque);
+        VL_CHECK(copy == deque);
+        copy.push_back("extra");
+        VL_CHECK(copy != deque);
+
+        Deque moved(std::move(copy));
+        VL_CHECK(moved.size() == size + 1 && moved.back() == "extra");
+        VL_CHECK(copy.empty());
+
+        Deque assigned{"x"};
+        assigned = deque;
+        VL_CHECK(assigned == deque);
+        assigned = std::move(moved);
+        VL_CHECK(assigned.size() == size + 1);
+
+        Deque other;
+        swap(other, assigned);
+        VL_CHECK(other.size() == size + 1 && assigned.empty());
+    }
+}
+
+void testAllocators()
+{
+    typedef TestAllocator<int, false> Fixed;
+    typedef TestAllocator<int, true> Propagating;
+    {
+        // Without propagation each deque keeps its allocator, and the elements move instead:
+        auto first = makeDeque<Fixed>(10, 1);
+        auto second = makeDeque<Fixed>(3, 2);
+        swap(first, second);
+        VL_CHECK(holds(first, 3) && holds(second, 10));
+        VL_CHECK(first.get_allocator().id == 1 && second.get_allocator().id == 2);
+        VL_CHECK(outstandingBytes()[2] > 0);
+
+        first = second;
+        VL_CHECK(holds(first, 10) && first.get_allocator().id == 1);
+        second = makeDeque<Fixed>(20, 3);
+        VL_CHECK(holds(second, 20) && second.get_allocator().id == 2);
+        VL_CHECK(outstandingBytes()[3] == 0);
+    }
+    VL_CHECK(allocationsBalanced());
+    {
+        // With propagation the allocator travels with the heap ring:
+        auto first = makeDeque<Propagating>(10, 4);
+        auto second = makeDeque<Propagating>(12, 5);
+        const int *ring = &first[0];
+        swap(first, second);
+        VL_CHECK(holds(first, 12) && holds(second, 10) && &second[0] == ring);
+        VL_CHECK(first.get_allocator().id == 5 && second.get_allocator().id == 4);
+
+        auto copy = makeDeque<Propagating>(2, 6);
+        copy = first;
+        VL_CHECK(holds(copy, 12) && copy.get_allocator().id == 5);
+        auto moved = makeDeque<Propagating>(30, 7);
+        ring = &second[0];
+        moved = std::move(second);
+        VL_CHECK(holds(moved, 10) && &moved[0] == ring && moved.get_allocator().id == 4);
+        VL_CHECK(outstandingBytes()[7] == 0);
+    }
+    VL_CHECK(allocationsBalanced());
+}
+
+void testAdaptors()
+{
+    std::queue<int, VLDeque<int, 4>> queue;
+    for (int i = 0; i < 10; ++i)
+    {
+        queue.push(i);
+    }
+    queue.emplace(10);
+    VL_CHECK(queue.size() == 11 && queue.front() == 0 && queue.back() == 10);
+    for (int i = 0; i < 6; ++i)
+    {
+        queue.pop();
+    }
+    VL_CHECK(queue.size() == 5 && queue.front() == 6);
+
+    std::stack<std::string, Deque> stack;
+    stack.push("a");
+    stack.push("b");
+    VL_CHECK(stack.top() == "b");
+    stack.pop();
+    VL_CHECK(stack.size() == 1 && stack.top() == "a");
+}
+
+int main()
+{
+    testBothEnds();
+    testCapacity();
+    testIterators();
+    testCopyAndMove();
+    testAllocators();
+    testAdaptors();
+    return VL_TEST_RESULT();
+}
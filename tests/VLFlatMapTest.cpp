@@ -0,0 +1,197 @@
+//
+// Tests VLFlatMap: entries across the inline/heap boundary, lookups, access through iterators
+// of either constness, and copy and move.
+//
+
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "VLTest.hpp"
+#include "../VLFlatMap.hpp"
+
+typedef VLFlatMap<int, std::string, 4> Map;
+
+/**
+ * @brief Orders pairs by their first member, and compares them with ints by it too.
+ */
+struct ByFirst
+{
+    typedef void is_transparent;
+
+    bool operator()(const std::pair<int, int> &lhs, const std::pair<int, int> &rhs) const
+    {
+        return lhs < rhs;
+    }
+
+    bool operator()(const std::pair<int, int> &lhs, int rhs) const
+    {
+        return lhs.first < rhs;
+    }
+
+    bool operator()(int lhs, const std::pair<int, int> &rhs) const
+    {
+        return lhs < rhs.first;
+    }
+};
+
+/**
+ * @brief Checks that a map maps 0, 2, ..., 2 * (size - 1) to their decimal strings.
+ */
+void checkEntries(const Map &map, std::size_t size)
+{
+    VL_CHECK(map.size() == size);
+    int expected = 0;
+    for (Map::const_iterator it = map.begin(); it != map.end(); ++it, expected += 2)
+    {
+        VL_CHECK(it->first == expected && it->second == std::to_string(expected));
+    }
+}
+
+/**
+ * @brief Inserts the entries checkEntries expects, in descending order.
+ */
+void fill(Map &map, std::size_t size)
+{
+    for (int key = 2 * ((int) size - 1); key >= 0; key -= 2)
+    {
+        map.insert(std::make_pair(key, std::to_string(key)));
+    }
+}
+
+void testInsertAndErase()
+{
+    Map map;
+    fill(map, 4);
+    VL_CHECK(map.capacity() == 4);
+    checkEntries(map, 4);
+    fill(map, 50);
+    VL_CHECK(map.capacity() >= 50);
+    checkEntries(map, 50);
+
+    VL_CHECK(!map.insert(std::make_pair(4, std::string("four"))).second);
+    VL_CHECK(map.at(4) == "4");
+    VL_CHECK(!map.insert_or_assign(4, "four").second);
+    VL_CHECK(map.at(4) == "four");
+    VL_CHECK(map.try_emplace(5, 3, 'x').second);
+    VL_CHECK(map[5] == "xxx");
+    map[7] = "seven";
+    VL_CHECK(map.size() == 52);
+
+    VL_CHECK(map.erase(5) == 1 && map.erase(5) == 0);
+    map.erase(map.find(7));
+    map.insert_or_assign(4, "4");
+    checkEntries(map, 50);
+
+    while (map.size() > 2)
+    {
+        map.erase(map.end() - 1);
+    }
+    checkEntries(map, 2);
+    map.clear();
+    VL_CHECK(map.empty());
+}
+
+void testLookups()
+{
+    Map map;
+    fill(map, 30);
+    const Map &constMap = map;
+    VL_CHECK(map.find(10)->second == "10");
+    VL_CHECK(constMap.find(11) == constMap.end());
+    VL_CHECK(map.contains(58) && !map.contains(60));
+    VL_CHECK(map.count(0) == 1 && map.count(-1) == 0);
+    VL_CHECK(map.lower_bound(11).key() == 12);
+    VL_CHECK(map.upper_bound(12).key() == 14);
+    VL_CHECK(map.lower_bound(100) == map.end());
+    VL_CHECK_THROWS(map.at(3), std::out_of_range);
+    VL_CHECK_THROWS(constMap.at(3), std::out_of_range);
+    VL_CHECK(map.keys().size() == 30 && map.values()[1] == "2");
+}
+
+void testHeterogeneousLookups()
+{
+    VLFlatMap<std::string, int, 4, std::less<>> names{{"b", 2}, {"d", 4}, {"f", 6}};
+    VL_CHECK(names.find("d")->second == 4);
+    VL_CHECK(names.lower_bound("c")->first == "d");
+    VL_CHECK(names.upper_bound("d")->first == "f");
+    VL_CHECK(names.equal_range("e").first == names.equal_range("e").second);
+    VL_CHECK(names.equal_range("b").second - names.equal_range("b").first == 1);
+    VL_CHECK(names.equal_range(std::string("f")).first->second == 6);
+
+    VLFlatMap<std::pair<int, int>, char, 4, ByFirst> pairs{{{1, 1}, 'a'}, {{2, 1}, 'b'},
+                                                           {{2, 2}, 'c'}, {{3, 1}, 'd'}};
+    const auto &constPairs = pairs;
+    auto twos = constPairs.equal_range(2);
+    VL_CHECK(twos.second - twos.first == 2);
+    VL_CHECK(twos.first->second == 'b' && (twos.second - 1)->second == 'c');
+    pairs.lower_bound(3)->second = 'e';
+    VL_CHECK(pairs.at(std::make_pair(3, 1)) == 'e');
+    VL_CHECK(pairs.upper_bound(3) == pairs.end());
+}
+
+void testIterators()
+{
+    Map map;
+    fill(map, 10);
+    Map::iterator it = map.begin();
+    VL_CHECK(it->first == 0);
+    it->second = "zero";
+    VL_CHECK(map.at(0) == "zero");
+    (*it).second += "!";
+    VL_CHECK(map.at(0) == "zero!");
+    it->second.clear();
+    VL_CHECK(map.at(0).empty());
+
+    Map::const_iterator constIt = it;
+    VL_CHECK(constIt == map.cbegin());
+    VL_CHECK(constIt[3].first == 6 && (constIt + 3)->second == "6");
+    VL_CHECK(map.end() - map.begin() == 10);
+
+    // Iterators and const iterators compare and subtract in either order:
+    VL_CHECK(map.find(3) == map.cend() && map.cend() == map.find(3));
+    VL_CHECK(map.find(4) != map.cend() && map.cbegin() < map.find(4));
+    VL_CHECK(map.find(4) - map.cbegin() == 2 && map.cbegin() - map.find(4) == -2);
+    VL_CHECK(map.end() >= map.cbegin() && map.cbegin() <= map.end() && map.cend() > it);
+    VL_CHECK((std::is_same<std::iterator_traits<Map::iterator>::iterator_category,
+                           std::input_iterator_tag>::value));
+
+    int sum = 0;
+    for (std::pair<const int &, std::string &> entry : map)
+    {
+        sum += entry.first;
+    }
+    VL_CHECK(sum == 90);
+}
+
+void testCopyAndMove()
+{
+    Map map;
+    fill(map, 20);
+    Map copy(map);
+    VL_CHECK(copy == map);
+    copy[1] = "1";
+    VL_CHECK(copy != map);
+
+    Map moved(std::move(copy));
+    VL_CHECK(moved.size() == 21 && moved.at(1) == "1");
+
+    Map assigned{{3, "3"}, {1, "1"}, {3, "three"}};
+    VL_CHECK(assigned.size() == 2 && assigned.at(3) == "3");
+    assigned = map;
+    checkEntries(assigned, 20);
+    assigned = std::move(moved);
+    VL_CHECK(assigned.size() == 21);
+}
+
+int main()
+{
+    testInsertAndErase();
+    testLookups();
+    testHeterogeneousLookups();
+    testIterators();
+    testCopyAndMove();
+    return VL_TEST_RESULT();
+}
@@ -0,0 +1,100 @@
+//
+// Tests VLFlatSet: keys across the inline/heap boundary, bulk insertion, lookups by key and by
+// a transparent ordering, and copy and move.
+//
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+#include "VLTest.hpp"
+#include "../VLFlatSet.hpp"
+
+typedef VLFlatSet<int, 4> Set;
+
+/**
+ * @brief Checks that a set holds 0, 3, ..., 3 * (size - 1).
+ */
+void checkKeys(const Set &set, std::size_t size)
+{
+    VL_CHECK(set.size() == size);
+    int expected = 0;
+    for (int key : set)
+    {
+        VL_CHECK(key == expected);
+        expected += 3;
+    }
+}
+
+void testInsertAndErase()
+{
+    Set set;
+    for (int key = 9; key >= 0; key -= 3)
+    {
+        VL_CHECK(set.insert(key).second);
+    }
+    VL_CHECK(set.capacity() == 4);
+    checkKeys(set, 4);
+    VL_CHECK(!set.insert(6).second && *set.insert(6).first == 6);
+
+    std::vector<int> more;
+    for (int key = 90; key >= 0; key -= 3)
+    {
+        more.push_back(key);
+        more.push_back(key);
+    }
+    set.insert(more.begin(), more.end());
+    VL_CHECK(set.capacity() >= 31);
+    checkKeys(set, 31);
+
+    VL_CHECK(set.erase(4) == 0 && set.erase(90) == 1);
+    set.erase(set.find(87));
+    checkKeys(set, 29);
+    set.clear();
+    VL_CHECK(set.empty());
+}
+
+void testLookups()
+{
+    Set set{12, 0, 6, 3, 9, 3};
+    checkKeys(set, 5);
+    VL_CHECK(set.data()[2] == 6);
+    VL_CHECK(set.find(9) == set.begin() + 3 && set.find(10) == set.end());
+    VL_CHECK(set.contains(12) && !set.contains(15));
+    VL_CHECK(set.count(0) == 1 && set.count(1) == 0);
+    VL_CHECK(*set.lower_bound(4) == 6 && *set.upper_bound(6) == 9);
+    VL_CHECK(set.equal_range(6).second - set.equal_range(6).first == 1);
+    VL_CHECK(set.equal_range(7).first == set.equal_range(7).second);
+
+    VLFlatSet<std::string, 4, std::less<>> names{"c", "a", "b"};
+    VL_CHECK(names.find("b") == names.begin() + 1);
+    VL_CHECK(names.contains("c") && names.count("d") == 0);
+    VL_CHECK(*names.lower_bound("aa") == "b" && names.upper_bound("c") == names.end());
+    VL_CHECK(names.equal_range("a").first == names.begin());
+}
+
+void testCopyAndMove()
+{
+    Set set{0, 3, 6, 9, 12, 15};
+    Set copy(set);
+    VL_CHECK(copy == set);
+    copy.insert(1);
+    VL_CHECK(copy != set);
+
+    Set moved(std::move(copy));
+    VL_CHECK(moved.size() == 7 && moved.contains(1));
+
+    Set assigned;
+    assigned = set;
+    checkKeys(assigned, 6);
+    assigned = std::move(moved);
+    VL_CHECK(assigned.size() == 7);
+}
+
+int main()
+{
+    testInsertAndErase();
+    testLookups();
+    testCopyAndMove();
+    return VL_TEST_RESULT();
+}
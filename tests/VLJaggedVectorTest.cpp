@@ -0,0 +1,127 @@
+//
+// Tests VLJaggedVector: rows growing past their slots, lookups in a row, copy and move, and
+// offsets that would overflow a small SizeType.
+//
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "VLTest.hpp"
+#include "../VLJaggedVector.hpp"
+
+typedef VLJaggedVector<int, 2> Rows;
+
+/**
+ * @brief Checks that a row holds given values.
+ */
+bool rowEquals(VLVectorView<int> row, std::initializer_list<int> values)
+{
+    return row.size() == values.size() && std::equal(values.begin(), values.end(), row.begin());
+}
+
+void testRows()
+{
+    Rows rows;
+    VL_CHECK(rows.empty());
+    rows.push_row({1, 2, 3});
+    rows.push_row();
+    rows.push_row({4});
+    VL_CHECK(rows.size() == 3);
+    VL_CHECK(rowEquals(rows[0], {1, 2, 3}));
+    VL_CHECK(rows[1].empty() && rows[1].capacity() == 2);
+    VL_CHECK(rowEquals(rows[2], {4}));
+
+    // The middle row grows past its slots, shifting the last row:
+    for (int i = 0; i < 10; ++i)
+    {
+        rows[1].push_back(i);
+    }
+    VL_CHECK(rowEquals(rows[0], {1, 2, 3}));
+    VL_CHECK(rowEquals(rows[1], {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    VL_CHECK(rowEquals(rows[2], {4}));
+    VL_CHECK(rows.offsets()[3] == rows.value_capacity());
+
+    rows[1].pop_back();
+    rows.pop_back(0);
+    VL_CHECK(rowEquals(rows[0], {1, 2}));
+    VL_CHECK(rows[1].size() == 9);
+    VL_CHECK_THROWS(rows.at(3), std::out_of_range);
+    VL_CHECK_THROWS(rows[2].at(1), std::out_of_range);
+
+    rows.pop_row();
+    VL_CHECK(rows.size() == 2);
+    rows.shrink_to_fit();
+    VL_CHECK(rows.value_capacity() == 11);
+    VL_CHECK(rowEquals(rows[0], {1, 2}));
+    VL_CHECK(rows[1].size() == 9 && rows[1][8] == 8);
+
+    rows.clear();
+    VL_CHECK(rows.empty() && rows.value_capacity() == 0);
+}
+
+void testLookups()
+{
+    Rows rows{{5, 7, 9, 7}, {}};
+    Rows::Row row = rows[0];
+    Rows::Row::iterator hit = row.find(7);
+    VL_CHECK(hit == row.begin() + 1);
+    *hit = 8;
+    VL_CHECK(rows[0][1] == 8);
+    VL_CHECK(row.find(6) == row.end());
+    VL_CHECK(row.contains(9) && !row.contains(6));
+    VL_CHECK(row.count(7) == 1);
+    VL_CHECK(!rows[1].contains(5));
+}
+
+void testCopyAndMove()
+{
+    std::vector<std::vector<int>> source{{1}, {2, 3}, {}, {4, 5, 6}};
+    Rows rows(source.begin(), source.end());
+    VL_CHECK(rows.size() == 4);
+
+    Rows copy(rows);
+    copy[0].push_back(10);
+    VL_CHECK(rowEquals(copy[0], {1, 10}));
+    VL_CHECK(rowEquals(rows[0], {1}));
+
+    Rows moved(std::move(copy));
+    VL_CHECK(rowEquals(moved[0], {1, 10}));
+    VL_CHECK(rowEquals(moved[3], {4, 5, 6}));
+
+    Rows assigned;
+    assigned = moved;
+    VL_CHECK(rowEquals(assigned[1], {2, 3}));
+    assigned = std::move(rows);
+    VL_CHECK(rowEquals(assigned[0], {1}));
+}
+
+void testSizeTypeOverflow()
+{
+    VLJaggedVector<int, 0, std::uint8_t> rows;
+    std::vector<int> values(200, 1);
+    rows.push_row(values.begin(), values.end());
+    VL_CHECK_THROWS(rows.push_row(values.begin(), values.end()), std::length_error);
+    VL_CHECK(rows.size() == 1 && rows.value_capacity() == 200);
+
+    rows.push_row(values.begin(), values.begin() + 55);
+    VL_CHECK(rows.offsets()[2] == 255);
+    VL_CHECK_THROWS(rows[1].push_back(1), std::length_error);
+    VL_CHECK(rows[1].size() == 55);
+
+    VLJaggedVector<int, 255, std::uint8_t> slack;
+    slack.push_row();
+    VL_CHECK_THROWS(slack.push_row(), std::length_error);
+    VL_CHECK(slack.size() == 1);
+}
+
+int main()
+{
+    testRows();
+    testLookups();
+    testCopyAndMove();
+    testSizeTypeOverflow();
+    return VL_TEST_RESULT();
+}
@@ -0,0 +1,203 @@
+//
+// Tests VLMmapAllocator with a threshold low enough to map small blocks: growth through
+// reallocate that keeps the elements, shrinking back below the threshold, and file-backed
+// mappings in a directory.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include "VLTest.hpp"
+#include "../VLMmapAllocator.hpp"
+
+#ifdef VLMMAP_SUPPORTED
+#include <dirent.h>
+#endif
+
+#define THRESHOLD (64 * 1024)
+
+typedef VLMappedVector<std::uint32_t, 16> Vec;
+
+/**
+ * @brief Appends values to a vector, so that it holds 0, 1, ..., size - 1.
+ */
+void fill(Vec &vec, std::size_t size)
+{
+    for (std::size_t i = vec.size(); i < size; ++i)
+    {
+        vec.push_back((std::uint32_t) i);
+    }
+}
+
+/**
+ * @brief Checks that a vector holds 0, 1, ..., size - 1.
+ */
+bool holds(const Vec &vec, std::size_t size)
+{
+    bool result = vec.size() == size;
+    for (std::size_t i = 0; result && i < size; ++i)
+    {
+        result = vec.data()[i] == (std::uint32_t) i;
+    }
+    return result;
+}
+
+/**
+ * @brief Checks if a block starts on a page, as mapped blocks do.
+ */
+bool pageAligned(const void *block)
+{
+#ifdef VLMMAP_SUPPORTED
+    return (std::uintptr_t) block % (std::uintptr_t) sysconf(_SC_PAGESIZE) == 0;
+#else
+    (void) block;
+    return true;
+#endif
+}
+
+/**
+ * @brief Returns the amount of open file descriptors of the process, or 0 if it is unknown.
+ */
+std::size_t openFiles()
+{
+    std::size_t count = 0;
+#ifdef VLMMAP_SUPPORTED
+    DIR *dir = opendir("/proc/self/fd");
+    if (dir == nullptr)
+    {
+        return 0;
+    }
+    while (readdir(dir) != nullptr)
+    {
+        ++count;
+    }
+    closedir(dir);
+#endif
+    return count;
+}
+
+void testReallocate()
+{
+    VLMmapAllocator<std::uint32_t> alloc{VLMmapOptions(THRESHOLD)};
+    const std::size_t small = THRESHOLD / sizeof(std::uint32_t) / 2;
+    const std::size_t mapped = THRESHOLD / sizeof(std::uint32_t);
+    VL_CHECK(!VLMmapRegion::isMapped(small * sizeof(std::uint32_t), alloc.options()));
+    VL_CHECK(alloc.reallocate(nullptr, small, mapped) == nullptr);
+
+    std::uint32_t *block = alloc.allocate(mapped);
+    VL_CHECK(pageAligned(block));
+    for (std::size_t i = 0; i < mapped; ++i)
+    {
+        block[i] = (std::uint32_t) i * 7;
+    }
+#ifdef VLMMAP_SUPPORTED
+    // Growing and shrinking while both sizes are mapped keeps the bytes:
+    std::uint32_t *grown = alloc.reallocate(block, mapped, 16 * mapped);
+    VL_CHECK(grown != nullptr && pageAligned(grown));
+    if (grown != nullptr)
+    {
+        block = grown;
+        block[16 * mapped - 1] = 1;
+    }
+    std::uint32_t *shrunk = alloc.reallocate(block, 16 * mapped, 2 * mapped);
+    VL_CHECK(shrunk != nullptr);
+    if (shrunk != nullptr)
+    {
+        block = shrunk;
+    }
+    bool kept = true;
+    for (std::size_t i = 0; i < mapped; ++i)
+    {
+        kept = kept && block[i] == (std::uint32_t) i * 7;
+    }
+    VL_CHECK(kept);
+    alloc.deallocate(block, shrunk != nullptr ? 2 * mapped : 16 * mapped);
+#else
+    alloc.deallocate(block, mapped);
+#endif
+    block = alloc.allocate(mapped);
+    // Shrinking below the threshold is left to the caller:
+    VL_CHECK(alloc.reallocate(block, mapped, small) == nullptr);
+    alloc.deallocate(block, mapped);
+}
+
+void testVectorGrowth()
+{
+    Vec vec{VLMmapAllocator<std::uint32_t>(VLMmapOptions(THRESHOLD))};
+    const std::size_t mapped = THRESHOLD / sizeof(std::uint32_t);
+
+    // The vector grows through the heap, into a mapping, then through mremap:
+    fill(vec, mapped / 4);
+    VL_CHECK(holds(vec, mapped / 4) && vec.capacity() < mapped);
+    fill(vec, 2 * mapped);
+    VL_CHECK(holds(vec, 2 * mapped) && pageAligned(vec.data()));
+    vec.reserve(40 * mapped);
+    VL_CHECK(holds(vec, 2 * mapped) && vec.capacity() == 40 * mapped && pageAligned(vec.data()));
+    fill(vec, 50 * mapped);
+    VL_CHECK(holds(vec, 50 * mapped));
+
+    // Shrinking within the mapped sizes, and back below the threshold to the global heap:
+    vec.resize(3 * mapped);
+    vec.shrink_to_fit();
+    VL_CHECK(holds(vec, 3 * mapped) && vec.capacity() == 3 * mapped);
+    vec.resize(100);
+    vec.shrink_to_fit();
+    VL_CHECK(holds(vec, 100) && vec.capacity() == 100);
+    fill(vec, mapped);
+    VL_CHECK(holds(vec, mapped));
+    vec.resize(8);
+    vec.shrink_to_fit();
+    VL_CHECK(holds(vec, 8) && vec.capacity() == 16);
+
+    // Copies and moves keep the allocator and its threshold:
+    fill(vec, 3 * mapped);
+    Vec copy(vec);
+    VL_CHECK(holds(copy, 3 * mapped) && copy.get_allocator() == vec.get_allocator());
+    Vec moved(std::move(copy));
+    VL_CHECK(holds(moved, 3 * mapped) && copy.empty());
+}
+
+void testFileBacked()
+{
+#ifdef VLMMAP_SUPPORTED
+    char directory[] = "/tmp/VLMmapAllocatorTest.XXXXXX";
+    VL_CHECK(mkdtemp(directory) != nullptr);
+    const std::size_t filesBefore = openFiles();
+    const std::size_t mapped = THRESHOLD / sizeof(std::uint32_t);
+    {
+        Vec vec{VLMmapAllocator<std::uint32_t>(VLMmapOptions(THRESHOLD, directory, false))};
+        fill(vec, 2 * mapped);
+        VL_CHECK(holds(vec, 2 * mapped) && pageAligned(vec.data()));
+        // The mapping keeps its backing file open, and the file was already unlinked:
+        VL_CHECK(openFiles() == filesBefore + 1);
+
+        fill(vec, 30 * mapped);
+        VL_CHECK(holds(vec, 30 * mapped) && openFiles() == filesBefore + 1);
+        vec.resize(2 * mapped);
+        vec.shrink_to_fit();
+        VL_CHECK(holds(vec, 2 * mapped));
+        vec.resize(10);
+        vec.shrink_to_fit();
+        VL_CHECK(holds(vec, 10) && openFiles() == filesBefore);
+    }
+    VL_CHECK(openFiles() == filesBefore);
+    // Every backing file was unlinked, so the directory can be removed:
+    VL_CHECK(rmdir(directory) == 0);
+
+    // A directory that does not exist makes the mapping fail:
+    Vec missing{VLMmapAllocator<std::uint32_t>(VLMmapOptions(THRESHOLD, "/nonexistent/VLVector"))};
+    VL_CHECK_THROWS(fill(missing, 2 * mapped), std::bad_alloc);
+    VL_CHECK(missing.size() < 2 * mapped && holds(missing, missing.size()));
+#endif
+}
+
+int main()
+{
+    testReallocate();
+    testVectorGrowth();
+    testFileBacked();
+    return VL_TEST_RESULT();
+}
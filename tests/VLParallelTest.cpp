@@ -0,0 +1,168 @@
+//
+// Tests VLParallel and VLTaskGroup: every algorithm runs with a threshold low enough to split
+// the vector into chunks and is checked against its sequential result.
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include "VLTest.hpp"
+#include "../VLParallel.hpp"
+#include "../VLVector.hpp"
+
+typedef VLVector<long, 16> Values;
+
+// More elements than one grain, so the vectors are split into several chunks:
+#define ELEMENTS (20 * VLPARALLEL_MIN_GRAIN + 123)
+
+/**
+ * @brief Returns a vector of pseudo random values.
+ */
+Values makeValues(std::size_t size)
+{
+    Values values;
+    unsigned long state = 12345;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        values.push_back((long) ((state >> 33) % 100000));
+    }
+    return values;
+}
+
+bool equal(const Values &first, const Values &second)
+{
+    return first.size() == second.size() && std::equal(first.data(), first.data() + first.size(),
+                                                        second.data());
+}
+
+void testForEachAndTransform(VLWorkStealingPool &pool)
+{
+    Values values = makeValues(ELEMENTS);
+    Values expected = values;
+    std::for_each(expected.data(), expected.data() + expected.size(), [](long &value)
+    {
+        value = value * 3 + 1;
+    });
+    VLParallel::for_each(values, [](long &value)
+    {
+        value = value * 3 + 1;
+    }, pool);
+    VL_CHECK(equal(values, expected));
+
+    Values out;
+    VLParallel::transform(values, out, [](long value)
+    {
+        return -value;
+    }, pool);
+    VL_CHECK(out.size() == values.size());
+    bool negated = true;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        negated = negated && out.data()[i] == -values.data()[i];
+    }
+    VL_CHECK(negated);
+}
+
+void testReduce(VLWorkStealingPool &pool)
+{
+    Values values = makeValues(ELEMENTS);
+    const long expected = std::accumulate(values.data(), values.data() + values.size(), 7L);
+    VL_CHECK(VLParallel::reduce(values, 7L, [](long first, long second)
+    {
+        return first + second;
+    }, pool) == expected);
+
+    Values empty;
+    VL_CHECK(VLParallel::reduce(empty, 7L, [](long first, long second)
+    {
+        return first + second;
+    }, pool) == 7);
+}
+
+void testSort(VLWorkStealingPool &pool)
+{
+    Values values = makeValues(ELEMENTS);
+    Values expected = values;
+    std::sort(expected.data(), expected.data() + expected.size());
+    VLParallel::sort(values, std::less<long>(), pool);
+    VL_CHECK(equal(values, expected));
+
+    VLParallel::sort(values, [](long first, long second)
+    {
+        return first > second;
+    }, pool);
+    std::reverse(expected.data(), expected.data() + expected.size());
+    VL_CHECK(equal(values, expected));
+}
+
+void testCompact(VLWorkStealingPool &pool)
+{
+    Values values = makeValues(ELEMENTS);
+    Values expected;
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        if (values.data()[i] % 3 != 0)
+        {
+            expected.push_back(values.data()[i]);
+        }
+    }
+    const std::size_t removed = VLParallel::compact(values, [](long value)
+    {
+        return value % 3 != 0;
+    }, pool);
+    VL_CHECK(removed == ELEMENTS - expected.size());
+    VL_CHECK(equal(values, expected));
+}
+
+void testTaskGroup(VLWorkStealingPool &pool)
+{
+    std::atomic<int> ran(0);
+    VLTaskGroup group(pool);
+    for (int i = 0; i < 100; ++i)
+    {
+        group.run([&ran]()
+                  {
+                      ran.fetch_add(1, std::memory_order_relaxed);
+                  });
+    }
+    group.wait();
+    VL_CHECK(ran.load() == 100);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        group.run([i]()
+                  {
+                      if (i == 5)
+                      {
+                          throw std::runtime_error("task failed");
+                      }
+                  });
+    }
+    VL_CHECK_THROWS(group.wait(), std::runtime_error);
+
+    // The error is cleared once it was rethrown:
+    group.run([]()
+              {
+              });
+    group.wait();
+}
+
+int main()
+{
+    const std::size_t threshold = VLParallel::threshold();
+    VLParallel::setThreshold(VLPARALLEL_MIN_GRAIN);
+    {
+        VLWorkStealingPool pool(4);
+        testForEachAndTransform(pool);
+        testReduce(pool);
+        testSort(pool);
+        testCompact(pool);
+        testTaskGroup(pool);
+    }
+    VLParallel::setThreshold(threshold);
+    return VL_TEST_RESULT();
+}
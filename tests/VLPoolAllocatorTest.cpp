@@ -0,0 +1,188 @@
+//
+// Tests VLPoolAllocator and VLThreadPool: the mapping of block sizes to size classes at the
+// class boundaries, reuse of freed blocks by pooled vectors, the counters, and blocks that are
+// released by another thread than the one that allocated them.
+//
+
+#include <cstddef>
+#include <cstring>
+#include <thread>
+#include "VLTest.hpp"
+#include "../VLPoolAllocator.hpp"
+
+/**
+ * @brief Checks if two block sizes share a size class: a block released with the first size
+ * is handed out again for the second, which may use all of it.
+ */
+bool sameClass(std::size_t first, std::size_t second)
+{
+    VLThreadPool &pool = VLThreadPool::instance();
+    pool.trim();
+    void *block = pool.allocate(first);
+    pool.deallocate(block, first);
+    pool.resetStats();
+    void *reused = pool.allocate(second);
+    const bool hit = pool.stats().hits == 1 && reused == block;
+    std::memset(reused, 0xAB, second);
+    pool.deallocate(reused, second);
+    pool.trim();
+    return hit;
+}
+
+void testSizeClasses()
+{
+    VL_CHECK(sameClass(1, VLPOOL_MIN_BYTES));
+    VL_CHECK(!sameClass(VLPOOL_MIN_BYTES, VLPOOL_MIN_BYTES + 1));
+    // Every power of 2 is split into four classes:
+    VL_CHECK(sameClass(17, 20) && !sameClass(20, 21));
+    VL_CHECK(sameClass(21, 24) && !sameClass(24, 25));
+    VL_CHECK(sameClass(29, 32) && !sameClass(32, 33));
+    VL_CHECK(sameClass(33, 40) && !sameClass(40, 41));
+    VL_CHECK(sameClass(1000, 1024) && !sameClass(1024, 1025));
+    VL_CHECK(sameClass(57345, VLPOOL_MAX_BYTES) && !sameClass(57344, 57345));
+
+    // Larger blocks bypass the pool:
+    VLThreadPool &pool = VLThreadPool::instance();
+    pool.resetStats();
+    void *large = pool.allocate(VLPOOL_MAX_BYTES + 1);
+    pool.deallocate(large, VLPOOL_MAX_BYTES + 1);
+    VL_CHECK(pool.stats().bypassed == 1 && pool.stats().recycled == 0);
+    VL_CHECK(pool.stats().hits == 0 && pool.stats().misses == 0);
+}
+
+void testReuse()
+{
+    VLThreadPool &pool = VLThreadPool::instance();
+    pool.trim();
+    pool.resetStats();
+    {
+        // A vector that oscillates around its static capacity allocates the same block each time:
+        VLPooledVector<int, 4> vec;
+        for (int round = 0; round < 10; ++round)
+        {
+            for (int i = 0; i < 6; ++i)
+            {
+                vec.push_back(i);
+            }
+            VL_CHECK(vec.capacity() > 4);
+            while (vec.size() > 1)
+            {
+                vec.pop_back();
+            }
+            VL_CHECK(vec.capacity() == 4);
+        }
+    }
+    VL_CHECK(pool.stats().misses == 1 && pool.stats().hits == 9);
+    VL_CHECK(pool.stats().recycled == 10);
+
+    // Short lived vectors of similar sizes share blocks too:
+    pool.resetStats();
+    for (int i = 0; i < 20; ++i)
+    {
+        VLPooledVector<double, 2> vec;
+        for (int j = 0; j < 50; ++j)
+        {
+            vec.push_back(j);
+        }
+        VL_CHECK(vec[49] == 49);
+    }
+    VL_CHECK(pool.stats().hits > 0 && pool.stats().hitRate() > 0.9);
+    pool.trim();
+}
+
+void testCounters()
+{
+    VLThreadPool &pool = VLThreadPool::instance();
+    pool.trim();
+    pool.resetStats();
+    VL_CHECK(pool.stats().hitRate() == 0.0);
+
+    void *blocks[VLPOOL_MAX_CACHED_BLOCKS + 1];
+    for (void *&block : blocks)
+    {
+        block = pool.allocate(64);
+    }
+    for (void *block : blocks)
+    {
+        pool.deallocate(block, 64);
+    }
+    // Only a full free list worth of blocks is kept, the rest go back to the global heap:
+    VL_CHECK(pool.stats().misses == VLPOOL_MAX_CACHED_BLOCKS + 1);
+    VL_CHECK(pool.stats().recycled == VLPOOL_MAX_CACHED_BLOCKS);
+    VL_CHECK(pool.stats().released == 1);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        blocks[i] = pool.allocate(64);
+    }
+    VL_CHECK(pool.stats().hits == 3);
+    VL_CHECK(pool.stats().hitRate() == 3.0 / (VLPOOL_MAX_CACHED_BLOCKS + 4));
+    for (int i = 0; i < 3; ++i)
+    {
+        pool.deallocate(blocks[i], 64);
+    }
+    pool.trim();
+    pool.resetStats();
+    VL_CHECK(pool.stats().hits == 0 && pool.stats().recycled == 0);
+}
+
+void testCrossThreadFree()
+{
+    VLThreadPool &pool = VLThreadPool::instance();
+    pool.trim();
+    const VLPoolStats before = VLThreadPool::processStats();
+
+    // A block allocated here and released by another thread joins the free list of that thread:
+    void *block = pool.allocate(100);
+    bool recycled = false;
+    bool reused = false;
+    void *fromThread = nullptr;
+    std::thread worker([&]()
+                       {
+                           VLThreadPool &workerPool = VLThreadPool::instance();
+                           workerPool.deallocate(block, 100);
+                           recycled = workerPool.stats().recycled == 1;
+                           reused = workerPool.allocate(100) == block &&
+                                    workerPool.stats().hits == 1;
+                           fromThread = workerPool.allocate(200);
+                       });
+    worker.join();
+    VL_CHECK(recycled && reused);
+
+    // The exited thread's counters were added to the process counters:
+    const VLPoolStats after = VLThreadPool::processStats();
+    VL_CHECK(after.recycled - before.recycled == 1);
+    VL_CHECK(after.hits - before.hits == 1);
+
+    // The blocks the exited thread still held are released here:
+    pool.resetStats();
+    pool.deallocate(fromThread, 200);
+    pool.deallocate(block, 100);
+    VL_CHECK(pool.stats().recycled == 2);
+    VL_CHECK(pool.allocate(200) == fromThread);
+    pool.deallocate(fromThread, 200);
+    pool.trim();
+
+    // Pooled vectors may be handed between threads as well:
+    VLPooledVector<int, 2> vec;
+    for (int i = 0; i < 40; ++i)
+    {
+        vec.push_back(i);
+    }
+    std::thread consumer([&vec]()
+                         {
+                             VLPooledVector<int, 2> taken(std::move(vec));
+                         });
+    consumer.join();
+    VL_CHECK(vec.empty());
+}
+
+int main()
+{
+    testSizeClasses();
+    testReuse();
+    testCounters();
+    testCrossThreadFree();
+    VLThreadPool::instance().trim();
+    return VL_TEST_RESULT();
+}
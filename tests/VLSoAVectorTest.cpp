@@ -0,0 +1,123 @@
+//
+// Tests VLSoAVector: rows across the inline/heap boundary, per-field spans, copy and move,
+// and row-wise iteration.
+//
+
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "VLTest.hpp"
+#include "../VLSoAVector.hpp"
+
+typedef VLBasicSoAVector<4, VLDefaultGrowthPolicy, int, double, std::string> Rows;
+
+/**
+ * @brief Checks that a vector holds the rows fill() appends.
+ */
+void checkRows(const Rows &rows, std::size_t size)
+{
+    VL_CHECK(rows.size() == size);
+    for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+        VL_CHECK(rows.field<0>()[i] == (int) i);
+        VL_CHECK(rows.field<1>()[i] == i * 0.5);
+        VL_CHECK(rows.field<2>()[i] == std::to_string(i));
+    }
+}
+
+void fill(Rows &rows, std::size_t size)
+{
+    for (std::size_t i = rows.size(); i < size; ++i)
+    {
+        rows.push_back((int) i, i * 0.5, std::to_string(i));
+    }
+}
+
+void testGrowth()
+{
+    Rows rows;
+    VL_CHECK(rows.empty() && rows.capacity() == 4);
+    fill(rows, 4);
+    VL_CHECK(rows.capacity() == 4);
+    checkRows(rows, 4);
+    fill(rows, 100);
+    VL_CHECK(rows.capacity() >= 100);
+    checkRows(rows, 100);
+
+    while (rows.size() > 1)
+    {
+        rows.pop_back();
+    }
+    VL_CHECK(rows.capacity() == 4);
+    checkRows(rows, 1);
+    rows.clear();
+    VL_CHECK(rows.empty());
+}
+
+void testSpansAndAccess()
+{
+    Rows rows;
+    fill(rows, 10);
+    VLFieldSpan<int> ids = rows.span<0>();
+    VL_CHECK(ids.size() == 10);
+    int sum = 0;
+    for (int id : ids)
+    {
+        sum += id;
+    }
+    VL_CHECK(sum == 45);
+
+    std::get<2>(rows[3]) = "three";
+    VL_CHECK(std::get<2>(rows.at(3)) == "three");
+    VL_CHECK_THROWS(rows.at(10), std::out_of_range);
+
+    std::size_t count = 0;
+    for (auto row : rows)
+    {
+        VL_CHECK(std::get<0>(row) == (int) count);
+        ++count;
+    }
+    VL_CHECK(count == 10 && rows.end() - rows.begin() == 10);
+    VL_CHECK(std::get<0>(*(rows.end() - 1)) == 9 && std::get<0>(rows.begin()[4]) == 4);
+    VL_CHECK((std::is_same<std::iterator_traits<Rows::iterator>::iterator_category,
+                           std::input_iterator_tag>::value));
+
+    rows.resize(12);
+    VL_CHECK(rows.size() == 12 && std::get<0>(rows[11]) == 0 && std::get<2>(rows[11]).empty());
+}
+
+void testCopyAndMove()
+{
+    for (std::size_t size : {3, 50})
+    {
+        Rows rows;
+        fill(rows, size);
+        Rows copy(rows);
+        checkRows(copy, size);
+        Rows moved(std::move(copy));
+        checkRows(moved, size);
+        VL_CHECK(copy.empty());
+
+        Rows assigned;
+        fill(assigned, 7);
+        assigned = rows;
+        checkRows(assigned, size);
+        assigned = std::move(moved);
+        checkRows(assigned, size);
+
+        Rows other;
+        swap(other, assigned);
+        checkRows(other, size);
+        VL_CHECK(assigned.empty());
+    }
+}
+
+int main()
+{
+    testGrowth();
+    testSpansAndAccess();
+    testCopyAndMove();
+    return VL_TEST_RESULT();
+}
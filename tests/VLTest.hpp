@@ -0,0 +1,56 @@
+//
+// A minimal checking harness for the container tests: VL_CHECK records a failure with its
+// location instead of aborting, so one run reports every failing check, and VL_TEST_RESULT
+// turns the failure count into the exit status that ctest expects.
+//
+
+#ifndef CPP_FINAL_PROJECT_VLTEST_HPP
+#define CPP_FINAL_PROJECT_VLTEST_HPP
+
+#include <cstdio>
+
+/**
+ * @brief Returns the amount of failed checks so far.
+ */
+inline int &vlTestFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+// Records a failure if a condition does not hold:
+#define VL_CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++vlTestFailures(); \
+        } \
+    } while (0)
+
+// Records a failure unless an expression throws a given exception type:
+#define VL_CHECK_THROWS(expression, exception) \
+    do \
+    { \
+        bool thrown = false; \
+        try \
+        { \
+            (void) (expression); \
+        } \
+        catch (const exception &) \
+        { \
+            thrown = true; \
+        } \
+        if (!thrown) \
+        { \
+            std::fprintf(stderr, "%s:%d: expected %s from: %s\n", __FILE__, __LINE__, #exception, \
+                         #expression); \
+            ++vlTestFailures(); \
+        } \
+    } while (0)
+
+// The exit status of a test program:
+#define VL_TEST_RESULT() (vlTestFailures() == 0 ? 0 : 1)
+
+#endif //CPP_FINAL_PROJECT_VLTEST_HPP
@@ -0,0 +1,126 @@
+//
+// Tests the size profiler: a vector that is moved between objects is recorded once, with the
+// peak and final sizes of the object that ends up holding its elements.
+//
+
+#define VLVECTOR_ENABLE_PROFILER
+
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "VLTest.hpp"
+#include "../VLVector.hpp"
+
+typedef VLVector<int, 4> Vec;
+
+/**
+ * @brief Returns the histogram of a tag, mapping "peak <size>" and "final <size>" to counts.
+ */
+std::map<std::string, std::size_t> histogram(const char *tag)
+{
+    std::map<std::string, std::size_t> bins;
+    std::FILE *file = std::tmpfile();
+    if (file == nullptr)
+    {
+        return bins;
+    }
+    VLSizeProfiler::instance().dump(file);
+    std::rewind(file);
+    char line[512];
+    while (std::fgets(line, sizeof(line), file) != nullptr)
+    {
+        char lineTag[256];
+        char kind[16];
+        std::size_t elementSize, staticCapacity, objectSize, size, count;
+        if (std::sscanf(line, "%255[^\t]\t%zu\t%zu\t%zu\t%15s\t%zu\t%zu", lineTag, &elementSize,
+                        &staticCapacity, &objectSize, kind, &size, &count) == 7 &&
+            std::strcmp(lineTag, tag) == 0)
+        {
+            bins[std::string(kind) + " " + std::to_string(size)] += count;
+        }
+    }
+    std::fclose(file);
+    return bins;
+}
+
+/**
+ * @brief Returns a tagged vector with a given amount of elements.
+ */
+Vec makeVector(const char *tag, int size)
+{
+    Vec vec;
+    vec.set_profile_tag(tag);
+    for (int i = 0; i < size; ++i)
+    {
+        vec.push_back(i);
+    }
+    return vec;
+}
+
+void testMoveConstruction()
+{
+    {
+        Vec a = makeVector("moved", 10);
+        Vec b(std::move(a));
+        Vec c(std::move(b));
+        VL_CHECK(c.size() == 10);
+    }
+    std::map<std::string, std::size_t> bins = histogram("moved");
+    VL_CHECK(bins.size() == 2);
+    VL_CHECK(bins["peak 10"] == 1);
+    VL_CHECK(bins["final 10"] == 1);
+}
+
+void testMoveWithAllocator()
+{
+    {
+        Vec a = makeVector("allocator", 3);
+        Vec b(std::move(a), std::allocator<int>());
+        b.pop_back();
+    }
+    std::map<std::string, std::size_t> bins = histogram("allocator");
+    VL_CHECK(bins.size() == 2);
+    VL_CHECK(bins["peak 3"] == 1);
+    VL_CHECK(bins["final 2"] == 1);
+}
+
+void testReallocatingContainer()
+{
+    {
+        std::vector<Vec> vectors;
+        for (int i = 0; i < 20; ++i)
+        {
+            vectors.push_back(makeVector("reallocated", 6));
+        }
+    }
+    std::map<std::string, std::size_t> bins = histogram("reallocated");
+    VL_CHECK(bins.size() == 2);
+    VL_CHECK(bins["peak 6"] == 20);
+    VL_CHECK(bins["final 6"] == 20);
+}
+
+void testCopyIsRecordedSeparately()
+{
+    {
+        Vec a = makeVector("copied", 5);
+        Vec b(a);
+        b.push_back(5);
+    }
+    std::map<std::string, std::size_t> bins = histogram("copied");
+    VL_CHECK(bins["peak 5"] == 1 && bins["final 5"] == 1);
+    VL_CHECK(bins["peak 6"] == 1 && bins["final 6"] == 1);
+}
+
+int main()
+{
+    VLSizeProfiler::instance().setSampleRate(1);
+    VLSizeProfiler::instance().reset();
+    testMoveConstruction();
+    testMoveWithAllocator();
+    testReallocatingContainer();
+    testCopyIsRecordedSeparately();
+    return VL_TEST_RESULT();
+}
@@ -0,0 +1,523 @@
+//
+// Tests VLVector itself: the size of the vector object, moves between the stack and the heap,
+// copy, move and swap with equal and unequal allocators, assignment that reuses the existing
+// storage, removal helpers, and growth up to the limit of a small SizeType.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include "VLTest.hpp"
+#include "../VLVector.hpp"
+
+/**
+ * @brief A value that counts how it is constructed, assigned and destroyed, so the tests can
+ * check which elements an operation touches and that none are leaked.
+ */
+struct Counted
+{
+    static int live;
+    static int copied;
+    static int moved;
+    static int assigned;
+
+    int value;
+
+    Counted(int val = 0) : value(val)
+    {
+        ++live;
+    }
+
+    Counted(const Counted &other) : value(other.value)
+    {
+        ++live;
+        ++copied;
+    }
+
+    Counted(Counted &&other) noexcept : value(other.value)
+    {
+        ++live;
+        ++moved;
+    }
+
+    Counted &operator=(const Counted &other)
+    {
+        value = other.value;
+        ++assigned;
+        return *this;
+    }
+
+    Counted &operator=(Counted &&other) noexcept
+    {
+        value = other.value;
+        ++assigned;
+        return *this;
+    }
+
+    ~Counted()
+    {
+        --live;
+    }
+
+    bool operator==(const Counted &other) const
+    {
+        return value == other.value;
+    }
+
+    /**
+     * @brief Resets the counters of copies, moves and assignments.
+     */
+    static void reset()
+    {
+        copied = 0;
+        moved = 0;
+        assigned = 0;
+    }
+};
+
+int Counted::live = 0;
+int Counted::copied = 0;
+int Counted::moved = 0;
+int Counted::assigned = 0;
+
+typedef VLVector<Counted, 8> Vec;
+
+/**
+ * @brief Returns the amount of bytes allocated by each allocator id and not released yet.
+ */
+inline std::map<int, long> &outstandingBytes()
+{
+    static std::map<int, long> bytes;
+    return bytes;
+}
+
+/**
+ * @brief A stateful allocator: allocators are equal iff their ids are equal, and every block
+ * is charged to the id that allocated it, so releasing it through another allocator shows up
+ * in outstandingBytes().
+ * @tparam Propagate whether the allocator propagates on copy assignment, move assignment and swap.
+ */
+template<typename T, bool Propagate>
+struct TestAllocator
+{
+    typedef T value_type;
+    typedef std::integral_constant<bool, Propagate> propagate_on_container_copy_assignment;
+    typedef std::integral_constant<bool, Propagate> propagate_on_container_move_assignment;
+    typedef std::integral_constant<bool, Propagate> propagate_on_container_swap;
+    typedef std::false_type is_always_equal;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef TestAllocator<U, Propagate> other;
+    };
+
+    int id;
+
+    explicit TestAllocator(int allocatorId = 0) noexcept : id(allocatorId)
+    {
+    }
+
+    template<typename U>
+    TestAllocator(const TestAllocator<U, Propagate> &other) noexcept : id(other.id)
+    {
+    }
+
+    T *allocate(std::size_t count)
+    {
+        outstandingBytes()[id] += (long) (count * sizeof(T));
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T *storage, std::size_t count) noexcept
+    {
+        outstandingBytes()[id] -= (long) (count * sizeof(T));
+        std::allocator<T>().deallocate(storage, count);
+    }
+
+    bool operator==(const TestAllocator &other) const noexcept
+    {
+        return id == other.id;
+    }
+
+    bool operator!=(const TestAllocator &other) const noexcept
+    {
+        return id != other.id;
+    }
+};
+
+/**
+ * @brief Checks that every allocator released exactly the bytes it allocated.
+ */
+bool allocationsBalanced()
+{
+    for (const auto &bytes : outstandingBytes())
+    {
+        if (bytes.second != 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Appends values to a vector, so that it holds 0, 1, ..., size - 1.
+ */
+template<typename Vector>
+void fill(Vector &vec, std::size_t size)
+{
+    for (std::size_t i = vec.size(); i < size; ++i)
+    {
+        vec.push_back((int) i);
+    }
+}
+
+/**
+ * @brief Checks that a vector holds 0, 1, ..., size - 1.
+ */
+template<typename Vector>
+bool holds(const Vector &vec, std::size_t size)
+{
+    if (vec.size() != size)
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (vec.data()[i].value != (int) i)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testObjectSize()
+{
+    // An empty allocator takes no space, and the inline elements share their bytes with the
+    // heap pointer, so a vector is its size, its capacity and its inline elements:
+    VL_CHECK(sizeof(VLVector<int, 16>) == 16 * sizeof(int) + 2 * sizeof(std::size_t));
+    VL_CHECK((sizeof(VLVector<int, 16, VLDefaultGrowthPolicy, std::allocator<int>, std::uint32_t>) ==
+              16 * sizeof(int) + 2 * sizeof(std::uint32_t)));
+    VL_CHECK(sizeof(VLVector<double, 4>) == 4 * sizeof(double) + 2 * sizeof(std::size_t));
+    // Fewer inline bytes than a pointer still leave room for the heap pointer:
+    VL_CHECK(sizeof(VLVector<char, 1>) == sizeof(char *) + 2 * sizeof(std::size_t));
+}
+
+void testStackAndHeap()
+{
+    {
+        Vec vec;
+        fill(vec, 8);
+        VL_CHECK(vec.capacity() == 8 && holds(vec, 8));
+
+        // Spilling relocates the inline elements by moving them:
+        Counted::reset();
+        fill(vec, 9);
+        VL_CHECK(vec.capacity() > 8 && holds(vec, 9));
+        VL_CHECK(Counted::moved >= 8 && Counted::copied == 0);
+        fill(vec, 40);
+        VL_CHECK(holds(vec, 40));
+
+        // The vector stays on the heap until its size drops to half the static capacity:
+        while (vec.size() > 5)
+        {
+            vec.pop_back();
+        }
+        VL_CHECK(vec.capacity() > 8 && holds(vec, 5));
+        vec.pop_back();
+        VL_CHECK(vec.capacity() == 8 && holds(vec, 4));
+
+        vec.reserve(100);
+        VL_CHECK(vec.capacity() >= 100 && holds(vec, 4));
+        vec.shrink_to_fit();
+        VL_CHECK(vec.capacity() == 8 && holds(vec, 4));
+
+        vec.resize(20);
+        VL_CHECK(vec.size() == 20 && vec.capacity() >= 20 && vec.data()[19].value == 0);
+        vec.erase(vec.begin() + 2, vec.end());
+        VL_CHECK(vec.capacity() == 8 && holds(vec, 2));
+        vec.clear();
+        VL_CHECK(vec.empty());
+    }
+    VL_CHECK(Counted::live == 0);
+
+    VLVector<std::string, 2> strings;
+    strings.emplace_back(3, 'a');
+    strings.emplace_back("b");
+    strings.emplace(strings.begin(), "c");
+    VL_CHECK(strings.size() == 3 && strings[0] == "c" && strings[1] == "aaa" && strings[2] == "b");
+    strings.erase(strings.begin());
+    VL_CHECK(strings.capacity() > 2 && strings[0] == "aaa");
+    strings.pop_back();
+    VL_CHECK(strings.capacity() == 2 && strings[0] == "aaa");
+}
+
+void testCopyAndMove()
+{
+    {
+        // Only the live elements are copied or moved, not the whole static capacity:
+        Vec stack;
+        fill(stack, 3);
+        Counted::reset();
+        Vec copy(stack);
+        VL_CHECK(holds(copy, 3) && Counted::copied == 3);
+        Counted::reset();
+        Vec moved(std::move(copy));
+        VL_CHECK(holds(moved, 3) && Counted::moved == 3 && copy.empty());
+
+        // Heap storage is taken as is:
+        Vec heap;
+        fill(heap, 20);
+        const Counted *storage = heap.data();
+        Counted::reset();
+        Vec taken(std::move(heap));
+        VL_CHECK(taken.data() == storage && holds(taken, 20));
+        VL_CHECK(Counted::moved == 0 && heap.empty() && heap.capacity() == 8);
+
+        // A heap vector whose elements fit inline is copied onto the stack:
+        taken.erase(taken.begin() + 5, taken.end());
+        Vec small(taken);
+        VL_CHECK(small.capacity() == 8 && holds(small, 5));
+    }
+    VL_CHECK(Counted::live == 0);
+}
+
+void testSwap()
+{
+    {
+        Vec first;
+        Vec second;
+        fill(first, 2);
+        fill(second, 20);
+        const Counted *storage = second.data();
+        swap(first, second);
+        VL_CHECK(holds(first, 20) && holds(second, 2) && first.data() == storage);
+
+        Vec third;
+        fill(third, 30);
+        storage = third.data();
+        Counted::reset();
+        swap(first, third);
+        VL_CHECK(holds(first, 30) && holds(third, 20) && first.data() == storage);
+        VL_CHECK(Counted::moved == 0 && Counted::copied == 0);
+
+        Vec fourth;
+        fill(fourth, 5);
+        Counted::reset();
+        swap(second, fourth);
+        VL_CHECK(holds(second, 5) && holds(fourth, 2));
+        VL_CHECK(Counted::copied == 0 && Counted::moved + Counted::assigned <= 3 * 5);
+    }
+    VL_CHECK(Counted::live == 0);
+}
+
+void testUnequalAllocators()
+{
+    typedef TestAllocator<Counted, false> Fixed;
+    typedef TestAllocator<Counted, true> Propagating;
+    {
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Fixed> first(Fixed(1));
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Fixed> second(Fixed(2));
+        fill(first, 10);
+        fill(second, 3);
+
+        // The heap storage of another allocator is not taken, the elements are moved instead:
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Fixed> moved(std::move(first), Fixed(3));
+        VL_CHECK(holds(moved, 10) && moved.get_allocator().id == 3);
+        VL_CHECK(outstandingBytes()[1] == 0 && outstandingBytes()[3] > 0);
+
+        // Without propagation each vector keeps its allocator, and the elements move instead:
+        swap(moved, second);
+        VL_CHECK(holds(moved, 3) && holds(second, 10));
+        VL_CHECK(moved.get_allocator().id == 3 && second.get_allocator().id == 2);
+        VL_CHECK(outstandingBytes()[2] > 0);
+    }
+    VL_CHECK(allocationsBalanced());
+    {
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Propagating> first(Propagating(4));
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Propagating> second(Propagating(5));
+        fill(first, 10);
+        fill(second, 12);
+        const Counted *storage = first.data();
+        swap(first, second);
+        VL_CHECK(holds(first, 12) && holds(second, 10) && second.data() == storage);
+        VL_CHECK(first.get_allocator().id == 5 && second.get_allocator().id == 4);
+    }
+    VL_CHECK(allocationsBalanced());
+    VL_CHECK(Counted::live == 0);
+}
+
+void testAssignment()
+{
+    {
+        Vec target;
+        fill(target, 15);
+        target.reserve(30);
+        const Counted *storage = target.data();
+
+        // A smaller vector is assigned over the live elements, and the rest are destroyed:
+        Vec smaller;
+        fill(smaller, 12);
+        Counted::reset();
+        target = smaller;
+        VL_CHECK(holds(target, 12) && target.data() == storage);
+        VL_CHECK(Counted::assigned == 12 && Counted::copied == 0);
+
+        // A larger vector that still fits is assigned over the live elements and copied after them:
+        Vec larger;
+        fill(larger, 25);
+        Counted::reset();
+        target = larger;
+        VL_CHECK(holds(target, 25) && target.data() == storage);
+        VL_CHECK(Counted::assigned == 12 && Counted::copied == 13);
+
+        // Self-assignment leaves the vector unchanged:
+        const Vec &self = target;
+        target = self;
+        VL_CHECK(holds(target, 25) && target.data() == storage);
+        Vec &alias = target;
+        target = std::move(alias);
+        VL_CHECK(holds(target, 25) && target.data() == storage);
+
+        target = {Counted(0), Counted(1)};
+        VL_CHECK(holds(target, 2));
+        target.assign_strong(larger);
+        VL_CHECK(holds(target, 25));
+        target = std::move(larger);
+        VL_CHECK(holds(target, 25) && larger.empty());
+    }
+    VL_CHECK(Counted::live == 0);
+}
+
+void testAssignmentAllocators()
+{
+    typedef TestAllocator<Counted, false> Fixed;
+    typedef TestAllocator<Counted, true> Propagating;
+    {
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Fixed> target(Fixed(6));
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Fixed> source(Fixed(7));
+        fill(target, 2);
+        fill(source, 9);
+        target = source;
+        VL_CHECK(holds(target, 9) && target.get_allocator().id == 6);
+        // The storage of an unequal allocator stays with it, the elements are moved instead:
+        target = std::move(source);
+        VL_CHECK(holds(target, 9) && target.get_allocator().id == 6 && source.empty());
+    }
+    VL_CHECK(allocationsBalanced());
+    {
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Propagating> target(Propagating(8));
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Propagating> source(Propagating(9));
+        fill(target, 6);
+        fill(source, 7);
+        target = source;
+        VL_CHECK(holds(target, 7) && target.get_allocator().id == 9);
+
+        VLVector<Counted, 4, VLDefaultGrowthPolicy, Propagating> other(Propagating(10));
+        fill(other, 11);
+        const Counted *storage = other.data();
+        target = std::move(other);
+        VL_CHECK(holds(target, 11) && target.data() == storage && target.get_allocator().id == 10);
+    }
+    VL_CHECK(allocationsBalanced());
+    VL_CHECK(Counted::live == 0);
+}
+
+void testRemoval()
+{
+    {
+        Vec vec;
+        fill(vec, 20);
+        VL_CHECK(erase_if(vec, [](const Counted &val)
+        {
+            return val.value % 2 == 1;
+        }) == 10);
+        VL_CHECK(vec.size() == 10);
+        bool even = true;
+        for (std::size_t i = 0; i < vec.size(); ++i)
+        {
+            even = even && vec[(int) i].value == 2 * (int) i;
+        }
+        VL_CHECK(even);
+
+        // Removing all but a few values returns the vector to the stack once, at the end:
+        VL_CHECK(erase_if(vec, [](const Counted &val)
+        {
+            return val.value > 4;
+        }) == 7);
+        VL_CHECK(vec.capacity() == 8 && vec.size() == 3 && vec[2].value == 4);
+        VL_CHECK(erase_if(vec, [](const Counted &)
+        {
+            return false;
+        }) == 0);
+    }
+    VL_CHECK(Counted::live == 0);
+
+    VLVector<int, 4> sorted{1, 1, 2, 3, 3, 3, 4, 5, 5};
+    VL_CHECK(remove_duplicates(sorted) == 4);
+    VL_CHECK((sorted == VLVector<int, 4>{1, 2, 3, 4, 5}));
+    VL_CHECK(remove_duplicates(sorted) == 0);
+
+    VLVector<int, 4> close{1, 2, 4, 5, 9};
+    VL_CHECK(remove_duplicates(close, [](int first, int second)
+    {
+        return second - first == 1;
+    }) == 2);
+    VL_CHECK((close == VLVector<int, 4>{1, 4, 9}));
+
+    // Unordered removal fills the gap with the last values:
+    VLVector<int, 4> values{0, 1, 2, 3, 4, 5, 6};
+    VL_CHECK(*values.swap_erase(values.cbegin() + 1) == 6);
+    VL_CHECK((values == VLVector<int, 4>{0, 6, 2, 3, 4, 5}));
+    values.erase_unordered(values.cbegin(), values.cbegin() + 2);
+    VL_CHECK((values == VLVector<int, 4>{4, 5, 2, 3}));
+    values.erase_unordered(values.cbegin() + 2, values.cend());
+    VL_CHECK((values == VLVector<int, 4>{4, 5}));
+}
+
+void testSmallSizeType()
+{
+    typedef VLVector<int, 4, VLDefaultGrowthPolicy, std::allocator<int>, std::uint8_t> Small;
+    Small vec;
+    VL_CHECK(vec.max_size() == 255);
+    for (int i = 0; i < 255; ++i)
+    {
+        vec.push_back(i);
+    }
+    VL_CHECK(vec.size() == 255 && vec.capacity() == 255);
+    VL_CHECK(vec.data()[254] == 254);
+    VL_CHECK_THROWS(vec.push_back(255), std::length_error);
+    VL_CHECK(vec.size() == 255);
+
+    Small inserted;
+    inserted.resize(200, 1);
+    inserted.insert(inserted.cbegin(), 55, 2);
+    VL_CHECK(inserted.size() == 255 && inserted.data()[0] == 2 && inserted.data()[254] == 1);
+    VL_CHECK_THROWS(inserted.insert(inserted.cbegin(), 1, 3), std::length_error);
+
+    Small resized;
+    resized.resize(250);
+    resized.resize(255);
+    VL_CHECK(resized.size() == 255);
+}
+
+int main()
+{
+    testObjectSize();
+    testStackAndHeap();
+    testCopyAndMove();
+    testSwap();
+    testUnequalAllocators();
+    testAssignment();
+    testAssignmentAllocators();
+    testRemoval();
+    testSmallSizeType();
+    return VL_TEST_RESULT();
+}
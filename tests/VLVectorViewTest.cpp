@@ -0,0 +1,115 @@
+//
+// Tests VLVectorView and VLVectorSerializer: views of inline and heap vectors, lookups and
+// comparisons, and round trips through streams and buffers, including malformed input and
+// headers that claim more elements than a stream holds.
+//
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "VLTest.hpp"
+#include "../VLVectorView.hpp"
+
+typedef VLVector<std::int32_t, 8> Vector;
+
+Vector makeVector(std::size_t size)
+{
+    Vector vec;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        vec.push_back((std::int32_t) (i * 3));
+    }
+    return vec;
+}
+
+void testView()
+{
+    for (std::size_t size : {0, 5, 100})
+    {
+        Vector vec = makeVector(size);
+        VLVectorView<std::int32_t> view(vec);
+        VL_CHECK(view.size() == size && view.data() == vec.data() && view.empty() == (size == 0));
+        VL_CHECK(view == VLVectorView<std::int32_t>(vec.data(), vec.size()));
+        if (size > 0)
+        {
+            VL_CHECK(view[size - 1] == (std::int32_t) ((size - 1) * 3));
+            VL_CHECK(view.contains(3) && view.count(3) == 1 && *view.find(3) == 3);
+        }
+        VL_CHECK(!view.contains(1) && view.find(1) == view.end());
+        VL_CHECK_THROWS(view.at(size), std::out_of_range);
+    }
+    Vector shorter = makeVector(3);
+    Vector longer = makeVector(4);
+    VL_CHECK(VLVectorView<std::int32_t>(shorter) < VLVectorView<std::int32_t>(longer));
+    VL_CHECK(VLVectorView<std::int32_t>(longer) != VLVectorView<std::int32_t>(shorter));
+}
+
+void testStreamRoundTrip()
+{
+    for (std::size_t size : {0, 5, 1000, 40000})
+    {
+        Vector vec = makeVector(size);
+        std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+        VLVectorSerializer::write(vec, stream);
+        VL_CHECK(stream.str().size() == VLVectorSerializer::serializedSize(vec));
+
+        Vector read = makeVector(7);
+        VLVectorSerializer::read(stream, read);
+        VL_CHECK(read == vec);
+    }
+
+    // A stream that ends in the middle of the elements leaves the vector empty:
+    std::stringstream full(std::ios::in | std::ios::out | std::ios::binary);
+    VLVectorSerializer::write(makeVector(50), full);
+    std::string bytes = full.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 4),
+                                std::ios::in | std::ios::binary);
+    Vector read = makeVector(3);
+    VL_CHECK_THROWS(VLVectorSerializer::read(truncated, read), std::runtime_error);
+    VL_CHECK(read.empty());
+
+    // A header that claims far more elements than the stream holds fails once the stream ends,
+    // without first allocating storage for all of them:
+    const VLSerialHeader huge = VLSerialHeader::of<std::int32_t>((std::size_t) 1 << 40);
+    std::string lying(reinterpret_cast<const char *>(&huge), sizeof(huge));
+    lying += bytes.substr(sizeof(huge));
+    std::stringstream lyingStream(lying, std::ios::in | std::ios::binary);
+    VL_CHECK_THROWS(VLVectorSerializer::read(lyingStream, read), std::runtime_error);
+    VL_CHECK(read.empty() && read.capacity() < 2 * VLSERIAL_READ_CHUNK_BYTES);
+
+    // Elements of another type are rejected:
+    std::stringstream other(bytes, std::ios::in | std::ios::binary);
+    VLVector<std::int64_t> wide;
+    VL_CHECK_THROWS(VLVectorSerializer::read(other, wide), std::invalid_argument);
+}
+
+void testBufferRoundTrip()
+{
+    Vector vec = makeVector(100);
+    std::vector<std::uint64_t> storage(VLVectorSerializer::serializedSize(vec) / 8 + 1);
+    const std::size_t bytes = VLVectorSerializer::write(vec, storage.data(), storage.size() * 8);
+    VL_CHECK(bytes == VLVectorSerializer::serializedSize(vec));
+
+    VLVectorView<std::int32_t> view = VLVectorView<std::int32_t>::fromSerialized(storage.data(), bytes);
+    VL_CHECK(view == VLVectorView<std::int32_t>(vec));
+
+    Vector read;
+    VLVectorSerializer::read(storage.data(), bytes, read);
+    VL_CHECK(read == vec);
+
+    VL_CHECK_THROWS(VLVectorSerializer::read(storage.data(), bytes - 1, read), std::length_error);
+    VL_CHECK_THROWS(VLVectorSerializer::write(vec, storage.data(), bytes - 1), std::length_error);
+    std::memset(storage.data(), 0, 4);
+    VL_CHECK_THROWS(VLVectorSerializer::read(storage.data(), bytes, read), std::invalid_argument);
+}
+
+int main()
+{
+    testView();
+    testStreamRoundTrip();
+    testBufferRoundTrip();
+    return VL_TEST_RESULT();
+}
@@ -0,0 +1,250 @@
+//
+// Reads a size profile written by VLSizeProfiler (VLVectorProfiler.hpp) and recommends a
+// StaticCapacity for every call-site tag.
+// A candidate capacity costs its bytes per object - the vector object plus the heap storage of
+// the vectors that spill - plus a fixed cost per spill for the allocation and the relocation of
+// the inline elements. Candidates are limited to the given percentile of the peak sizes, so a
+// long tail of large vectors does not inflate every object.
+//
+// Usage: VLCAPACITY_ADVISOR PROFILE [--percentile P] [--spill-cost BYTES] [--growth FACTOR]
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+
+#define DEF_PERCENTILE 0.95
+#define DEF_SPILL_COST 64.0
+#define DEF_GROWTH 1.5
+#define USAGE "Usage: VLCAPACITY_ADVISOR PROFILE [--percentile P] [--spill-cost BYTES] [--growth FACTOR]"
+
+/**
+ * @brief The vectors of a single tag and instantiation in the profile.
+ */
+struct Profile
+{
+    std::size_t elementSize = 0;
+    std::size_t staticCapacity = 0;
+    std::size_t objectSize = 0;
+    std::map<std::size_t, std::size_t> peak;
+    std::map<std::size_t, std::size_t> final;
+};
+
+/**
+ * @brief The parameters of the cost model.
+ */
+struct Options
+{
+    const char *path = nullptr;
+    double percentile = DEF_PERCENTILE;
+    double spillCost = DEF_SPILL_COST;
+    double growth = DEF_GROWTH;
+};
+
+/**
+ * @brief Reads the profile file, merging lines of the same tag and instantiation.
+ * @param path the path of the profile.
+ * @param profiles the profiles to fill, keyed by tag, element size, capacity and object size.
+ * @return true iff the file was read.
+ */
+bool readProfile(const char *path,
+                 std::map<std::tuple<std::string, std::size_t, std::size_t, std::size_t>, Profile> &profiles)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::size_t tab = line.find('\t');
+        if (tab == std::string::npos)
+        {
+            continue;
+        }
+        std::string tag = line.substr(0, tab);
+        std::istringstream fields(line.substr(tab + 1));
+        std::size_t elementSize, staticCapacity, objectSize, size, count;
+        std::string kind;
+        if (!(fields >> elementSize >> staticCapacity >> objectSize >> kind >> size >> count))
+        {
+            std::cerr << "Skipping malformed line: " << line << std::endl;
+            continue;
+        }
+        Profile &profile = profiles[std::make_tuple(tag, elementSize, staticCapacity, objectSize)];
+        profile.elementSize = elementSize;
+        profile.staticCapacity = staticCapacity;
+        profile.objectSize = objectSize;
+        (kind == "peak" ? profile.peak : profile.final)[size] += count;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the smallest size that at least a given fraction of the vectors do not exceed.
+ * @param histogram the amount of vectors of each size.
+ * @param total the amount of vectors.
+ * @param fraction the fraction of vectors.
+ * @return the percentile size.
+ */
+std::size_t percentileSize(const std::map<std::size_t, std::size_t> &histogram, std::size_t total,
+                           double fraction)
+{
+    std::size_t seen = 0;
+    for (const auto &bin : histogram)
+    {
+        seen += bin.second;
+        if (seen >= fraction * total)
+        {
+            return bin.first;
+        }
+    }
+    return histogram.empty() ? 0 : histogram.rbegin()->first;
+}
+
+/**
+ * @brief The expected cost of a static capacity, in bytes per vector.
+ */
+struct Cost
+{
+    double bytes;
+    double spillRate;
+    double total;
+};
+
+/**
+ * @brief Computes the expected cost of a static capacity for the vectors of a profile.
+ * @param profile the profile of the vectors.
+ * @param total the amount of vectors in the profile.
+ * @param capacity the static capacity to evaluate.
+ * @param options the parameters of the cost model.
+ * @return the expected cost per vector.
+ */
+Cost evaluate(const Profile &profile, std::size_t total, std::size_t capacity, const Options &options)
+{
+    // The inline storage shares its bytes with the heap pointer, so it takes at least a pointer:
+    const double element = (double) profile.elementSize;
+    const double pointer = (double) sizeof(void *);
+    const double header = (double) profile.objectSize -
+                          std::max(element * profile.staticCapacity, pointer);
+    Cost cost = {header + std::max(element * capacity, pointer), 0, 0};
+    double spillCost = 0;
+    for (const auto &bin : profile.peak)
+    {
+        if (bin.first <= capacity)
+        {
+            continue;
+        }
+        const double fraction = (double) bin.second / total;
+        cost.spillRate += fraction;
+        cost.bytes += fraction * options.growth * element * bin.first;
+        spillCost += fraction * (options.spillCost + element * capacity);
+    }
+    cost.total = cost.bytes + spillCost;
+    return cost;
+}
+
+/**
+ * @brief Prints the recommendation for the vectors of a tag.
+ * @param tag the tag of the vectors.
+ * @param profile the profile of the vectors.
+ * @param options the parameters of the cost model.
+ */
+void advise(const std::string &tag, const Profile &profile, const Options &options)
+{
+    std::size_t total = 0;
+    for (const auto &bin : profile.peak)
+    {
+        total += bin.second;
+    }
+    if (total == 0)
+    {
+        return;
+    }
+    const std::size_t limit = percentileSize(profile.peak, total, options.percentile);
+
+    // The cost only changes its slope at the observed sizes, so the best capacity is one of them:
+    std::size_t best = 1;
+    Cost bestCost = evaluate(profile, total, best, options);
+    for (const auto &bin : profile.peak)
+    {
+        if (bin.first <= 1 || bin.first > limit)
+        {
+            continue;
+        }
+        Cost cost = evaluate(profile, total, bin.first, options);
+        if (cost.total < bestCost.total)
+        {
+            best = bin.first;
+            bestCost = cost;
+        }
+    }
+    Cost current = evaluate(profile, total, profile.staticCapacity, options);
+
+    std::printf("%s (element %zu bytes, %zu vectors)\n", tag.c_str(), profile.elementSize, total);
+    std::printf("  peak size p50 %zu, p%.0f %zu, max %zu; final size p50 %zu\n",
+                percentileSize(profile.peak, total, 0.5), options.percentile * 100, limit,
+                profile.peak.rbegin()->first, percentileSize(profile.final, total, 0.5));
+    std::printf("  current     StaticCapacity %4zu: %8.1f bytes/vector, %5.1f%% spill, cost %8.1f\n",
+                profile.staticCapacity, current.bytes, current.spillRate * 100, current.total);
+    std::printf("  recommended StaticCapacity %4zu: %8.1f bytes/vector, %5.1f%% spill, cost %8.1f\n",
+                best, bestCost.bytes, bestCost.spillRate * 100, bestCost.total);
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--percentile") == 0 && i + 1 < argc)
+        {
+            options.percentile = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--spill-cost") == 0 && i + 1 < argc)
+        {
+            options.spillCost = std::atof(argv[++i]);
+        }
+        else if (std::strcmp(argv[i], "--growth") == 0 && i + 1 < argc)
+        {
+            options.growth = std::atof(argv[++i]);
+        }
+        else if (options.path == nullptr && argv[i][0] != '-')
+        {
+            options.path = argv[i];
+        }
+        else
+        {
+            std::cerr << USAGE << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    if (options.path == nullptr || options.percentile <= 0 || options.percentile > 1)
+    {
+        std::cerr << USAGE << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::map<std::tuple<std::string, std::size_t, std::size_t, std::size_t>, Profile> profiles;
+    if (!readProfile(options.path, profiles))
+    {
+        std::cerr << "Could not read " << options.path << std::endl;
+        return EXIT_FAILURE;
+    }
+    for (const auto &profile : profiles)
+    {
+        advise(std::get<0>(profile.first), profile.second, options);
+    }
+    return EXIT_SUCCESS;
+}